@@ -47,7 +47,9 @@ namespace mfem
 {
 namespace internal
 {
-long long flop_count;
+// Defined in general/tic_toc.cpp, so that the template classes can be used in
+// more than one translation unit.
+extern long long flop_count;
 }
 }
 
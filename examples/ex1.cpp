@@ -19,6 +19,9 @@
 //               ex1 -m ../data/fichera-amr.mesh
 //               ex1 -m ../data/mobius-strip.mesh
 //               ex1 -m ../data/mobius-strip.mesh -o -1 -sc
+//               ex1 -m ../data/fichera.mesh -o 3 -pa
+//               ex1 -m ../data/star.mesh -o 2 -mg
+//               ex1 -m ../data/fichera.mesh -o 3 -pa -mg
 //
 // Description:  This example code demonstrates the use of MFEM to define a
 //               simple finite element discretization of the Laplace problem
@@ -32,8 +35,9 @@
 //               element grid functions, as well as linear and bilinear forms
 //               corresponding to the left-hand side and right-hand side of the
 //               discrete linear system. We also cover the explicit elimination
-//               of essential boundary conditions, static condensation, and the
-//               optional connection to the GLVis tool for visualization.
+//               of essential boundary conditions, static condensation, partial
+//               assembly, geometric and p-multigrid, and the optional
+//               connection to the GLVis tool for visualization.
 
 #include "mfem.hpp"
 #include <fstream>
@@ -48,6 +52,8 @@ int main(int argc, char *argv[])
    const char *mesh_file = "../data/star.mesh";
    int order = 1;
    bool static_cond = false;
+   bool pa = false;
+   bool mg = false;
    bool visualization = 1;
 
    OptionsParser args(argc, argv);
@@ -58,6 +64,10 @@ int main(int argc, char *argv[])
                   " isoparametric space.");
    args.AddOption(&static_cond, "-sc", "--static-condensation", "-no-sc",
                   "--no-static-condensation", "Enable static condensation.");
+   args.AddOption(&pa, "-pa", "--partial-assembly", "-no-pa",
+                  "--no-partial-assembly", "Enable partial assembly.");
+   args.AddOption(&mg, "-mg", "--multigrid", "-no-mg", "--no-multigrid",
+                  "Use a geometric and p-multigrid preconditioner.");
    args.AddOption(&visualization, "-vis", "--visualization", "-no-vis",
                   "--no-visualization",
                   "Enable or disable GLVis visualization.");
@@ -67,6 +77,11 @@ int main(int argc, char *argv[])
       args.PrintUsage(cout);
       return 1;
    }
+   if (mg && static_cond)
+   {
+      cout << "Multigrid requires the full system, use -no-sc." << endl;
+      return 1;
+   }
    args.PrintOptions(cout);
 
    // 2. Read the mesh from the given mesh file. We can handle triangular,
@@ -78,11 +93,14 @@ int main(int argc, char *argv[])
    // 3. Refine the mesh to increase the resolution. In this example we do
    //    'ref_levels' of uniform refinement. We choose 'ref_levels' to be the
    //    largest number that gives a final mesh with no more than 50,000
-   //    elements.
+   //    elements. With multigrid, the last (up to two) refinements define
+   //    the levels of the multigrid hierarchy, see below.
+   int mg_h_levels = 0;
    {
       int ref_levels =
          (int)floor(log(50000./mesh->GetNE())/log(2.)/dim);
-      for (int l = 0; l < ref_levels; l++)
+      if (mg) { mg_h_levels = min(2, ref_levels); }
+      for (int l = 0; l < ref_levels - mg_h_levels; l++)
       {
          mesh->UniformRefinement();
       }
@@ -91,10 +109,15 @@ int main(int argc, char *argv[])
    // 4. Define a finite element space on the mesh. Here we use continuous
    //    Lagrange finite elements of the specified order. If order < 1, we
    //    instead use an isoparametric/isogeometric space.
+   if (mg && order < 1)
+   {
+      cout << "Multigrid requires a positive order." << endl;
+      return 3;
+   }
    FiniteElementCollection *fec;
    if (order > 0)
    {
-      fec = new H1_FECollection(order, dim);
+      fec = new H1_FECollection(mg ? 1 : order, dim);
    }
    else if (mesh->GetNodes())
    {
@@ -106,6 +129,26 @@ int main(int argc, char *argv[])
       fec = new H1_FECollection(order = 1, dim);
    }
    FiniteElementSpace *fespace = new FiniteElementSpace(mesh, fec);
+   //
+   //    With multigrid, the space is the finest level of a hierarchy which
+   //    starts with linear elements on the coarse mesh, refines the mesh
+   //    uniformly and then doubles the order up to the requested one.
+   FiniteElementSpaceHierarchy *hierarchy = NULL;
+   if (mg)
+   {
+      hierarchy = new FiniteElementSpaceHierarchy(mesh, fespace, true, true);
+      for (int l = 0; l < mg_h_levels; l++)
+      {
+         hierarchy->AddUniformlyRefinedLevel();
+      }
+      for (int p = 2; p/2 < order; p *= 2)
+      {
+         hierarchy->AddOrderRefinedLevel(
+            new H1_FECollection(min(p, order), dim));
+      }
+      fespace = &hierarchy->GetFinestFESpace();
+      mesh = &hierarchy->GetMeshAtLevel(hierarchy->GetFinestLevelIndex());
+   }
    cout << "Number of finite element unknowns: "
         << fespace->GetTrueVSize() << endl;
 
@@ -113,10 +156,10 @@ int main(int argc, char *argv[])
    //    In this example, the boundary conditions are defined by marking all
    //    the boundary attributes from the mesh as essential (Dirichlet) and
    //    converting them to a list of true dofs.
-   Array<int> ess_tdof_list;
+   Array<int> ess_tdof_list, ess_bdr;
    if (mesh->bdr_attributes.Size())
    {
-      Array<int> ess_bdr(mesh->bdr_attributes.Max());
+      ess_bdr.SetSize(mesh->bdr_attributes.Max());
       ess_bdr = 1;
       fespace->GetEssentialTrueDofs(ess_bdr, ess_tdof_list);
    }
@@ -144,28 +187,109 @@ int main(int argc, char *argv[])
    // 9. Assemble the bilinear form and the corresponding linear system,
    //    applying any necessary transformations such as: eliminating boundary
    //    conditions, applying conforming constraints for non-conforming AMR,
-   //    static condensation, etc.
+   //    static condensation, etc. With partial assembly, only the data at the
+   //    quadrature points is stored and the linear system is represented by
+   //    an Operator instead of a SparseMatrix.
    if (static_cond) { a->EnableStaticCondensation(); }
+   if (pa) { a->SetAssemblyLevel(AssemblyLevel::PARTIAL); }
    a->Assemble();
 
-   SparseMatrix A;
    Vector B, X;
-   a->FormLinearSystem(ess_tdof_list, x, *b, A, X, B);
+   if (mg)
+   {
+      Operator *A;
+      a->FormLinearSystem(ess_tdof_list, x, *b, A, X, B);
 
-   cout << "Size of linear system: " << A.Height() << endl;
+      cout << "Size of linear system: " << A->Height() << endl;
+
+      // 10. Define a multigrid V-cycle on the hierarchy of spaces and use it
+      //     to solve the system A X = B with PCG. Each level has its own
+      //     (partially) assembled form and a Chebyshev-Jacobi smoother, which
+      //     needs only the action and the diagonal of the operator. The
+      //     coarsest level is solved with Chebyshev-preconditioned CG. Rows of
+      //     assembled matrices with eliminated b.c. keep their diagonal, while
+      //     the constrained rows of partially assembled operators are the
+      //     identity.
+      Array<BilinearForm*> forms;
+      Array<Array<int>*> ess_lists; // referenced by the level operators
+      Solver *coarse_prec = NULL;
+      Multigrid M;
+      const int nlevels = hierarchy->GetNumLevels();
+      for (int l = 0; l < nlevels; l++)
+      {
+         FiniteElementSpace &fes_l = hierarchy->GetFESpaceAtLevel(l);
+         ess_lists.Append(new Array<int>);
+         Array<int> &ess_l = *ess_lists.Last(), no_ess;
+         if (ess_bdr.Size()) { fes_l.GetEssentialTrueDofs(ess_bdr, ess_l); }
+         BilinearForm *a_l = a;
+         Operator *A_l = A;
+         if (l < nlevels - 1)
+         {
+            a_l = new BilinearForm(&fes_l);
+            a_l->AddDomainIntegrator(new DiffusionIntegrator(one));
+            if (pa && l > 0)
+            {
+               a_l->SetAssemblyLevel(AssemblyLevel::PARTIAL);
+            }
+            a_l->Assemble();
+            a_l->FormSystemOperator(ess_l, A_l);
+            forms.Append(a_l);
+         }
+         Vector diag;
+         a_l->AssembleDiagonal(diag);
+         const bool full = (a_l->GetAssemblyLevel() == AssemblyLevel::FULL);
+         Solver *S = new OperatorChebyshevSmoother(*A_l, diag,
+                                                   full ? no_ess : ess_l, 2);
+         if (l == 0)
+         {
+            CGSolver *coarse = new CGSolver;
+            coarse->SetRelTol(1e-8);
+            coarse->SetMaxIter(500);
+            coarse->SetOperator(*A_l);
+            coarse->SetPreconditioner(*S);
+            coarse_prec = S;
+            S = coarse;
+         }
+         M.AddLevel(A_l, S, hierarchy->GetProlongationAtLevel(l),
+                    false, true, false);
+      }
+      PCG(*A, M, B, X, 1, 200, 1e-12, 0.0);
+
+      for (int l = 0; l < forms.Size(); l++) { delete forms[l]; }
+      for (int l = 0; l < ess_lists.Size(); l++) { delete ess_lists[l]; }
+      delete coarse_prec;
+   }
+   else if (pa)
+   {
+      Operator *A;
+      a->FormLinearSystem(ess_tdof_list, x, *b, A, X, B);
+
+      cout << "Size of linear system: " << A->Height() << endl;
+
+      // 10. Solve the system A X = B with unpreconditioned CG.
+      CG(*A, B, X, 1, 2000, 1e-12, 0.0);
+   }
+   else
+   {
+      SparseMatrix A;
+      a->FormLinearSystem(ess_tdof_list, x, *b, A, X, B);
+
+      cout << "Size of linear system: " << A.Height() << endl;
 
 #ifndef MFEM_USE_SUITESPARSE
-   // 10. Define a simple symmetric Gauss-Seidel preconditioner and use it to
-   //     solve the system A X = B with PCG.
-   GSSmoother M(A);
-   PCG(A, M, B, X, 1, 200, 1e-12, 0.0);
+      // 10. Define a simple symmetric Gauss-Seidel preconditioner and use it to
+      //     solve the system A X = B with PCG.
+      GSSmoother M(A);
+      PCG(A, M, B, X, 1, 200, 1e-12, 0.0);
 #else
-   // 10. If MFEM was compiled with SuiteSparse, use UMFPACK to solve the system.
-   UMFPackSolver umf_solver;
-   umf_solver.Control[UMFPACK_ORDERING] = UMFPACK_ORDERING_METIS;
-   umf_solver.SetOperator(A);
-   umf_solver.Mult(B, X);
+      // 10. If MFEM was compiled with SuiteSparse, use UMFPACK to solve the
+      //     system.
+      UMFPackSolver umf_solver;
+      umf_solver.Control[UMFPACK_ORDERING] = UMFPACK_ORDERING_METIS;
+      umf_solver.SetOperator(A);
+      umf_solver.Mult(B, X);
 #endif
+   }
 
    // 11. Recover the solution as a finite element grid function.
    a->RecoverFEMSolution(X, *b, x);
@@ -192,9 +316,10 @@ int main(int argc, char *argv[])
    // 14. Free the used memory.
    delete a;
    delete b;
-   delete fespace;
+   if (hierarchy) { delete hierarchy; }
+   else { delete fespace; }
    if (order > 0) { delete fec; }
-   delete mesh;
+   if (!hierarchy) { delete mesh; }
 
    return 0;
 }
@@ -9,6 +9,8 @@
 //    ex10 -m ../data/beam-tet.mesh -s 2 -r 1 -o 2 -dt 3
 //    ex10 -m ../data/beam-quad.mesh -s 14 -r 2 -o 2 -dt 0.03 -vs 20
 //    ex10 -m ../data/beam-hex.mesh -s 14 -r 1 -o 2 -dt 0.05 -vs 20
+//    ex10 -m ../data/beam-quad.mesh -s 4 -r 2 -o 2 -dt 3 -tol 1e-4
+//    ex10 -m ../data/beam-quad.mesh -s 15 -r 2 -o 2 -dt 0.03 -tol 1e-4 -vs 20
 //
 // Description:  This examples solves a time dependent nonlinear elasticity
 //               problem of the form dv/dt = H(x) + S v, dx/dt = v, where H is a
@@ -161,6 +163,7 @@ int main(int argc, char *argv[])
    int ode_solver_type = 3;
    double t_final = 300.0;
    double dt = 3.0;
+   double ode_tol = 1e-4;
    double visc = 1e-2;
    double mu = 0.25;
    double K = 5.0;
@@ -176,12 +179,16 @@ int main(int argc, char *argv[])
                   "Order (degree) of the finite elements.");
    args.AddOption(&ode_solver_type, "-s", "--ode-solver",
                   "ODE solver: 1 - Backward Euler, 2 - SDIRK2, 3 - SDIRK3,\n\t"
+                  "            4 - adaptive SDIRK4,\n\t"
                   "            11 - Forward Euler, 12 - RK2,\n\t"
-                  "            13 - RK3 SSP, 14 - RK4.");
+                  "            13 - RK3 SSP, 14 - RK4,\n\t"
+                  "            15 - adaptive Dormand-Prince 5(4).");
    args.AddOption(&t_final, "-tf", "--t-final",
                   "Final time; start time is 0.");
    args.AddOption(&dt, "-dt", "--time-step",
-                  "Time step.");
+                  "Time step (initial time step for adaptive solvers).");
+   args.AddOption(&ode_tol, "-tol", "--ode-tolerance",
+                  "Relative and absolute tolerance of adaptive solvers.");
    args.AddOption(&visc, "-v", "--viscosity",
                   "Viscosity coefficient.");
    args.AddOption(&mu, "-mu", "--shear-modulus",
@@ -208,7 +215,8 @@ int main(int argc, char *argv[])
 
    // 3. Define the ODE solver used for time integration. Several implicit
    //    singly diagonal implicit Runge-Kutta (SDIRK) methods, as well as
-   //    explicit Runge-Kutta methods are available.
+   //    explicit Runge-Kutta methods are available. The adaptive solvers
+   //    choose the time step based on an embedded error estimate.
    ODESolver *ode_solver;
    switch (ode_solver_type)
    {
@@ -216,11 +224,13 @@ int main(int argc, char *argv[])
       case 1: ode_solver = new BackwardEulerSolver; break;
       case 2: ode_solver = new SDIRK23Solver(2); break;
       case 3: ode_solver = new SDIRK33Solver; break;
+      case 4: ode_solver = new SDIRK54Solver; break;
       // Explicit methods
       case 11: ode_solver = new ForwardEulerSolver; break;
       case 12: ode_solver = new RK2Solver(0.5); break; // midpoint method
       case 13: ode_solver = new RK3SSPSolver; break;
       case 14: ode_solver = new RK4Solver; break;
+      case 15: ode_solver = new DormandPrince54Solver; break;
       // Implicit A-stable methods (not L-stable)
       case 22: ode_solver = new ImplicitMidpointSolver; break;
       case 23: ode_solver = new SDIRK23Solver; break;
@@ -229,6 +239,8 @@ int main(int argc, char *argv[])
          cout << "Unknown ODE solver type: " << ode_solver_type << '\n';
          return 3;
    }
+   AdaptiveODESolver *adaptive = dynamic_cast<AdaptiveODESolver*>(ode_solver);
+   if (adaptive) { adaptive->SetTolerances(ode_tol, ode_tol); }
 
    // 4. Refine the mesh to increase the resolution. In this example we do
    //    'ref_levels' of uniform refinement, where 'ref_levels' is a
@@ -316,6 +328,8 @@ int main(int argc, char *argv[])
       double dt_real = min(dt, t_final - t);
 
       ode_solver->Step(vx, t, dt_real);
+      // Adaptive solvers return the proposed size of the next time step.
+      if (adaptive) { dt = dt_real; }
 
       last_step = (t >= t_final - 1e-8*dt);
 
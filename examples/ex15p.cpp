@@ -7,6 +7,7 @@
 //               mpirun -np 4 ex15p -o 4 -y 0.1
 //               mpirun -np 4 ex15p -n 5
 //               mpirun -np 4 ex15p -p 1 -n 3
+//               mpirun -np 4 ex15p -rb
 //
 //               Other meshes:
 //
@@ -37,6 +38,9 @@
 //               derefinement step is performed.  After each refinement or
 //               derefinement step a rebalance operation is performed to keep
 //               the mesh evenly distributed among the available processors.
+//               With -rb, the solution is migrated element by element with a
+//               ParRebalancer and the partition balances the number of element
+//               DOFs instead of the number of elements.
 //
 //               The example demonstrates MFEM's capability to refine, derefine
 //               and load balance nonconforming meshes, in 2D and 3D, and on
@@ -64,10 +68,10 @@ double bdr_func(const Vector &pt, double t);
 double rhs_func(const Vector &pt, double t);
 
 // Update the finite element space, interpolate the solution and perform
-// parallel load balancing.
+// parallel load balancing, optionally with the given ParRebalancer.
 void UpdateAndRebalance(ParMesh &pmesh, ParFiniteElementSpace &fespace,
                         ParGridFunction &x, ParBilinearForm &a,
-                        ParLinearForm &b);
+                        ParLinearForm &b, ParRebalancer *rebalancer);
 
 
 int main(int argc, char *argv[])
@@ -90,6 +94,7 @@ int main(int argc, char *argv[])
    int nc_limit = 3;         // maximum level of hanging nodes
    bool visualization = true;
    bool visit = false;
+   bool use_rebalancer = false;
 
    OptionsParser args(argc, argv);
    args.AddOption(&mesh_file, "-m", "--mesh",
@@ -116,6 +121,10 @@ int main(int argc, char *argv[])
    args.AddOption(&visit, "-visit", "--visit-datafiles", "-no-visit",
                   "--no-visit-datafiles",
                   "Save data files for VisIt (visit.llnl.gov) visualization.");
+   args.AddOption(&use_rebalancer, "-rb", "--rebalancer", "-no-rb",
+                  "--no-rebalancer",
+                  "Migrate the solution with a ParRebalancer and balance the "
+                  "number of element DOFs.");
    args.Parse();
    if (!args.Good())
    {
@@ -185,6 +194,11 @@ int main(int argc, char *argv[])
    //    will be maintained over the AMR iterations.
    ParGridFunction x(&fespace);
 
+   // The ParRebalancer (used with -rb) migrates x directly with the elements
+   // during load balancing.
+   ParRebalancer rebalancer(pmesh);
+   rebalancer.Register(x);
+
    // 9. Connect to GLVis. Prepare for VisIt output.
    char vishost[] = "localhost";
    int  visport   = 19916;
@@ -328,7 +342,8 @@ int main(int argc, char *argv[])
          }
 
          // 22. Update the space, interpolate the solution, rebalance the mesh.
-         UpdateAndRebalance(pmesh, fespace, x, a, b);
+         UpdateAndRebalance(pmesh, fespace, x, a, b,
+                            use_rebalancer ? &rebalancer : NULL);
       }
 
       // 23. Use error estimates from the last inner iteration to check for
@@ -343,7 +358,8 @@ int main(int argc, char *argv[])
          }
 
          // 24. Update the space and the solution, rebalance the mesh.
-         UpdateAndRebalance(pmesh, fespace, x, a, b);
+         UpdateAndRebalance(pmesh, fespace, x, a, b,
+                            use_rebalancer ? &rebalancer : NULL);
       }
    }
 
@@ -355,7 +371,7 @@ int main(int argc, char *argv[])
 
 void UpdateAndRebalance(ParMesh &pmesh, ParFiniteElementSpace &fespace,
                         ParGridFunction &x, ParBilinearForm &a,
-                        ParLinearForm &b)
+                        ParLinearForm &b, ParRebalancer *rebalancer)
 {
    // Update the space: recalculate the number of DOFs and construct a matrix
    // that will adjust any GridFunctions to the new mesh state.
@@ -366,7 +382,19 @@ void UpdateAndRebalance(ParMesh &pmesh, ParFiniteElementSpace &fespace,
    // be updated here.
    x.Update();
 
-   if (pmesh.Nonconforming())
+   if (pmesh.Nonconforming() && rebalancer)
+   {
+      // Load balance the mesh so that each processor owns about the same
+      // number of DOFs, weighting each element by its number of DOFs. The
+      // rebalancer updates the space and migrates the solution.
+      Vector elem_weights(pmesh.GetNE());
+      for (int i = 0; i < pmesh.GetNE(); i++)
+      {
+         elem_weights(i) = fespace.GetFE(i)->GetDof();
+      }
+      rebalancer->Rebalance(&elem_weights);
+   }
+   else if (pmesh.Nonconforming())
    {
       // Load balance the mesh.
       pmesh.Rebalance();
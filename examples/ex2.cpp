@@ -9,6 +9,7 @@
 //               ex2 -m ../data/beam-quad.mesh -o 3 -sc
 //               ex2 -m ../data/beam-quad-nurbs.mesh
 //               ex2 -m ../data/beam-hex-nurbs.mesh
+//               ex2 -m ../data/beam-hex.mesh -o 2 -amg
 //
 // Description:  This example code solves a simple linear elasticity problem
 //               describing a multi-material cantilever beam.
@@ -31,7 +32,8 @@
 //               The example demonstrates the use of high-order and NURBS vector
 //               finite element spaces with the linear elasticity bilinear form,
 //               meshes with curved elements, and the definition of piece-wise
-//               constant and vector coefficient objects. Static condensation is
+//               constant and vector coefficient objects. Static condensation
+//               and smoothed aggregation AMG with the rigid body modes are
 //               also illustrated.
 //
 //               We recommend viewing Example 1 before viewing this example.
@@ -49,6 +51,7 @@ int main(int argc, char *argv[])
    const char *mesh_file = "../data/beam-tri.mesh";
    int order = 1;
    bool static_cond = false;
+   bool amg = false;
    bool visualization = 1;
 
    OptionsParser args(argc, argv);
@@ -58,6 +61,8 @@ int main(int argc, char *argv[])
                   "Finite element order (polynomial degree).");
    args.AddOption(&static_cond, "-sc", "--static-condensation", "-no-sc",
                   "--no-static-condensation", "Enable static condensation.");
+   args.AddOption(&amg, "-amg", "--amg", "-no-amg", "--no-amg",
+                  "Use smoothed aggregation AMG with the rigid body modes.");
    args.AddOption(&visualization, "-vis", "--visualization", "-no-vis",
                   "--no-visualization",
                   "Enable or disable GLVis visualization.");
@@ -67,6 +72,11 @@ int main(int argc, char *argv[])
       args.PrintUsage(cout);
       return 1;
    }
+   if (amg && static_cond)
+   {
+      cout << "AMG requires the full system, use -no-sc." << endl;
+      return 1;
+   }
    args.PrintOptions(cout);
 
    // 2. Read the mesh from the given mesh file. We can handle triangular,
@@ -192,18 +202,35 @@ int main(int argc, char *argv[])
 
    cout << "Size of linear system: " << A.Height() << endl;
 
+   if (amg)
+   {
+      // 11. Use PCG preconditioned by smoothed aggregation AMG, whose
+      //     near-nullspace is given by the rigid body modes of the space.
+      DenseMatrix modes;
+      RigidBodyModes(*fespace, modes);
+      SmoothedAggregationAMG M;
+      M.SetNearNullspace(modes, dim,
+                         fespace->GetOrdering() == Ordering::byVDIM);
+      M.SetPrintLevel(1);
+      M.SetOperator(A);
+      PCG(A, M, B, X, 1, 500, 1e-8, 0.0);
+   }
+   else
+   {
 #ifndef MFEM_USE_SUITESPARSE
-   // 11. Define a simple symmetric Gauss-Seidel preconditioner and use it to
-   //     solve the system Ax=b with PCG.
-   GSSmoother M(A);
-   PCG(A, M, B, X, 1, 500, 1e-8, 0.0);
+      // 11. Define a simple symmetric Gauss-Seidel preconditioner and use it
+      //     to solve the system Ax=b with PCG.
+      GSSmoother M(A);
+      PCG(A, M, B, X, 1, 500, 1e-8, 0.0);
 #else
-   // 11. If MFEM was compiled with SuiteSparse, use UMFPACK to solve the system.
-   UMFPackSolver umf_solver;
-   umf_solver.Control[UMFPACK_ORDERING] = UMFPACK_ORDERING_METIS;
-   umf_solver.SetOperator(A);
-   umf_solver.Mult(B, X);
+      // 11. If MFEM was compiled with SuiteSparse, use UMFPACK to solve the
+      //     system.
+      UMFPackSolver umf_solver;
+      umf_solver.Control[UMFPACK_ORDERING] = UMFPACK_ORDERING_METIS;
+      umf_solver.SetOperator(A);
+      umf_solver.Mult(B, X);
 #endif
+   }
 
    // 12. Recover the solution as a finite element grid function.
    a->RecoverFEMSolution(X, *b, x);
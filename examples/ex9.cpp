@@ -14,6 +14,9 @@
 //    ex9 -m ../data/disc-nurbs.mesh -p 2 -r 3 -dt 0.005 -tf 9
 //    ex9 -m ../data/periodic-square.mesh -p 3 -r 4 -dt 0.0025 -tf 9 -vs 20
 //    ex9 -m ../data/periodic-cube.mesh -p 0 -r 2 -o 2 -dt 0.02 -tf 8
+//    ex9 -m ../data/periodic-hexagon.mesh -p 0 -r 2 -dt 0.01 -tf 10 -pa
+//    ex9 -m ../data/periodic-square.mesh -p 1 -r 2 -dt 0.005 -tf 9 -pa -cm
+//    ex9 -m ../data/periodic-hexagon.mesh -p 0 -r 2 -dt 0.01 -tf 10 -s 5
 //
 // Description:  This example code solves the time-dependent advection equation
 //               du/dt + v.grad(u) = 0, where v is a given fluid velocity, and
@@ -25,7 +28,12 @@
 //               conditions through periodic meshes, as well as the use of GLVis
 //               for persistent visualization of a time-evolving solution. The
 //               saving of time-dependent data files for external visualization
-//               with VisIt (visit.llnl.gov) is also illustrated.
+//               with VisIt (visit.llnl.gov) is also illustrated. The inverse of
+//               the block diagonal DG mass matrix is applied element by
+//               element. Optionally, the advection operator can be applied
+//               matrix-free with partial assembly of the domain and face
+//               integrators, and the mass matrix can be made diagonal by
+//               collocation at the Gauss-Legendre nodes.
 
 #include "mfem.hpp"
 #include <fstream>
@@ -56,19 +64,18 @@ Vector bb_min, bb_max;
     form of du/dt = -v.grad(u) is M du/dt = K u + b, where M and K are the mass
     and advection matrices, and b describes the flow on the boundary. This can
     be written as a general ODE, du/dt = M^{-1} (K u + b), and this class is
-    used to evaluate the right-hand side. */
+    used to evaluate the right-hand side. The mass matrix is block diagonal,
+    so its inverse, M_inv, is applied element by element. */
 class FE_Evolution : public TimeDependentOperator
 {
 private:
-   SparseMatrix &M, &K;
+   Operator &M_inv, &K;
    const Vector &b;
-   DSmoother M_prec;
-   CGSolver M_solver;
 
    mutable Vector z;
 
 public:
-   FE_Evolution(SparseMatrix &_M, SparseMatrix &_K, const Vector &_b);
+   FE_Evolution(Operator &_M_inv, Operator &_K, const Vector &_b);
 
    virtual void Mult(const Vector &x, Vector &y) const;
 
@@ -86,6 +93,8 @@ int main(int argc, char *argv[])
    int ode_solver_type = 4;
    double t_final = 10.0;
    double dt = 0.01;
+   bool pa = false;
+   bool collocated_mass = false;
    bool visualization = true;
    bool visit = false;
    bool binary = false;
@@ -105,11 +114,18 @@ int main(int argc, char *argv[])
                   "Order (degree) of the finite elements.");
    args.AddOption(&ode_solver_type, "-s", "--ode-solver",
                   "ODE solver: 1 - Forward Euler,\n\t"
-                  "            2 - RK2 SSP, 3 - RK3 SSP, 4 - RK4, 6 - RK6.");
+                  "            2 - RK2 SSP, 3 - RK3 SSP, 4 - RK4, 6 - RK6,\n\t"
+                  "            5 - low-storage RK4 (LSRK54).");
    args.AddOption(&t_final, "-tf", "--t-final",
                   "Final time; start time is 0.");
    args.AddOption(&dt, "-dt", "--time-step",
                   "Time step.");
+   args.AddOption(&pa, "-pa", "--partial-assembly", "-no-pa",
+                  "--no-partial-assembly", "Enable Partial Assembly.");
+   args.AddOption(&collocated_mass, "-cm", "--collocated-mass", "-no-cm",
+                  "--no-collocated-mass",
+                  "Use a diagonal mass matrix by collocation (tensor-product"
+                  " elements).");
    args.AddOption(&visualization, "-vis", "--visualization", "-no-vis",
                   "--no-visualization",
                   "Enable or disable GLVis visualization.");
@@ -143,6 +159,7 @@ int main(int argc, char *argv[])
       case 2: ode_solver = new RK2Solver(1.0); break;
       case 3: ode_solver = new RK3SSPSolver; break;
       case 4: ode_solver = new RK4Solver; break;
+      case 5: ode_solver = new LSRK54Solver; break;
       case 6: ode_solver = new RK6Solver; break;
       default:
          cout << "Unknown ODE solver type: " << ode_solver_type << '\n';
@@ -172,13 +189,16 @@ int main(int argc, char *argv[])
 
    // 6. Set up and assemble the bilinear and linear forms corresponding to the
    //    DG discretization. The DGTraceIntegrator involves integrals over mesh
-   //    interior faces.
+   //    interior faces. With partial assembly, the advection operator K is
+   //    not assembled as a matrix; its action is computed on the fly from data
+   //    stored at the element and face quadrature points. The inverse of the
+   //    mass matrix is computed once, element by element.
    VectorFunctionCoefficient velocity(dim, velocity_function);
    FunctionCoefficient inflow(inflow_function);
    FunctionCoefficient u0(u0_function);
 
-   BilinearForm m(&fes);
-   m.AddDomainIntegrator(new MassIntegrator);
+   DGMassInverse m_inv(fes, NULL, collocated_mass ?
+                       DGMassInverse::COLLOCATED : DGMassInverse::BLOCK);
    BilinearForm k(&fes);
    k.AddDomainIntegrator(new ConvectionIntegrator(velocity, -1.0));
    k.AddInteriorFaceIntegrator(
@@ -190,11 +210,10 @@ int main(int argc, char *argv[])
    b.AddBdrFaceIntegrator(
       new BoundaryFlowIntegrator(inflow, velocity, -1.0, -0.5));
 
-   m.Assemble();
-   m.Finalize();
    int skip_zeros = 0;
+   if (pa) { k.SetAssemblyLevel(AssemblyLevel::PARTIAL); }
    k.Assemble(skip_zeros);
-   k.Finalize(skip_zeros);
+   if (!pa) { k.Finalize(skip_zeros); }
    b.Assemble();
 
    // 7. Define the initial conditions, save the corresponding grid function to
@@ -263,7 +282,8 @@ int main(int argc, char *argv[])
    // 8. Define the time-dependent evolution operator describing the ODE
    //    right-hand side, and perform time-integration (looping over the time
    //    iterations, ti, with a time-step dt).
-   FE_Evolution adv(m.SpMat(), k.SpMat(), b);
+   Operator &K = pa ? static_cast<Operator&>(k) : k.SpMat();
+   FE_Evolution adv(m_inv, K, b);
 
    double t = 0.0;
    adv.SetTime(t);
@@ -313,25 +333,17 @@ int main(int argc, char *argv[])
 
 
 // Implementation of class FE_Evolution
-FE_Evolution::FE_Evolution(SparseMatrix &_M, SparseMatrix &_K, const Vector &_b)
-   : TimeDependentOperator(_M.Size()), M(_M), K(_K), b(_b), z(_M.Size())
-{
-   M_solver.SetPreconditioner(M_prec);
-   M_solver.SetOperator(M);
-
-   M_solver.iterative_mode = false;
-   M_solver.SetRelTol(1e-9);
-   M_solver.SetAbsTol(0.0);
-   M_solver.SetMaxIter(100);
-   M_solver.SetPrintLevel(0);
-}
+FE_Evolution::FE_Evolution(Operator &_M_inv, Operator &_K, const Vector &_b)
+   : TimeDependentOperator(_M_inv.Height()), M_inv(_M_inv), K(_K), b(_b),
+     z(_M_inv.Height())
+{ }
 
 void FE_Evolution::Mult(const Vector &x, Vector &y) const
 {
    // y = M^{-1} (K x + b)
    K.Mult(x, z);
    z += b;
-   M_solver.Mult(z, y);
+   M_inv.Mult(z, y);
 }
 
 
@@ -19,15 +19,26 @@ namespace mfem
 
 void BilinearForm::AllocMat()
 {
+   FreeCSRMaps();
+
    if (static_cond) { return; }
 
-   if (precompute_sparsity == 0 || fes->GetVDim() > 1)
+   if (precompute_sparsity == 0)
    {
       mat = new SparseMatrix(height);
       return;
    }
 
-   const Table &elem_dof = fes->GetElementToDofTable();
+   // element->dof table with unsigned dofs (e.g. for ND and RT spaces)
+   const int ndofs = fes->GetNDofs();
+   Table elem_dof(fes->GetElementToDofTable());
+   {
+      int *J = elem_dof.GetJ();
+      for (int k = 0; k < elem_dof.Size_of_connections(); k++)
+      {
+         if (J[k] < 0) { J[k] = -1-J[k]; }
+      }
+   }
    Table dof_dof;
 
    if (fbfi.Size() > 0)
@@ -39,27 +50,81 @@ void BilinearForm::AllocMat()
          mfem::Mult(*face_elem, elem_dof, face_dof);
          delete face_elem;
       }
-      Transpose(face_dof, dof_face, height);
+      Transpose(face_dof, dof_face, ndofs);
       mfem::Mult(dof_face, face_dof, dof_dof);
    }
    else
    {
       // the sparsity pattern is defined from the map: element->dof
       Table dof_elem;
-      Transpose(elem_dof, dof_elem, height);
+      Transpose(elem_dof, dof_elem, ndofs);
       mfem::Mult(dof_elem, elem_dof, dof_dof);
    }
 
    dof_dof.SortRows();
 
-   int *I = dof_dof.GetI();
-   int *J = dof_dof.GetJ();
+   int *I, *J;
+   const int vdim = fes->GetVDim();
+   if (vdim == 1)
+   {
+      I = dof_dof.GetI();
+      J = dof_dof.GetJ();
+      dof_dof.LoseData();
+   }
+   else
+   {
+      // expand to vdofs, coupling all vector components
+      const int *dI = dof_dof.GetI(), *dJ = dof_dof.GetJ();
+      const bool by_nodes = (fes->GetOrdering() == Ordering::byNODES);
+      I = new int[height+1];
+      I[0] = 0;
+      for (int vd = 0; vd < vdim; vd++)
+      {
+         for (int i = 0; i < ndofs; i++)
+         {
+            const int row = fes->DofToVDof(i, vd);
+            I[row+1] = vdim*(dI[i+1] - dI[i]);
+         }
+      }
+      for (int row = 0; row < height; row++)
+      {
+         I[row+1] += I[row];
+      }
+      J = new int[I[height]];
+      for (int vd = 0; vd < vdim; vd++)
+      {
+         for (int i = 0; i < ndofs; i++)
+         {
+            // generate the columns of each row in increasing order
+            int *Jr = J + I[fes->DofToVDof(i, vd)];
+            if (by_nodes)
+            {
+               for (int c = 0; c < vdim; c++)
+               {
+                  for (int k = dI[i]; k < dI[i+1]; k++)
+                  {
+                     *(Jr++) = fes->DofToVDof(dJ[k], c);
+                  }
+               }
+            }
+            else
+            {
+               for (int k = dI[i]; k < dI[i+1]; k++)
+               {
+                  for (int c = 0; c < vdim; c++)
+                  {
+                     *(Jr++) = fes->DofToVDof(dJ[k], c);
+                  }
+               }
+            }
+         }
+      }
+   }
+
    double *data = new double[I[height]];
 
    mat = new SparseMatrix(I, J, data, height, height, true, true, true);
    *mat = 0.0;
-
-   dof_dof.LoseData();
 }
 
 BilinearForm::BilinearForm (FiniteElementSpace * f)
@@ -73,6 +138,10 @@ BilinearForm::BilinearForm (FiniteElementSpace * f)
    static_cond = NULL;
    hybridization = NULL;
    precompute_sparsity = 0;
+   assembly = AssemblyLevel::FULL;
+   elem_restrict = NULL;
+   oper = NULL;
+   InitColorings();
 }
 
 BilinearForm::BilinearForm (FiniteElementSpace * f, BilinearForm * bf, int ps)
@@ -89,6 +158,10 @@ BilinearForm::BilinearForm (FiniteElementSpace * f, BilinearForm * bf, int ps)
    static_cond = NULL;
    hybridization = NULL;
    precompute_sparsity = ps;
+   assembly = AssemblyLevel::FULL;
+   elem_restrict = NULL;
+   oper = NULL;
+   InitColorings();
 
    bfi = bf->GetDBFI();
    dbfi.SetSize (bfi->Size());
@@ -121,6 +194,16 @@ BilinearForm::BilinearForm (FiniteElementSpace * f, BilinearForm * bf, int ps)
    AllocMat();
 }
 
+void BilinearForm::SetAssemblyLevel(AssemblyLevel::Type level)
+{
+   if (level != AssemblyLevel::FULL)
+   {
+      MFEM_VERIFY(!static_cond && !hybridization, "static condensation and "
+                  "hybridization require AssemblyLevel::FULL");
+   }
+   assembly = level;
+}
+
 void BilinearForm::EnableStaticCondensation()
 {
    delete static_cond;
@@ -160,6 +243,7 @@ void BilinearForm::UseSparsity(int *I, int *J, bool isSorted)
       }
       delete mat;
    }
+   FreeCSRMaps();
    height = width = fes->GetVSize();
    mat = new SparseMatrix(I, J, NULL, height, width, false, true, isSorted);
 }
@@ -184,6 +268,35 @@ const double& BilinearForm::Elem (int i, int j) const
    return mat -> Elem(i,j);
 }
 
+void BilinearForm::AddMult(const Vector &x, Vector &y, const double a) const
+{
+   if (assembly == AssemblyLevel::FULL)
+   {
+      mat->AddMult(x, y, a);
+   }
+   else
+   {
+      Vector z(y.Size());
+      MultLocal(x, z, false);
+      y.Add(a, z);
+   }
+}
+
+void BilinearForm::AddMultTranspose(const Vector &x, Vector &y,
+                                    const double a) const
+{
+   if (assembly == AssemblyLevel::FULL)
+   {
+      mat->AddMultTranspose(x, y, a);
+   }
+   else
+   {
+      Vector z(y.Size());
+      MultLocal(x, z, true);
+      y.Add(a, z);
+   }
+}
+
 MatrixInverse * BilinearForm::Inverse() const
 {
    return mat -> Inverse();
@@ -191,6 +304,7 @@ MatrixInverse * BilinearForm::Inverse() const
 
 void BilinearForm::Finalize (int skip_zeros)
 {
+   if (assembly != AssemblyLevel::FULL) { return; }
    if (!static_cond) { mat->Finalize(skip_zeros); }
    if (mat_e) { mat_e->Finalize(skip_zeros); }
    if (static_cond) { static_cond->Finalize(); }
@@ -305,11 +419,31 @@ void BilinearForm::Assemble (int skip_zeros)
 
    int i;
 
+   if (assembly != AssemblyLevel::FULL)
+   {
+      AssembleLocal();
+      return;
+   }
+
    if (mat == NULL)
    {
       AllocMat();
    }
 
+   if (!static_cond && !hybridization && mat->Finalized())
+   {
+#ifdef MFEM_USE_OPENMP
+      AssembleColored(skip_zeros);
+      return;
+#else
+      if (frozen_sparsity)
+      {
+         AssembleColored(skip_zeros);
+         return;
+      }
+#endif
+   }
+
 #ifdef MFEM_USE_OPENMP
    int free_element_matrices = 0;
    if (!element_matrices)
@@ -468,6 +602,482 @@ void BilinearForm::Assemble (int skip_zeros)
 #endif
 }
 
+int BilinearForm::GetNumEntities(EntityType type) const
+{
+   switch (type)
+   {
+      case ELEMENT: return fes->GetNE();
+      case INTERIOR_FACE: return fes->GetMesh()->GetNumFaces();
+      default: return fes->GetNBE();
+   }
+}
+
+void BilinearForm::GetEntityVDofs(EntityType type, int i,
+                                  Array<int> &vdofs) const
+{
+   Mesh *mesh = fes->GetMesh();
+   int e1, e2;
+   switch (type)
+   {
+      case ELEMENT:
+         fes->GetElementVDofs(i, vdofs);
+         break;
+      case BDR_ELEMENT:
+         fes->GetBdrElementVDofs(i, vdofs);
+         break;
+      case INTERIOR_FACE:
+         mesh->GetFaceElements(i, &e1, &e2);
+         if (e2 < 0) { vdofs.SetSize(0); break; }
+         {
+            Array<int> vdofs2;
+            fes->GetElementVDofs(e1, vdofs);
+            fes->GetElementVDofs(e2, vdofs2);
+            vdofs.Append(vdofs2);
+         }
+         break;
+      case BDR_FACE:
+         mesh->GetFaceElements(mesh->GetBdrElementEdgeIndex(i), &e1, &e2);
+         fes->GetElementVDofs(e1, vdofs);
+         break;
+      default:
+         MFEM_ABORT("invalid entity type");
+   }
+}
+
+Table *BilinearForm::ColorEntities(EntityType type) const
+{
+   const int num_ent = GetNumEntities(type);
+   Table *colors = new Table;
+#ifdef MFEM_USE_OPENMP
+   Table ent_vdof;
+   Array<int> vdofs;
+   ent_vdof.MakeI(num_ent);
+   for (int i = 0; i < num_ent; i++)
+   {
+      GetEntityVDofs(type, i, vdofs);
+      ent_vdof.AddColumnsInRow(i, vdofs.Size());
+   }
+   ent_vdof.MakeJ();
+   for (int i = 0; i < num_ent; i++)
+   {
+      GetEntityVDofs(type, i, vdofs);
+      for (int j = 0; j < vdofs.Size(); j++)
+      {
+         const int vdof = vdofs[j];
+         ent_vdof.AddConnection(i, (vdof >= 0) ? vdof : -1-vdof);
+      }
+   }
+   ent_vdof.ShiftUpI();
+   GreedyColoring(ent_vdof, *colors, fes->GetVSize());
+#else
+   // without OpenMP, all entities are processed sequentially using one color
+   colors->MakeI(1);
+   colors->AddColumnsInRow(0, num_ent);
+   colors->MakeJ();
+   for (int i = 0; i < num_ent; i++)
+   {
+      colors->AddConnection(0, i);
+   }
+   colors->ShiftUpI();
+#endif
+   return colors;
+}
+
+Table *BilinearForm::BuildCSRMap(EntityType type) const
+{
+   const int num_ent = GetNumEntities(type);
+   const int *I = mat->GetI(), *J = mat->GetJ();
+   Table *csr_map = new Table;
+   Array<int> vdofs, map, col_pos(mat->Width());
+
+   csr_map->MakeI(num_ent);
+   for (int i = 0; i < num_ent; i++)
+   {
+      GetEntityVDofs(type, i, vdofs);
+      csr_map->AddColumnsInRow(i, vdofs.Size()*vdofs.Size());
+   }
+   csr_map->MakeJ();
+   col_pos = -1;
+   for (int i = 0; i < num_ent; i++)
+   {
+      GetEntityVDofs(type, i, vdofs);
+      const int nd = vdofs.Size();
+      map.SetSize(nd*nd);
+      for (int r = 0; r < nd; r++)
+      {
+         const int gi = (vdofs[r] >= 0) ? vdofs[r] : -1-vdofs[r];
+         for (int k = I[gi]; k < I[gi+1]; k++)
+         {
+            col_pos[J[k]] = k;
+         }
+         for (int c = 0; c < nd; c++)
+         {
+            const int gj = (vdofs[c] >= 0) ? vdofs[c] : -1-vdofs[c];
+            const int k = col_pos[gj];
+            // the local matrices are stored column-wise
+            if (k < 0) { map[r+nd*c] = 0; }
+            else { map[r+nd*c] = ((vdofs[r] >= 0) == (vdofs[c] >= 0)) ?
+                                    k+1 : -1-k; }
+         }
+         for (int k = I[gi]; k < I[gi+1]; k++)
+         {
+            col_pos[J[k]] = -1;
+         }
+      }
+      csr_map->AddConnections(i, map.GetData(), map.Size());
+   }
+   csr_map->ShiftUpI();
+   return csr_map;
+}
+
+void BilinearForm::AddToFinalizedMat(const Table *csr_map, int i,
+                                     const Array<int> &vdofs,
+                                     const DenseMatrix &elmat, int skip_zeros,
+                                     Array<int> &col_pos)
+{
+   if (csr_map == NULL)
+   {
+      mat->AddSubMatrix(vdofs, vdofs, elmat, skip_zeros, col_pos);
+      return;
+   }
+   const int *map = csr_map->GetRow(i);
+   const int n = csr_map->RowSize(i);
+   const double *el = elmat.Data();
+   double *A = mat->GetData();
+   if (n == 0) { return; }
+   MFEM_ASSERT(n == elmat.Height()*elmat.Width(), "invalid local matrix");
+   for (int k = 0; k < n; k++)
+   {
+      const int m = map[k];
+      if (m > 0) { A[m-1] += el[k]; }
+      else if (m < 0) { A[-1-m] -= el[k]; }
+      else
+      {
+         MFEM_VERIFY(el[k] == 0.0, "entry of local matrix #" << i
+                     << " is not in the sparsity pattern");
+      }
+   }
+}
+
+void BilinearForm::AssembleColored(int skip_zeros)
+{
+   Mesh *mesh = fes->GetMesh();
+   Array<BilinearFormIntegrator*> *integs[NUM_ENTITY_TYPES] =
+   { &dbfi, &bbfi, &fbfi, &bfbfi };
+
+   for (int t = 0; t < NUM_ENTITY_TYPES; t++)
+   {
+      if (integs[t]->Size() == 0) { continue; }
+      if (!colors[t]) { colors[t] = ColorEntities((EntityType)t); }
+      if (frozen_sparsity && !csr_maps[t])
+      {
+         csr_maps[t] = BuildCSRMap((EntityType)t);
+      }
+   }
+
+   // Which boundary attributes need to be processed?
+   Array<int> bdr_attr_marker;
+   if (bfbfi.Size())
+   {
+      bdr_attr_marker.SetSize(mesh->bdr_attributes.Size() ?
+                              mesh->bdr_attributes.Max() : 0);
+      bdr_attr_marker = 0;
+      for (int k = 0; k < bfbfi.Size(); k++)
+      {
+         if (bfbfi_marker[k] == NULL)
+         {
+            bdr_attr_marker = 1;
+            break;
+         }
+         Array<int> &bdr_marker = *bfbfi_marker[k];
+         MFEM_ASSERT(bdr_marker.Size() == bdr_attr_marker.Size(),
+                     "invalid boundary marker for boundary face integrator #"
+                     << k << ", counting from zero");
+         for (int i = 0; i < bdr_attr_marker.Size(); i++)
+         {
+            bdr_attr_marker[i] |= bdr_marker[i];
+         }
+      }
+   }
+
+   const Table *elem_map = frozen_sparsity ? csr_maps[ELEMENT] : NULL;
+   const Table *bdr_map = frozen_sparsity ? csr_maps[BDR_ELEMENT] : NULL;
+   const Table *face_map = frozen_sparsity ? csr_maps[INTERIOR_FACE] : NULL;
+   const Table *bdr_face_map = frozen_sparsity ? csr_maps[BDR_FACE] : NULL;
+
+   // GetFE() on NURBS spaces, and GetElementTransformation() on NURBS meshes
+   // (through the nodal space), modify a shared NURBSFiniteElement, so the
+   // entities are processed serially
+   const bool nurbs = fes->GetNURBSext() || mesh->NURBSext;
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel if (!nurbs)
+#endif
+   {
+      // thread-private data; note: the integrators must be thread-safe
+      DenseMatrix elmat, tmp;
+      Array<int> vdofs, vdofs2, col_pos;
+      IsoparametricTransformation eltrans, eltrans2, ftrans;
+      FaceElementTransformations ftr;
+      if (!frozen_sparsity)
+      {
+         col_pos.SetSize(mat->Width());
+         col_pos = -1;
+      }
+
+      for (int c = 0; dbfi.Size() && c < colors[ELEMENT]->Size(); c++)
+      {
+         const int *elems = colors[ELEMENT]->GetRow(c);
+         const int num_elems = colors[ELEMENT]->RowSize(c);
+#ifdef MFEM_USE_OPENMP
+         #pragma omp for
+#endif
+         for (int j = 0; j < num_elems; j++)
+         {
+            const int i = elems[j];
+            fes->GetElementVDofs(i, vdofs);
+            if (element_matrices)
+            {
+               elmat.UseExternalData(element_matrices->GetData(i),
+                                     vdofs.Size(), vdofs.Size());
+               AddToFinalizedMat(elem_map, i, vdofs, elmat, skip_zeros,
+                                 col_pos);
+               elmat.ClearExternalData();
+               continue;
+            }
+            const FiniteElement &fe = *fes->GetFE(i);
+            fes->GetElementTransformation(i, &eltrans);
+            dbfi[0]->AssembleElementMatrix(fe, eltrans, elmat);
+            for (int k = 1; k < dbfi.Size(); k++)
+            {
+               dbfi[k]->AssembleElementMatrix(fe, eltrans, tmp);
+               elmat += tmp;
+            }
+            AddToFinalizedMat(elem_map, i, vdofs, elmat, skip_zeros, col_pos);
+         }
+      }
+
+      for (int c = 0; bbfi.Size() && c < colors[BDR_ELEMENT]->Size(); c++)
+      {
+         const int *belems = colors[BDR_ELEMENT]->GetRow(c);
+         const int num_belems = colors[BDR_ELEMENT]->RowSize(c);
+#ifdef MFEM_USE_OPENMP
+         #pragma omp for
+#endif
+         for (int j = 0; j < num_belems; j++)
+         {
+            const int i = belems[j];
+            const FiniteElement &be = *fes->GetBE(i);
+            fes->GetBdrElementVDofs(i, vdofs);
+            mesh->GetBdrElementTransformation(i, &eltrans);
+            bbfi[0]->AssembleElementMatrix(be, eltrans, elmat);
+            for (int k = 1; k < bbfi.Size(); k++)
+            {
+               bbfi[k]->AssembleElementMatrix(be, eltrans, tmp);
+               elmat += tmp;
+            }
+            AddToFinalizedMat(bdr_map, i, vdofs, elmat, skip_zeros, col_pos);
+         }
+      }
+
+      for (int c = 0; fbfi.Size() && c < colors[INTERIOR_FACE]->Size(); c++)
+      {
+         const int *faces = colors[INTERIOR_FACE]->GetRow(c);
+         const int num_faces = colors[INTERIOR_FACE]->RowSize(c);
+#ifdef MFEM_USE_OPENMP
+         #pragma omp for
+#endif
+         for (int j = 0; j < num_faces; j++)
+         {
+            const int i = faces[j];
+            if (!mesh->FaceIsInterior(i)) { continue; }
+            mesh->GetFaceElementTransformations(i, ftr, eltrans, eltrans2,
+                                                ftrans);
+            fes->GetElementVDofs(ftr.Elem1No, vdofs);
+            fes->GetElementVDofs(ftr.Elem2No, vdofs2);
+            vdofs.Append(vdofs2);
+            for (int k = 0; k < fbfi.Size(); k++)
+            {
+               fbfi[k]->AssembleFaceMatrix(*fes->GetFE(ftr.Elem1No),
+                                           *fes->GetFE(ftr.Elem2No),
+                                           ftr, elmat);
+               AddToFinalizedMat(face_map, i, vdofs, elmat, skip_zeros,
+                                 col_pos);
+            }
+         }
+      }
+
+      for (int c = 0; bfbfi.Size() && c < colors[BDR_FACE]->Size(); c++)
+      {
+         const int *belems = colors[BDR_FACE]->GetRow(c);
+         const int num_belems = colors[BDR_FACE]->RowSize(c);
+#ifdef MFEM_USE_OPENMP
+         #pragma omp for
+#endif
+         for (int j = 0; j < num_belems; j++)
+         {
+            const int i = belems[j];
+            const int bdr_attr = mesh->GetBdrAttribute(i);
+            if (bdr_attr_marker[bdr_attr-1] == 0) { continue; }
+
+            if (!mesh->GetBdrFaceTransformations(i, ftr, eltrans, ftrans))
+            {
+               continue;
+            }
+            fes->GetElementVDofs(ftr.Elem1No, vdofs);
+            // fe1 is also used as the (unused) second element, see Assemble()
+            const FiniteElement &fe1 = *fes->GetFE(ftr.Elem1No);
+            for (int k = 0; k < bfbfi.Size(); k++)
+            {
+               if (bfbfi_marker[k] &&
+                   (*bfbfi_marker[k])[bdr_attr-1] == 0) { continue; }
+
+               bfbfi[k]->AssembleFaceMatrix(fe1, fe1, ftr, elmat);
+               AddToFinalizedMat(bdr_face_map, i, vdofs, elmat, skip_zeros,
+                                 col_pos);
+            }
+         }
+      }
+   }
+}
+
+void BilinearForm::FreeColorings()
+{
+   for (int t = 0; t < NUM_ENTITY_TYPES; t++)
+   {
+      delete colors[t];
+      colors[t] = NULL;
+   }
+}
+
+void BilinearForm::FreeCSRMaps()
+{
+   for (int t = 0; t < NUM_ENTITY_TYPES; t++)
+   {
+      delete csr_maps[t];
+      csr_maps[t] = NULL;
+   }
+}
+
+void BilinearForm::AssembleLocal()
+{
+   MFEM_VERIFY(bbfi.Size() == 0, "boundary integrators are not supported"
+               " with the ELEMENT and PARTIAL assembly levels");
+
+   delete elem_restrict;
+   if (assembly == AssemblyLevel::ELEMENT)
+   {
+      MFEM_VERIFY(fbfi.Size() == 0 && bfbfi.Size() == 0, "face integrators"
+                  " are not supported with the ELEMENT assembly level");
+      // The element matrices use the native element dof ordering.
+      elem_restrict = new ElementRestriction(*fes, false);
+      FreeElementMatrices();
+      ComputeElementMatrices();
+   }
+   else
+   {
+      elem_restrict = new ElementRestriction(*fes, true);
+      for (int k = 0; k < dbfi.Size(); k++)
+      {
+         dbfi[k]->AssemblePA(*fes);
+      }
+      for (int k = 0; k < fbfi.Size(); k++)
+      {
+         fbfi[k]->AssemblePAInteriorFaces(*fes);
+      }
+      for (int k = 0; k < bfbfi.Size(); k++)
+      {
+         bfbfi[k]->AssemblePABoundaryFaces(*fes, bfbfi_marker[k]);
+      }
+   }
+}
+
+void BilinearForm::MultLocal(const Vector &x, Vector &y, bool transpose) const
+{
+   MFEM_VERIFY(elem_restrict, "the BilinearForm is not assembled");
+
+   elem_restrict->Mult(x, x_e);
+   y_e.SetSize(x_e.Size());
+   y_e = 0.0;
+   if (assembly == AssemblyLevel::ELEMENT)
+   {
+      if (element_matrices)
+      {
+         const int n = element_matrices->SizeI();
+         for (int e = 0; e < element_matrices->SizeK(); e++)
+         {
+            DenseMatrix elmat(element_matrices->GetData(e), n, n);
+            Vector xe(x_e.GetData() + e*n, n), ye(y_e.GetData() + e*n, n);
+            if (transpose) { elmat.MultTranspose(xe, ye); }
+            else { elmat.Mult(xe, ye); }
+            elmat.ClearExternalData();
+         }
+      }
+   }
+   else
+   {
+      for (int k = 0; k < dbfi.Size(); k++)
+      {
+         if (transpose) { dbfi[k]->AddMultTransposePA(x_e, y_e); }
+         else { dbfi[k]->AddMultPA(x_e, y_e); }
+      }
+      // The face integrators act on the same E-vectors, coupling the
+      // elements on the two sides of each face.
+      for (int k = 0; k < fbfi.Size(); k++)
+      {
+         if (transpose) { fbfi[k]->AddMultTransposePA(x_e, y_e); }
+         else { fbfi[k]->AddMultPA(x_e, y_e); }
+      }
+      for (int k = 0; k < bfbfi.Size(); k++)
+      {
+         if (transpose) { bfbfi[k]->AddMultTransposePA(x_e, y_e); }
+         else { bfbfi[k]->AddMultPA(x_e, y_e); }
+      }
+   }
+   elem_restrict->MultTranspose(y_e, y);
+}
+
+void BilinearForm::AssembleDiagonal(Vector &diag) const
+{
+   diag.SetSize(height);
+   if (assembly == AssemblyLevel::FULL)
+   {
+      MFEM_VERIFY(mat && mat->Finalized(), "the BilinearForm is not"
+                  " assembled and finalized");
+      mat->GetDiag(diag);
+      return;
+   }
+
+   MFEM_VERIFY(elem_restrict, "the BilinearForm is not assembled");
+   MFEM_VERIFY(fbfi.Size() == 0 && bfbfi.Size() == 0, "the diagonal of face"
+               " integrators is not supported");
+   if (assembly == AssemblyLevel::ELEMENT)
+   {
+      diag = 0.0;
+      if (!element_matrices) { return; }
+      Array<int> evdofs;
+      const int n = element_matrices->SizeI();
+      for (int e = 0; e < element_matrices->SizeK(); e++)
+      {
+         fes->GetElementVDofs(e, evdofs);
+         for (int i = 0; i < n; i++)
+         {
+            const int j = evdofs[i];
+            diag(j >= 0 ? j : -1-j) += (*element_matrices)(i,i,e);
+         }
+      }
+   }
+   else
+   {
+      y_e.SetSize(elem_restrict->Height());
+      y_e = 0.0;
+      for (int k = 0; k < dbfi.Size(); k++)
+      {
+         dbfi[k]->AssembleDiagonalPA(y_e);
+      }
+      elem_restrict->MultTranspose(y_e, diag);
+   }
+}
+
 void BilinearForm::ConformingAssemble()
 {
    // Do not remove zero entries to preserve the symmetric structure of the
@@ -569,6 +1179,47 @@ void BilinearForm::FormLinearSystem(const Array<int> &ess_tdof_list,
    }
 }
 
+void BilinearForm::FormLinearSystem(const Array<int> &ess_tdof_list,
+                                    Vector &x, Vector &b,
+                                    Operator* &A, Vector &X, Vector &B,
+                                    int copy_interior)
+{
+   if (assembly == AssemblyLevel::FULL)
+   {
+      SparseMatrix *S = new SparseMatrix;
+      FormLinearSystem(ess_tdof_list, x, b, *S, X, B, copy_interior);
+      delete oper;
+      A = oper = S;
+      return;
+   }
+
+   FormSystemOperator(ess_tdof_list, A);
+
+   // A, X and B point to the same data as the form, x and b
+   static_cast<ConstrainedOperator*>(A)->EliminateRHS(x, b);
+   X.NewDataAndSize(x.GetData(), x.Size());
+   B.NewDataAndSize(b.GetData(), b.Size());
+   if (!copy_interior) { X.SetSubVectorComplement(ess_tdof_list, 0.0); }
+}
+
+void BilinearForm::FormSystemOperator(const Array<int> &ess_tdof_list,
+                                      Operator* &A)
+{
+   if (assembly == AssemblyLevel::FULL)
+   {
+      SparseMatrix *S = new SparseMatrix;
+      FormSystemMatrix(ess_tdof_list, *S);
+      delete oper;
+      A = oper = S;
+      return;
+   }
+
+   MFEM_VERIFY(!fes->GetConformingProlongation(), "non-conforming spaces"
+               " are supported only with AssemblyLevel::FULL");
+   delete oper;
+   A = oper = new ConstrainedOperator(this, ess_tdof_list);
+}
+
 void BilinearForm::FormSystemMatrix(const Array<int> &ess_tdof_list,
                                     SparseMatrix &A)
 {
@@ -668,32 +1319,12 @@ void BilinearForm::ComputeElementMatrices()
    element_matrices = new DenseTensor(num_dofs_per_el, num_dofs_per_el,
                                       num_elements);
 
-   DenseMatrix tmp;
-   IsoparametricTransformation eltrans;
-
-#ifdef MFEM_USE_OPENMP
-   #pragma omp parallel for private(tmp,eltrans)
-#endif
-   for (int i = 0; i < num_elements; i++)
+   // each integrator computes (or adds) the matrices of all elements, see
+   // BilinearFormIntegrator::AssembleElementMatrices
+   for (int k = 0; k < dbfi.Size(); k++)
    {
-      DenseMatrix elmat(element_matrices->GetData(i),
-                        num_dofs_per_el, num_dofs_per_el);
-      const FiniteElement &fe = *fes->GetFE(i);
-#ifdef MFEM_DEBUG
-      if (num_dofs_per_el != fe.GetDof()*fes->GetVDim())
-         mfem_error("BilinearForm::ComputeElementMatrices:"
-                    " all elements must have same number of dofs");
-#endif
-      fes->GetElementTransformation(i, &eltrans);
-
-      dbfi[0]->AssembleElementMatrix(fe, eltrans, elmat);
-      for (int k = 1; k < dbfi.Size(); k++)
-      {
-         // note: some integrators may not be thread-safe
-         dbfi[k]->AssembleElementMatrix(fe, eltrans, tmp);
-         elmat += tmp;
-      }
-      elmat.ClearExternalData();
+      dbfi[k]->AssembleElementMatrices(*fes, 0, num_elements,
+                                       *element_matrices, k > 0);
    }
 }
 
@@ -853,9 +1484,15 @@ void BilinearForm::Update(FiniteElementSpace *nfes)
    FreeElementMatrices();
    delete static_cond;
    static_cond = NULL;
+   delete elem_restrict;
+   elem_restrict = NULL;
+   delete oper;
+   oper = NULL;
 
    if (full_update)
    {
+      FreeColorings();
+      FreeCSRMaps();
       delete mat;
       mat = NULL;
       delete hybridization;
@@ -873,6 +1510,10 @@ void BilinearForm::Update(FiniteElementSpace *nfes)
 
 BilinearForm::~BilinearForm()
 {
+   FreeColorings();
+   FreeCSRMaps();
+   delete oper;
+   delete elem_restrict;
    delete mat_e;
    delete mat;
    delete element_matrices;
@@ -24,6 +24,21 @@
 namespace mfem
 {
 
+/// Enumeration defining the assembly level for bilinear forms.
+class AssemblyLevel
+{
+public:
+   /** Assembly levels:
+       FULL    - assemble the global SparseMatrix (the default),
+       ELEMENT - compute and store the element matrices; the action of the form
+                 is computed element by element, without a global matrix,
+       PARTIAL - store only data at the quadrature points; the action of the
+                 form is computed using sum-factorization with the 1D bases of
+                 tensor-product elements, see BilinearFormIntegrator::AddMultPA.
+   */
+   enum Type { FULL, ELEMENT, PARTIAL };
+};
+
 /** Class for bilinear form - "Matrix" with associated FE space and
     BLFIntegrators. */
 class BilinearForm : public Matrix
@@ -66,11 +81,73 @@ protected:
    Hybridization *hybridization;
 
    int precompute_sparsity;
+
+   /// The assembly level of the form, see SetAssemblyLevel().
+   AssemblyLevel::Type assembly;
+   /// Element restriction used with the ELEMENT and PARTIAL assembly levels.
+   ElementRestriction *elem_restrict;
+   /// Operator returned by FormLinearSystem() when mat is not assembled.
+   Operator *oper;
+   mutable Vector x_e, y_e; // E-vectors, see class ElementRestriction
+
+   /// Types of mesh entities with local matrices, one per integrator array.
+   enum EntityType { ELEMENT, BDR_ELEMENT, INTERIOR_FACE, BDR_FACE,
+                     NUM_ENTITY_TYPES
+                   };
+
+   /** Colorings of the elements, boundary elements, interior faces, and
+       boundary faces (through their boundary elements) used by the
+       thread-parallel assembly, see AssembleColored(). Entities with the same
+       color do not share dofs. */
+   Table *colors[NUM_ENTITY_TYPES];
+
+   int frozen_sparsity;
+   /** Maps from the entries of the local matrices of each entity to the
+       entries of the finalized matrix mat, see UseFrozenSparsity(). Row i of
+       the Table lists, column-wise, the local matrix entries of entity i as
+       k+1 or -1-k (for entries with a sign change) where k is the offset in
+       the data array of mat; 0 marks entries not in the sparsity pattern. */
+   Table *csr_maps[NUM_ENTITY_TYPES];
+
    // Allocate appropriate SparseMatrix and assign it to mat
    void AllocMat();
 
    void ConformingAssemble();
 
+   int GetNumEntities(EntityType type) const;
+   void GetEntityVDofs(EntityType type, int i, Array<int> &vdofs) const;
+   Table *ColorEntities(EntityType type) const;
+   Table *BuildCSRMap(EntityType type) const;
+
+   /** Add the local matrix of entity i to the finalized matrix mat, using the
+       map @a csr_map if not NULL, or the work array @a col_pos otherwise. */
+   void AddToFinalizedMat(const Table *csr_map, int i, const Array<int> &vdofs,
+                          const DenseMatrix &elmat, int skip_zeros,
+                          Array<int> &col_pos);
+
+   /** Version of Assemble() for a finalized matrix mat: entities of the same
+       color are processed concurrently (with OpenMP), each thread adding its
+       local matrices directly to mat. Used by Assemble() when mat is already
+       finalized (e.g. when reassembling, or with UsePrecomputedSparsity()) and
+       either OpenMP or UseFrozenSparsity() is enabled. NURBS spaces and
+       spaces on NURBS meshes are processed by a single thread. */
+   void AssembleColored(int skip_zeros);
+   void FreeColorings();
+   void FreeCSRMaps();
+
+   void InitColorings()
+   {
+      frozen_sparsity = 0;
+      for (int t = 0; t < NUM_ENTITY_TYPES; t++)
+      {
+         colors[t] = csr_maps[t] = NULL;
+      }
+   }
+
+   // Assembly and action for the ELEMENT and PARTIAL assembly levels
+   void AssembleLocal();
+   void MultLocal(const Vector &x, Vector &y, bool transpose) const;
+
    // may be used in the construction of derived classes
    BilinearForm() : Matrix (0)
    {
@@ -78,6 +155,8 @@ protected:
       mat = mat_e = NULL; extern_bfs = 0; element_matrices = NULL;
       static_cond = NULL; hybridization = NULL;
       precompute_sparsity = 0;
+      assembly = AssemblyLevel::FULL; elem_restrict = NULL; oper = NULL;
+      InitColorings();
    }
 
 public:
@@ -89,6 +168,21 @@ public:
    /// Get the size of the BilinearForm as a square matrix.
    int Size() const { return height; }
 
+   /** @brief Set the assembly level of the form, see AssemblyLevel. This
+       method should be called before assembly.
+
+       With the ELEMENT and PARTIAL levels no global SparseMatrix is assembled
+       and only the domain integrators are supported; the PARTIAL level further
+       requires that all domain integrators implement AssemblePA(), and also
+       supports interior and boundary face integrators implementing
+       AssemblePAInteriorFaces() and AssemblePABoundaryFaces(). Use
+       FormLinearSystem() with an Operator to obtain the (constrained) linear
+       system. */
+   void SetAssemblyLevel(AssemblyLevel::Type level);
+
+   /// Return the assembly level of the form.
+   AssemblyLevel::Type GetAssemblyLevel() const { return assembly; }
+
    /** Enable the use of static condensation. For details see the description
        for class StaticCondensation in fem/staticcond.hpp This method should be
        called before assembly. If the number of unknowns after static
@@ -110,11 +204,23 @@ public:
                             BilinearFormIntegrator *constr_integ,
                             const Array<int> &ess_tdof_list);
 
-   /** For scalar FE spaces, precompute the sparsity pattern of the matrix
-       (assuming dense element matrices) based on the types of integrators
-       present in the bilinear form. */
+   /** Precompute the sparsity pattern of the matrix (assuming dense element
+       matrices) based on the types of integrators present in the bilinear
+       form. For vector FE spaces, all components are assumed coupled. */
    void UsePrecomputedSparsity(int ps = 1) { precompute_sparsity = ps; }
 
+   /** @brief Reuse the sparsity pattern of the finalized matrix for value-only
+       reassembly.
+
+       When enabled and the matrix is finalized (e.g. after the first Assemble()
+       and Finalize(), or when using UsePrecomputedSparsity()), Assemble()
+       computes once maps from the entries of the element, boundary element and
+       face matrices to the entries of the CSR matrix. The local matrices are
+       then added directly to the CSR data array, without searching the matrix
+       rows. The maps use memory comparable to storing all local matrices; they
+       are not used with static condensation or hybridization. */
+   void UseFrozenSparsity(int fs = 1) { frozen_sparsity = fs; }
+
    /** @brief Use the given CSR sparsity pattern to allocate the internal
        SparseMatrix.
 
@@ -151,20 +257,28 @@ public:
    virtual const double &Elem(int i, int j) const;
 
    /// Matrix vector multiplication.
-   virtual void Mult(const Vector &x, Vector &y) const { mat->Mult(x, y); }
+   virtual void Mult(const Vector &x, Vector &y) const
+   {
+      if (assembly == AssemblyLevel::FULL) { mat->Mult(x, y); }
+      else { MultLocal(x, y, false); }
+   }
 
    void FullMult(const Vector &x, Vector &y) const
    { mat->Mult(x, y); mat_e->AddMult(x, y); }
 
-   virtual void AddMult(const Vector &x, Vector &y, const double a = 1.0) const
-   { mat -> AddMult (x, y, a); }
+   virtual void AddMult(const Vector &x, Vector &y, const double a = 1.0) const;
 
    void FullAddMult(const Vector &x, Vector &y) const
    { mat->AddMult(x, y); mat_e->AddMult(x, y); }
 
    virtual void AddMultTranspose(const Vector & x, Vector & y,
-                                 const double a = 1.0) const
-   { mat->AddMultTranspose(x, y, a); }
+                                 const double a = 1.0) const;
+
+   /** @brief Compute the diagonal of the (unconstrained) form, e.g. for
+       Jacobi and Chebyshev smoothers. With the PARTIAL assembly level, the
+       diagonal is computed from the quadrature data without forming the
+       element matrices, see BilinearFormIntegrator::AssembleDiagonalPA(). */
+   void AssembleDiagonal(Vector &diag) const;
 
    void FullAddMultTranspose (const Vector & x, Vector & y) const
    { mat->AddMultTranspose(x, y); mat_e->AddMultTranspose(x, y); }
@@ -229,7 +343,13 @@ public:
       if (mat_e != NULL) { *mat_e = a; }
    }
 
-   /// Assembles the form i.e. sums over all domain/bdr integrators.
+   /** @brief Assembles the form i.e. sums over all domain/bdr integrators.
+
+       When MFEM is built with OpenMP and the matrix is already finalized, e.g.
+       when reassembling the form or when UsePrecomputedSparsity() is used, the
+       assembly is performed in parallel using colorings of the elements and
+       faces; this requires thread-safe integrators, see MFEM_THREAD_SAFE. See
+       also UseFrozenSparsity(). */
    void Assemble(int skip_zeros = 1);
 
    /// Get the finite element space prolongation matrix
@@ -265,9 +385,26 @@ public:
                          SparseMatrix &A, Vector &X, Vector &B,
                          int copy_interior = 0);
 
+   /** @brief Form the linear system A X = B as above, returning the system
+       as an Operator.
+
+       This version must be used with the ELEMENT and PARTIAL assembly levels
+       (see SetAssemblyLevel()), where the essential boundary conditions are
+       imposed through a ConstrainedOperator; it also works with FULL assembly.
+       The returned Operator is owned by the BilinearForm. Static condensation,
+       hybridization and non-conforming spaces are supported only with FULL
+       assembly. */
+   void FormLinearSystem(const Array<int> &ess_tdof_list, Vector &x, Vector &b,
+                         Operator* &A, Vector &X, Vector &B,
+                         int copy_interior = 0);
+
    /// Form the linear system matrix A, see FormLinearSystem for details.
    void FormSystemMatrix(const Array<int> &ess_tdof_list, SparseMatrix &A);
 
+   /** @brief Form the linear system operator A, see FormLinearSystem for
+       details. The returned Operator is owned by the BilinearForm. */
+   void FormSystemOperator(const Array<int> &ess_tdof_list, Operator* &A);
+
    /** Call this method after solving a linear system constructed using the
        FormLinearSystem method to recover the solution as a GridFunction-size
        vector in x. Use the same arguments as in the FormLinearSystem call. */
@@ -61,6 +61,75 @@ void BilinearFormIntegrator::AssembleElementVector(
               "   is not implemented fot this class.");
 }
 
+void BilinearFormIntegrator::AssemblePA(const FiniteElementSpace &fes)
+{
+   MFEM_ABORT("partial assembly is not implemented for this Integrator class.");
+}
+
+void BilinearFormIntegrator::AddMultPA(const Vector &x, Vector &y) const
+{
+   MFEM_ABORT("partial assembly is not implemented for this Integrator class.");
+}
+
+void BilinearFormIntegrator::AddMultTransposePA(const Vector &x,
+                                                Vector &y) const
+{
+   MFEM_ABORT("partial assembly is not implemented for this Integrator class.");
+}
+
+void BilinearFormIntegrator::AssembleDiagonalPA(Vector &diag) const
+{
+   MFEM_ABORT("partial assembly is not implemented for this Integrator class.");
+}
+
+void BilinearFormIntegrator::AssemblePAInteriorFaces(
+   const FiniteElementSpace &fes)
+{
+   MFEM_ABORT("partial assembly is not implemented for this Integrator class.");
+}
+
+void BilinearFormIntegrator::AssemblePABoundaryFaces(
+   const FiniteElementSpace &fes, const Array<int> *bdr_marker)
+{
+   MFEM_ABORT("partial assembly is not implemented for this Integrator class.");
+}
+
+void BilinearFormIntegrator::AssembleElementMatrices(
+   FiniteElementSpace &fes, int e_begin, int e_end, DenseTensor &elmats,
+   bool add)
+{
+   const int height = elmats.SizeI(), width = elmats.SizeJ();
+   DenseMatrix elmat, tmp;
+   IsoparametricTransformation eltrans;
+
+   // GetFE() on NURBS spaces and GetElementTransformation() on NURBS meshes
+   // modify a shared NURBSFiniteElement
+   const bool nurbs = fes.GetNURBSext() || fes.GetMesh()->NURBSext;
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for private(elmat,tmp,eltrans) if (!nurbs)
+#endif
+   for (int i = e_begin; i < e_end; i++)
+   {
+      const FiniteElement &fe = *fes.GetFE(i);
+      MFEM_ASSERT(fe.GetDof()*fes.GetVDim() == height,
+                  "all elements must have the same number of dofs");
+      fes.GetElementTransformation(i, &eltrans);
+
+      // note: some integrators may not be thread-safe
+      elmat.UseExternalData(elmats.GetData(i), height, width);
+      if (!add)
+      {
+         AssembleElementMatrix(fe, eltrans, elmat);
+      }
+      else
+      {
+         AssembleElementMatrix(fe, eltrans, tmp);
+         elmat += tmp;
+      }
+      elmat.ClearExternalData();
+   }
+}
+
 
 void TransposeIntegrator::AssembleElementMatrix (
    const FiniteElement &el, ElementTransformation &Trans, DenseMatrix &elmat)
@@ -373,6 +442,7 @@ void DiffusionIntegrator::AssembleElementMatrix
 
 #ifdef MFEM_THREAD_SAFE
    DenseMatrix dshape(nd,dim), dshapedxt(nd,spaceDim), invdfdx(dim,spaceDim);
+   DenseMatrix grad, gradw;
 #else
    dshape.SetSize(nd,dim);
    dshapedxt.SetSize(nd,spaceDim);
@@ -404,33 +474,61 @@ void DiffusionIntegrator::AssembleElementMatrix
       }
    }
 
+   // the reference gradients at all points, tabulated once per element type
+   DofToQuad nurbs_maps;
+   const DofToQuad &maps = el.GetDofToQuad(*ir, nurbs_maps);
+   const int nq = ir->GetNPoints();
+   const int ng = nd*spaceDim;
+   DenseMatrix ref_dshape, grad_q;
+   if (!MQ)
+   {
+      // Store the weighted and unweighted physical gradients at all points
+      // side by side, so that the element matrix is a single matrix product.
+      grad.SetSize(nd, nq*spaceDim);
+      gradw.SetSize(nd, nq*spaceDim);
+      for (int i = 0; i < nq; i++)
+      {
+         const IntegrationPoint &ip = ir->IntPoint(i);
+         maps.GetG(i, ref_dshape);
+
+         Trans.SetIntPoint(&ip);
+         w = Trans.Weight();
+         w = ip.weight / (square ? w : w*w*w);
+         if (Q)
+         {
+            w *= Q->Eval(Trans, ip);
+         }
+         // AdjugateJacobian = / adj(J),         if J is square
+         //                    \ adj(J^t.J).J^t, otherwise
+         grad_q.UseExternalData(grad.Data() + i*ng, nd, spaceDim);
+         Mult(ref_dshape, Trans.AdjugateJacobian(), grad_q);
+         const double *g = grad_q.Data();
+         double *gw = gradw.Data() + i*ng;
+         for (int k = 0; k < ng; k++)
+         {
+            gw[k] = w*g[k];
+         }
+      }
+      MultABt(gradw, grad, elmat);
+      return;
+   }
+
    elmat = 0.0;
-   for (int i = 0; i < ir->GetNPoints(); i++)
+   for (int i = 0; i < nq; i++)
    {
       const IntegrationPoint &ip = ir->IntPoint(i);
-      el.CalcDShape(ip, dshape);
+      maps.GetG(i, ref_dshape);
 
       Trans.SetIntPoint(&ip);
       w = Trans.Weight();
       w = ip.weight / (square ? w : w*w*w);
       // AdjugateJacobian = / adj(J),         if J is square
       //                    \ adj(J^t.J).J^t, otherwise
-      Mult(dshape, Trans.AdjugateJacobian(), dshapedxt);
-      if (!MQ)
-      {
-         if (Q)
-         {
-            w *= Q->Eval(Trans, ip);
-         }
-         AddMult_a_AAt(w, dshapedxt, elmat);
-      }
-      else
-      {
-         MQ->Eval(invdfdx, Trans, ip);
-         invdfdx *= w;
-         Mult(dshapedxt, invdfdx, dshape);
-         AddMultABt(dshape, dshapedxt, elmat);
-      }
+      Mult(ref_dshape, Trans.AdjugateJacobian(), dshapedxt);
+      MQ->Eval(invdfdx, Trans, ip);
+      invdfdx *= w;
+      Mult(dshapedxt, invdfdx, dshape);
+      AddMultABt(dshape, dshapedxt, elmat);
    }
 }
 
@@ -524,13 +622,14 @@ void DiffusionIntegrator::AssembleElementVector(
 
 #ifdef MFEM_THREAD_SAFE
    DenseMatrix dshape(nd,dim), invdfdx(dim), mq(dim);
+   Vector vec(dim), pointflux(dim);
 #else
    dshape.SetSize(nd,dim);
    invdfdx.SetSize(dim);
    mq.SetSize(dim);
-#endif
    vec.SetSize(dim);
    pointflux.SetSize(dim);
+#endif
 
    elvect.SetSize(nd);
 
@@ -603,12 +702,13 @@ void DiffusionIntegrator::ComputeElementFlux
 
 #ifdef MFEM_THREAD_SAFE
    DenseMatrix dshape(nd,dim), invdfdx(dim, spaceDim);
+   Vector vec(dim), pointflux(spaceDim);
 #else
    dshape.SetSize(nd,dim);
    invdfdx.SetSize(dim, spaceDim);
-#endif
    vec.SetSize(dim);
    pointflux.SetSize(spaceDim);
+#endif
 
    const IntegrationRule &ir = fluxelem.GetNodes();
    fnd = ir.GetNPoints();
@@ -659,11 +759,12 @@ double DiffusionIntegrator::ComputeFluxEnergy
 
 #ifdef MFEM_THREAD_SAFE
    DenseMatrix mq;
-#endif
-
+   Vector shape(nd), pointflux(spaceDim), vec(d_energy ? dim : 0);
+#else
    shape.SetSize(nd);
    pointflux.SetSize(spaceDim);
    if (d_energy) { vec.SetSize(dim); }
+#endif
    if (MQ) { mq.SetSize(dim); }
 
    int order = 2 * fluxelem.GetOrder(); // <--
@@ -726,10 +827,9 @@ void MassIntegrator::AssembleElementMatrix
    double w;
 
 #ifdef MFEM_THREAD_SAFE
-   Vector shape;
+   DenseMatrix Bw;
 #endif
    elmat.SetSize(nd);
-   shape.SetSize(nd);
 
    const IntegrationRule *ir = IntRule;
    if (ir == NULL)
@@ -747,11 +847,15 @@ void MassIntegrator::AssembleElementMatrix
       }
    }
 
-   elmat = 0.0;
-   for (int i = 0; i < ir->GetNPoints(); i++)
+   // elmat = B diag(w) B^t, where the columns of B are the values of the
+   // shape functions at the points, tabulated once per element type
+   DofToQuad nurbs_maps;
+   const DofToQuad &maps = el.GetDofToQuad(*ir, nurbs_maps);
+   const int nq = ir->GetNPoints();
+   Bw.SetSize(nd, nq);
+   for (int i = 0; i < nq; i++)
    {
       const IntegrationPoint &ip = ir->IntPoint(i);
-      el.CalcShape(ip, shape);
 
       Trans.SetIntPoint (&ip);
       w = Trans.Weight() * ip.weight;
@@ -760,8 +864,12 @@ void MassIntegrator::AssembleElementMatrix
          w *= Q -> Eval(Trans, ip);
       }
 
-      AddMult_a_VVt(w, shape, elmat);
+      for (int j = 0; j < nd; j++)
+      {
+         Bw(j,i) = w * maps.B(j,i);
+      }
    }
+   MultABt(Bw, maps.B, elmat);
 }
 
 void MassIntegrator::AssembleElementMatrix2(
@@ -1441,10 +1549,16 @@ void CurlCurlIntegrator::AssembleElementMatrix
       ir = &IntRules.Get(el.GetGeomType(), order);
    }
 
+   // the reference curls at all points, tabulated once per element type
+   DofToQuad nurbs_maps;
+   const DofToQuad &maps = el.GetDofToQuad(*ir, nurbs_maps);
+   DenseMatrix ref_curlshape;
+
    elmat = 0.0;
    for (int i = 0; i < ir->GetNPoints(); i++)
    {
       const IntegrationPoint &ip = ir->IntPoint(i);
+      maps.GetG(i, ref_curlshape);
 
       Trans.SetIntPoint (&ip);
 
@@ -1452,12 +1566,11 @@ void CurlCurlIntegrator::AssembleElementMatrix
 
       if ( dim == 3 )
       {
-         el.CalcCurlShape(ip, curlshape);
-         MultABt(curlshape, Trans.Jacobian(), curlshape_dFt);
+         MultABt(ref_curlshape, Trans.Jacobian(), curlshape_dFt);
       }
       else
       {
-         el.CalcCurlShape(ip, curlshape_dFt);
+         curlshape_dFt = ref_curlshape;
       }
 
       if (MQ)
@@ -1504,11 +1617,13 @@ double CurlCurlIntegrator::ComputeFluxEnergy(const FiniteElement &fluxelem,
    int dim = fluxelem.GetDim();
 
 #ifdef MFEM_THREAD_SAFE
-   DenseMatrix vshape;
-#endif
+   DenseMatrix vshape(nd, dim);
+   Vector pointflux(dim), vec(d_energy ? dim : 0);
+#else
    vshape.SetSize(nd, dim);
    pointflux.SetSize(dim);
    if (d_energy) { vec.SetSize(dim); }
+#endif
 
    int order = 2 * fluxelem.GetOrder(); // <--
    const IntegrationRule &ir = IntRules.Get(fluxelem.GetGeomType(), order);
@@ -1714,6 +1829,24 @@ double VectorCurlCurlIntegrator::GetElementEnergy(
 }
 
 
+// Map the reference vector shape functions of el at the current point of
+// Trans to physical space, as VectorFiniteElement::CalcVShape(Trans, vshape).
+static void MapVectorShape(const FiniteElement &el,
+                           const DenseMatrix &ref_vshape,
+                           ElementTransformation &Trans, DenseMatrix &vshape)
+{
+   if (el.GetMapType() == FiniteElement::H_DIV)
+   {
+      MultABt(ref_vshape, Trans.Jacobian(), vshape);
+      vshape *= (1.0 / Trans.Weight());
+   }
+   else
+   {
+      MFEM_ASSERT(el.GetMapType() == FiniteElement::H_CURL, "");
+      Mult(ref_vshape, Trans.InverseJacobian(), vshape);
+   }
+}
+
 void VectorFEMassIntegrator::AssembleElementMatrix(
    const FiniteElement &el,
    ElementTransformation &Trans,
@@ -1746,13 +1879,20 @@ void VectorFEMassIntegrator::AssembleElementMatrix(
       ir = &IntRules.Get(el.GetGeomType(), order);
    }
 
+   // the reference vector shape functions at all points, tabulated once per
+   // element type
+   DofToQuad nurbs_maps;
+   const DofToQuad &maps = el.GetDofToQuad(*ir, nurbs_maps);
+   DenseMatrix ref_vshape;
+
    for (int i = 0; i < ir->GetNPoints(); i++)
    {
       const IntegrationPoint &ip = ir->IntPoint(i);
 
       Trans.SetIntPoint (&ip);
 
-      el.CalcVShape(Trans, trial_vshape);
+      maps.GetB(i, ref_vshape);
+      MapVectorShape(el, ref_vshape, Trans, trial_vshape);
 
       w = ip.weight * Trans.Weight();
       if (MQ)
@@ -2262,6 +2402,10 @@ void DGTraceIntegrator::AssembleFaceMatrix(const FiniteElement &el1,
 
    double un, a, b, w;
 
+#ifdef MFEM_THREAD_SAFE
+   Vector shape1, shape2;
+#endif
+
    dim = el1.GetDim();
    ndof1 = el1.GetDof();
    Vector vu(dim), nor(dim);
@@ -2395,6 +2539,11 @@ void DGDiffusionIntegrator::AssembleFaceMatrix(
    bool kappa_is_nonzero = (kappa != 0.);
    double w, wq = 0.0;
 
+#ifdef MFEM_THREAD_SAFE
+   Vector shape1, shape2, dshape1dn, dshape2dn, nor, nh, ni;
+   DenseMatrix jmat, dshape1, dshape2, mq, adjJ;
+#endif
+
    dim = el1.GetDim();
    ndof1 = el1.GetDof();
 
@@ -18,6 +18,8 @@
 namespace mfem
 {
 
+class FiniteElementSpace;
+
 /// Abstract base class BilinearFormIntegrator
 class BilinearFormIntegrator : public NonlinearFormIntegrator
 {
@@ -76,6 +78,52 @@ public:
                                     Vector &flux, Vector *d_energy = NULL)
    { return 0.0; }
 
+   /** @brief Prepare the integrator for partial assembly on the given space.
+
+       This method precomputes and stores the quadrature-point data needed by
+       AddMultPA() for all elements of @a fes. */
+   virtual void AssemblePA(const FiniteElementSpace &fes);
+
+   /** @brief Add the action of the partially assembled integrator to @a y.
+
+       The vectors @a x and @a y are E-vectors with lexicographically ordered
+       element dofs, see class ElementRestriction. */
+   virtual void AddMultPA(const Vector &x, Vector &y) const;
+
+   /// Add the transpose action of the partially assembled integrator to @a y.
+   virtual void AddMultTransposePA(const Vector &x, Vector &y) const;
+
+   /** @brief Add the diagonal of the partially assembled integrator to the
+       E-vector @a diag, e.g. for Jacobi-type smoothers. */
+   virtual void AssembleDiagonalPA(Vector &diag) const;
+
+   /** @brief Prepare the face integrator for partial assembly on the interior
+       faces of @a fes.
+
+       After this call, AddMultPA() and AddMultTransposePA() add the action of
+       the integrator summed over all interior faces, using the same E-vectors
+       as the domain integrators. */
+   virtual void AssemblePAInteriorFaces(const FiniteElementSpace &fes);
+
+   /** @brief Prepare the face integrator for partial assembly on the boundary
+       faces of @a fes whose attributes are marked in @a bdr_marker, or on all
+       boundary faces if @a bdr_marker is NULL. */
+   virtual void AssemblePABoundaryFaces(const FiniteElementSpace &fes,
+                                        const Array<int> *bdr_marker);
+
+   /** @brief Compute the element matrices of the elements of @a fes with
+       indices in [@a e_begin, @a e_end) and store them in @a elmats(e), or
+       add them to @a elmats(e) when @a add is true.
+
+       All elements in the range must have the same number of dofs, matching
+       the size of @a elmats. The default implementation calls
+       AssembleElementMatrix() for each element, in parallel when OpenMP is
+       enabled. Integrators may override it with kernels that process blocks
+       of elements at once. */
+   virtual void AssembleElementMatrices(FiniteElementSpace &fes, int e_begin,
+                                        int e_end, DenseTensor &elmats,
+                                        bool add = false);
+
    void SetIntRule(const IntegrationRule *ir) { IntRule = ir; }
 
    virtual ~BilinearFormIntegrator() { }
@@ -108,6 +156,25 @@ public:
                                    FaceElementTransformations &Trans,
                                    DenseMatrix &elmat);
 
+   virtual void AssemblePA(const FiniteElementSpace &fes)
+   { bfi->AssemblePA(fes); }
+
+   virtual void AssemblePAInteriorFaces(const FiniteElementSpace &fes)
+   { bfi->AssemblePAInteriorFaces(fes); }
+
+   virtual void AssemblePABoundaryFaces(const FiniteElementSpace &fes,
+                                        const Array<int> *bdr_marker)
+   { bfi->AssemblePABoundaryFaces(fes, bdr_marker); }
+
+   virtual void AddMultPA(const Vector &x, Vector &y) const
+   { bfi->AddMultTransposePA(x, y); }
+
+   virtual void AddMultTransposePA(const Vector &x, Vector &y) const
+   { bfi->AddMultPA(x, y); }
+
+   virtual void AssembleDiagonalPA(Vector &diag) const
+   { bfi->AssembleDiagonalPA(diag); }
+
    virtual ~TransposeIntegrator() { if (own_bfi) { delete bfi; } }
 };
 
@@ -1577,14 +1644,23 @@ protected:
 class DiffusionIntegrator: public BilinearFormIntegrator
 {
 private:
-   Vector vec, pointflux, shape;
 #ifndef MFEM_THREAD_SAFE
+   Vector vec, pointflux, shape;
    DenseMatrix dshape, dshapedxt, invdfdx, mq;
    DenseMatrix te_dshape, te_dshapedxt;
+   // physical gradients at all points, unweighted and weighted
+   DenseMatrix grad, gradw;
 #endif
    Coefficient *Q;
    MatrixCoefficient *MQ;
 
+   // Partial assembly data: the symmetric matrices Q w adj(J) adj(J)^t / det(J)
+   // at all quadrature points, and the 1D basis values/derivatives at the 1D
+   // quadrature points.
+   int pa_dim, pa_ne, pa_dofs1D, pa_quad1D;
+   DenseMatrix pa_B, pa_G;
+   Vector pa_data;
+
 public:
    /// Construct a diffusion integrator with coefficient Q = 1
    DiffusionIntegrator() { Q = NULL; MQ = NULL; }
@@ -1620,6 +1696,24 @@ public:
    virtual double ComputeFluxEnergy(const FiniteElement &fluxelem,
                                     ElementTransformation &Trans,
                                     Vector &flux, Vector *d_energy = NULL);
+
+   /** @brief Partial assembly for tensor-product (quadrilateral and
+       hexahedral) elements with a scalar coefficient. */
+   virtual void AssemblePA(const FiniteElementSpace &fes);
+
+   virtual void AddMultPA(const Vector &x, Vector &y) const;
+
+   virtual void AddMultTransposePA(const Vector &x, Vector &y) const
+   { AddMultPA(x, y); }
+
+   virtual void AssembleDiagonalPA(Vector &diag) const;
+
+   /** @brief Batched computation of the element matrices, for meshes with
+       one element type and a scalar coefficient. The element matrices of a
+       block of elements are computed with one matrix-matrix product. */
+   virtual void AssembleElementMatrices(FiniteElementSpace &fes, int e_begin,
+                                        int e_end, DenseTensor &elmats,
+                                        bool add = false);
 };
 
 /** Class for local mass matrix assembling a(u,v) := (Q u, v) */
@@ -1628,9 +1722,17 @@ class MassIntegrator: public BilinearFormIntegrator
 protected:
 #ifndef MFEM_THREAD_SAFE
    Vector shape, te_shape;
+   // shape function values at all points, scaled by the weights
+   DenseMatrix Bw;
 #endif
    Coefficient *Q;
 
+   // Partial assembly data: Q w det(J) at all quadrature points, and the 1D
+   // basis values at the 1D quadrature points.
+   int pa_dim, pa_ne, pa_dofs1D, pa_quad1D;
+   DenseMatrix pa_B;
+   Vector pa_data;
+
 public:
    MassIntegrator(const IntegrationRule *ir = NULL)
       : BilinearFormIntegrator(ir) { Q = NULL; }
@@ -1647,6 +1749,24 @@ public:
                                        const FiniteElement &test_fe,
                                        ElementTransformation &Trans,
                                        DenseMatrix &elmat);
+
+   /** @brief Partial assembly for tensor-product (quadrilateral and
+       hexahedral) elements. */
+   virtual void AssemblePA(const FiniteElementSpace &fes);
+
+   virtual void AddMultPA(const Vector &x, Vector &y) const;
+
+   virtual void AddMultTransposePA(const Vector &x, Vector &y) const
+   { AddMultPA(x, y); }
+
+   virtual void AssembleDiagonalPA(Vector &diag) const;
+
+   /** @brief Batched computation of the element matrices, for meshes with
+       one element type. The element matrices of a block of elements are
+       computed with one matrix-matrix product. */
+   virtual void AssembleElementMatrices(FiniteElementSpace &fes, int e_begin,
+                                        int e_end, DenseTensor &elmats,
+                                        bool add = false);
 };
 
 class BoundaryMassIntegrator : public MassIntegrator
@@ -1673,12 +1793,26 @@ private:
    VectorCoefficient &Q;
    double alpha;
 
+   // Partial assembly data: the vectors alpha w adj(J) Q at all quadrature
+   // points, and the 1D basis values/derivatives at the 1D quadrature points.
+   int pa_dim, pa_ne, pa_dofs1D, pa_quad1D;
+   DenseMatrix pa_B, pa_G;
+   Vector pa_data;
+
 public:
    ConvectionIntegrator(VectorCoefficient &q, double a = 1.0)
       : Q(q) { alpha = a; }
    virtual void AssembleElementMatrix(const FiniteElement &,
                                       ElementTransformation &,
                                       DenseMatrix &);
+
+   /** @brief Partial assembly for tensor-product (quadrilateral and
+       hexahedral) elements. */
+   virtual void AssemblePA(const FiniteElementSpace &fes);
+
+   virtual void AddMultPA(const Vector &x, Vector &y) const;
+
+   virtual void AddMultTransposePA(const Vector &x, Vector &y) const;
 };
 
 /// alpha (q . grad u, v) using the "group" FE discretization
@@ -1842,8 +1976,8 @@ public:
 class CurlCurlIntegrator: public BilinearFormIntegrator
 {
 private:
-   Vector vec, pointflux;
 #ifndef MFEM_THREAD_SAFE
+   Vector vec, pointflux;
    DenseMatrix curlshape, curlshape_dFt, M;
    DenseMatrix vshape, projcurl;
 #endif
@@ -2033,6 +2167,77 @@ public:
                                       DenseMatrix &);
 };
 
+/** @brief Maps from the element dofs of a tensor-product FE space to the
+    quadrature points of a set of (interior or boundary) faces, used by the
+    partial assembly of the face integrators.
+
+    The values, or the reference derivatives, of the element functions at the
+    points of a face are computed by sum factorization: the lexicographically
+    ordered element dofs are contracted in the direction normal to the face
+    with the 1D basis at the end point of the reference interval, and then in
+    the tangential directions with the 1D basis at the 1D quadrature points.
+    The results are mapped to the points of the face integration rule with a
+    precomputed permutation which accounts for the relative orientation of the
+    face and the element. Only conforming meshes are supported. */
+class PAFaceMaps
+{
+protected:
+   Mesh *mesh;
+   const FiniteElement *fe;
+   int dim, dofs1D, quad1D, nq;
+   bool interior;
+   /// The faces, or the boundary elements of the boundary faces.
+   Array<int> faces;
+   /// The elements on the two sides of each face, -1 if there is none.
+   Array<int> elem;
+   /// The face of the reference element on each side: 2*axis + (0 or 1).
+   Array<int> ref_face;
+   /// Maps the face points to the tangential 1D points, on each side.
+   Array<int> perm;
+   DenseMatrix B, G;          // 1D basis at the 1D quadrature points
+   DenseMatrix B_end, G_end;  // 1D basis at the end points 0 and 1
+   const IntegrationRule *IntRule, *IntRule1D;
+   mutable Vector work;
+
+public:
+   PAFaceMaps() : mesh(NULL), fe(NULL), dim(0), dofs1D(0), quad1D(0), nq(0),
+      interior(true), IntRule(NULL), IntRule1D(NULL) { }
+
+   /** @brief Collect the interior faces of @a fes if @a interior_faces is
+       true, or otherwise the boundary faces with attributes marked in
+       @a bdr_marker (all if NULL). Returns the first element of @a fes. */
+   const FiniteElement &Init(const FiniteElementSpace &fes,
+                             bool interior_faces,
+                             const Array<int> *bdr_marker);
+
+   /// Set the integration rule on the faces from its @a order.
+   void SetIntRule(int order);
+
+   const IntegrationRule &GetIntRule() const { return *IntRule; }
+
+   int GetDim() const { return dim; }
+
+   int GetNFaces() const { return faces.Size(); }
+
+   /// Return the element on the given @a side (0 or 1) of face @a k, or -1.
+   int GetElement(int k, int side) const { return elem[2*k + side]; }
+
+   /// Return the transformations of face @a k, see Mesh.
+   FaceElementTransformations *GetFaceTransformations(int k) const;
+
+   /// Compute the maps for face @a k, given its transformations.
+   void SetFace(int k, FaceElementTransformations &Tr);
+
+   /** @brief Compute the values (if @a deriv < 0) or the reference
+       derivatives in direction @a deriv of the E-vector @a x at the points of
+       face @a k, on the given @a side. */
+   void Eval(int k, int side, int deriv, const Vector &x, Vector &vals) const;
+
+   /// Add the transpose of Eval() applied to @a vals to the E-vector @a y.
+   void AddEvalTranspose(int k, int side, int deriv, const Vector &vals,
+                         Vector &y) const;
+};
+
 /** Integrator for the DG form:
     alpha < rho_u (u.n) {v},[w] > + beta < rho_u |u.n| [v],[w] >,
     where v and w are the trial and test variables, respectively, and rho/u are
@@ -2048,7 +2253,18 @@ private:
    VectorCoefficient *u;
    double alpha, beta;
 
+#ifndef MFEM_THREAD_SAFE
    Vector shape1, shape2;
+#endif
+
+   // Partial assembly data: the weights of the two blocks of the face matrix,
+   // w (a+b) and w (b-a), at all face quadrature points.
+   PAFaceMaps pa_faces;
+   Vector pa_data;
+
+   void AssemblePAFaces(const FiniteElementSpace &fes, bool interior_faces,
+                        const Array<int> *bdr_marker);
+   void AddMultPAFaces(const Vector &x, Vector &y, bool transpose) const;
 
 public:
    /// Construct integrator with rho = 1.
@@ -2064,6 +2280,21 @@ public:
                                    const FiniteElement &el2,
                                    FaceElementTransformations &Trans,
                                    DenseMatrix &elmat);
+
+   /** @brief Partial assembly on the faces of tensor-product (quadrilateral
+       and hexahedral) elements of conforming meshes. */
+   virtual void AssemblePAInteriorFaces(const FiniteElementSpace &fes)
+   { AssemblePAFaces(fes, true, NULL); }
+
+   virtual void AssemblePABoundaryFaces(const FiniteElementSpace &fes,
+                                        const Array<int> *bdr_marker)
+   { AssemblePAFaces(fes, false, bdr_marker); }
+
+   virtual void AddMultPA(const Vector &x, Vector &y) const
+   { AddMultPAFaces(x, y, false); }
+
+   virtual void AddMultTransposePA(const Vector &x, Vector &y) const
+   { AddMultPAFaces(x, y, true); }
 };
 
 /** Integrator for the DG form:
@@ -2085,9 +2316,19 @@ protected:
    MatrixCoefficient *MQ;
    double sigma, kappa;
 
-   // these are not thread-safe!
+#ifndef MFEM_THREAD_SAFE
    Vector shape1, shape2, dshape1dn, dshape2dn, nor, nh, ni;
    DenseMatrix jmat, dshape1, dshape2, mq, adjJ;
+#endif
+
+   // Partial assembly data: the vectors adj(J) Q^t n w on the two sides and
+   // the penalty weight kappa {h^{-1} Q} w, at all face quadrature points.
+   PAFaceMaps pa_faces;
+   Vector pa_data;
+
+   void AssemblePAFaces(const FiniteElementSpace &fes, bool interior_faces,
+                        const Array<int> *bdr_marker);
+   void AddMultPAFaces(const Vector &x, Vector &y, bool transpose) const;
 
 public:
    DGDiffusionIntegrator(const double s, const double k)
@@ -2101,6 +2342,21 @@ public:
                                    const FiniteElement &el2,
                                    FaceElementTransformations &Trans,
                                    DenseMatrix &elmat);
+
+   /** @brief Partial assembly on the faces of tensor-product (quadrilateral
+       and hexahedral) elements of conforming meshes. */
+   virtual void AssemblePAInteriorFaces(const FiniteElementSpace &fes)
+   { AssemblePAFaces(fes, true, NULL); }
+
+   virtual void AssemblePABoundaryFaces(const FiniteElementSpace &fes,
+                                        const Array<int> *bdr_marker)
+   { AssemblePAFaces(fes, false, bdr_marker); }
+
+   virtual void AddMultPA(const Vector &x, Vector &y) const
+   { AddMultPAFaces(x, y, false); }
+
+   virtual void AddMultTransposePA(const Vector &x, Vector &y) const
+   { AddMultPAFaces(x, y, true); }
 };
 
 /** Integrator for the DG elasticity form, for the formulations see:
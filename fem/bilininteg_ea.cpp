@@ -0,0 +1,268 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Batched computation of the element matrices of the Bilinear Form Integrators
+// for blocks of elements with the same finite element.
+
+#include "fem.hpp"
+#include "../linalg/tlayout.hpp"
+#include "../linalg/tmatrix.hpp"
+#include <algorithm>
+
+namespace mfem
+{
+
+// Check if the batched kernels can be used for the elements [e_begin,e_end) of
+// 'fes': all elements of the mesh must have the same geometry (the geometric
+// factors are computed for all elements) and the elements in the range must
+// share the same finite element. NURBS spaces and meshes are excluded: their
+// elements and transformations use a shared NURBSFiniteElement.
+static bool UseBatchedKernels(FiniteElementSpace &fes, int e_begin,
+                              int e_end, const DenseTensor &elmats)
+{
+   if (e_begin >= e_end || fes.GetNURBSext() || fes.GetMesh()->NURBSext ||
+       fes.GetVDim() != 1)
+   {
+      return false;
+   }
+   const Mesh *mesh = fes.GetMesh();
+   const FiniteElement *el = fes.GetFE(e_begin);
+   if (mesh->Dimension() != mesh->SpaceDimension() ||
+       elmats.SizeI() != el->GetDof() || elmats.SizeJ() != el->GetDof())
+   {
+      return false;
+   }
+   const int geom = el->GetGeomType();
+   for (int e = 0; e < mesh->GetNE(); e++)
+   {
+      if (mesh->GetElementBaseGeometry(e) != geom) { return false; }
+   }
+   for (int e = e_begin + 1; e < e_end; e++)
+   {
+      if (fes.GetFE(e) != el) { return false; }
+   }
+   return true;
+}
+
+// Number of elements processed together: the element matrices of a block are
+// computed with one matrix product with about 256 columns.
+static inline int GetBatchSize(int nd)
+{
+   return std::max(1, 256/nd);
+}
+
+void MassIntegrator::AssembleElementMatrices(
+   FiniteElementSpace &fes, int e_begin, int e_end, DenseTensor &elmats,
+   bool add)
+{
+   if (!UseBatchedKernels(fes, e_begin, e_end, elmats))
+   {
+      BilinearFormIntegrator::AssembleElementMatrices(fes, e_begin, e_end,
+                                                      elmats, add);
+      return;
+   }
+
+   Mesh *mesh = fes.GetMesh();
+   const FiniteElement &el = *fes.GetFE(e_begin);
+   const IntegrationRule *ir = IntRule;
+   if (ir == NULL)
+   {
+      // same rule as in AssembleElementMatrix()
+      const int order =
+         2*el.GetOrder() + fes.GetElementTransformation(e_begin)->OrderW();
+      if (el.Space() == FunctionSpace::rQk)
+      {
+         ir = &RefinedIntRules.Get(el.GetGeomType(), order);
+      }
+      else
+      {
+         ir = &IntRules.Get(el.GetGeomType(), order);
+      }
+   }
+
+   const int nd = el.GetDof();
+   const int nq = ir->GetNPoints();
+   const int nb = GetBatchSize(nd);
+   const DofToQuad &maps = el.GetDofToQuad(*ir);
+   // the factors are used only here, so they are not cached in the mesh
+   const GeometricFactors geom(mesh, *ir, GeometricFactors::DETERMINANTS);
+   const double *detJ = geom.detJ.GetData();
+
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel
+#endif
+   {
+      IsoparametricTransformation T;
+      DenseMatrix W, C;
+#ifdef MFEM_USE_OPENMP
+      #pragma omp for
+#endif
+      for (int b = e_begin; b < e_end; b += nb)
+      {
+         const int ne = std::min(nb, e_end - b);
+
+         // W = [B diag(w_b) | ... | B diag(w_(b+ne-1))]^t, so that the element
+         // matrices of the block, stored side by side, are B W
+         W.SetSize(nq, nd*ne);
+         for (int e = b; e < b + ne; e++)
+         {
+            if (Q) { fes.GetElementTransformation(e, &T); }
+            double *We = W.Data() + nq*nd*(e - b);
+            for (int q = 0; q < nq; q++)
+            {
+               const IntegrationPoint &ip = ir->IntPoint(q);
+               double w = ip.weight * detJ[q + nq*e];
+               if (Q)
+               {
+                  T.SetIntPoint(&ip);
+                  w *= Q->Eval(T, ip);
+               }
+               for (int j = 0; j < nd; j++)
+               {
+                  We[q + nq*j] = w * maps.B(j,q);
+               }
+            }
+         }
+
+         C.UseExternalData(elmats.GetData(b), nd, nd*ne);
+         if (add) { AddMult(maps.B, W, C); }
+         else { Mult(maps.B, W, C); }
+         C.ClearExternalData();
+      }
+   }
+}
+
+// Compute the (nq*D) x (nd*ne) matrix W with the products of the reference
+// gradients with the matrices Q w adj(J) adj(J)^t / det(J) at the points, for
+// the elements [b,b+ne); the element matrices of the block are then G W.
+template <int D>
+static void DiffusionBatchWeights(FiniteElementSpace &fes,
+                                  const IntegrationRule &ir,
+                                  const DofToQuad &maps, const double *detJ,
+                                  const double *adjJ, Coefficient *Q,
+                                  IsoparametricTransformation &T,
+                                  int b, int ne, DenseMatrix &W)
+{
+   const int nd = maps.ndof;
+   const int nq = maps.nqpt;
+   double A[D*D], Aw[D*D], Dq[D*D];
+
+   W.SetSize(nq*D, nd*ne);
+   for (int e = b; e < b + ne; e++)
+   {
+      if (Q) { fes.GetElementTransformation(e, &T); }
+      double *We = W.Data() + nq*D*nd*(e - b);
+      for (int q = 0; q < nq; q++)
+      {
+         const IntegrationPoint &ip = ir.IntPoint(q);
+         double w = ip.weight / detJ[q + nq*e];
+         if (Q)
+         {
+            T.SetIntPoint(&ip);
+            w *= Q->Eval(T, ip);
+         }
+         for (int k = 0; k < D*D; k++)
+         {
+            A[k] = adjJ[q + nq*(k + D*D*e)];
+            Aw[k] = w * A[k];
+         }
+         // Dq = w adj(J) adj(J)^t
+         Mult_AB<false>(ColumnMajorLayout2D<D,D>(), Aw,
+                        StridedLayout2D<D,D,D,1>(), A,
+                        ColumnMajorLayout2D<D,D>(), Dq);
+
+         const double *Gq = maps.G.Data() + nd*D*q;
+         for (int j = 0; j < nd; j++)
+         {
+            for (int i = 0; i < D; i++)
+            {
+               double s = 0.0;
+               for (int k = 0; k < D; k++)
+               {
+                  s += Gq[j + nd*k] * Dq[k + D*i];
+               }
+               We[q*D + i + nq*D*j] = s;
+            }
+         }
+      }
+   }
+}
+
+void DiffusionIntegrator::AssembleElementMatrices(
+   FiniteElementSpace &fes, int e_begin, int e_end, DenseTensor &elmats,
+   bool add)
+{
+   if (MQ || !UseBatchedKernels(fes, e_begin, e_end, elmats))
+   {
+      BilinearFormIntegrator::AssembleElementMatrices(fes, e_begin, e_end,
+                                                      elmats, add);
+      return;
+   }
+
+   Mesh *mesh = fes.GetMesh();
+   const FiniteElement &el = *fes.GetFE(e_begin);
+   const int dim = el.GetDim();
+   const IntegrationRule *ir = IntRule;
+   if (ir == NULL)
+   {
+      // same rule as in AssembleElementMatrix()
+      const int order = (el.Space() == FunctionSpace::Pk) ?
+                        2*el.GetOrder() - 2 : 2*el.GetOrder() + dim - 1;
+      if (el.Space() == FunctionSpace::rQk)
+      {
+         ir = &RefinedIntRules.Get(el.GetGeomType(), order);
+      }
+      else
+      {
+         ir = &IntRules.Get(el.GetGeomType(), order);
+      }
+   }
+
+   const int nd = el.GetDof();
+   const int nb = GetBatchSize(nd);
+   const DofToQuad &maps = el.GetDofToQuad(*ir);
+   // the factors are used only here, so they are not cached in the mesh
+   const GeometricFactors geom(mesh, *ir, GeometricFactors::DETERMINANTS |
+                               GeometricFactors::ADJUGATES);
+   const double *detJ = geom.detJ.GetData();
+   const double *adjJ = geom.adjJ.GetData();
+
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel
+#endif
+   {
+      IsoparametricTransformation T;
+      DenseMatrix W, C;
+#ifdef MFEM_USE_OPENMP
+      #pragma omp for
+#endif
+      for (int b = e_begin; b < e_end; b += nb)
+      {
+         const int ne = std::min(nb, e_end - b);
+         switch (dim)
+         {
+            case 1: DiffusionBatchWeights<1>(fes, *ir, maps, detJ, adjJ, Q, T,
+                                                b, ne, W); break;
+            case 2: DiffusionBatchWeights<2>(fes, *ir, maps, detJ, adjJ, Q, T,
+                                                b, ne, W); break;
+            case 3: DiffusionBatchWeights<3>(fes, *ir, maps, detJ, adjJ, Q, T,
+                                                b, ne, W); break;
+         }
+
+         C.UseExternalData(elmats.GetData(b), nd, nd*ne);
+         if (add) { AddMult(maps.G, W, C); }
+         else { Mult(maps.G, W, C); }
+         C.ClearExternalData();
+      }
+   }
+}
+
+}
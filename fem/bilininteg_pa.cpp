@@ -0,0 +1,1502 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Partial assembly (matrix-free, sum-factorized) versions of the Bilinear Form
+// Integrators for tensor-product elements.
+
+#include "fem.hpp"
+#include <algorithm>
+
+namespace mfem
+{
+
+// Check that the FE space can be used with partial assembly and return its
+// (first) tensor-product finite element.
+static const FiniteElement &GetPAElement(const FiniteElementSpace &fes)
+{
+   MFEM_VERIFY(fes.GetNE() > 0, "the mesh has no elements");
+   MFEM_VERIFY(fes.GetVDim() == 1, "partial assembly requires a scalar space");
+   const FiniteElement &el = *fes.GetFE(0);
+   MFEM_VERIFY(dynamic_cast<const TensorBasisElement*>(&el) &&
+               (el.GetGeomType() == Geometry::SQUARE ||
+                el.GetGeomType() == Geometry::CUBE),
+               "partial assembly requires quadrilateral or hexahedral "
+               "tensor-product elements");
+   MFEM_VERIFY(fes.GetMesh()->SpaceDimension() == el.GetDim(),
+               "partial assembly of surface meshes is not supported");
+   return el;
+}
+
+// Compute the values (B) and the derivatives (G, if not NULL) of the 1D basis
+// of the tensor-product element 'el' at the points of the 1D rule 'ir1D'. The
+// matrices have dimensions (number of 1D points) x (number of 1D dofs).
+static void GetPATensorMaps(const FiniteElement &el,
+                            const IntegrationRule &ir1D,
+                            DenseMatrix &B, DenseMatrix *G)
+{
+   const Poly_1D::Basis &basis1d =
+      dynamic_cast<const TensorBasisElement&>(el).GetBasis1D();
+   const int dofs1D = el.GetOrder() + 1;
+   const int quad1D = ir1D.GetNPoints();
+   Vector u(dofs1D), d(dofs1D);
+
+   B.SetSize(quad1D, dofs1D);
+   if (G) { G->SetSize(quad1D, dofs1D); }
+   for (int q = 0; q < quad1D; q++)
+   {
+      basis1d.Eval(ir1D.IntPoint(q).x, u, d);
+      for (int i = 0; i < dofs1D; i++)
+      {
+         B(q,i) = u(i);
+         if (G) { (*G)(q,i) = d(i); }
+      }
+   }
+}
+
+// y += B^t D B x on all elements, 2D case.
+static void PAMassApply2D(const int ne, const int D1D, const int Q1D,
+                          const double *B, const double *op,
+                          const double *x, double *y)
+{
+   Vector t_buf(Q1D*D1D), u_buf(Q1D*Q1D), s_buf(D1D*Q1D);
+   double *t = t_buf.GetData(), *u = u_buf.GetData(), *s = s_buf.GetData();
+
+   for (int e = 0; e < ne; e++)
+   {
+      const double *X = x + e*D1D*D1D;
+      const double *O = op + e*Q1D*Q1D;
+      double *Y = y + e*D1D*D1D;
+
+      for (int dy = 0; dy < D1D; dy++)
+         for (int qx = 0; qx < Q1D; qx++)
+         {
+            double r = 0.0;
+            for (int dx = 0; dx < D1D; dx++)
+            {
+               r += B[qx + Q1D*dx] * X[dx + D1D*dy];
+            }
+            t[qx + Q1D*dy] = r;
+         }
+      for (int qy = 0; qy < Q1D; qy++)
+         for (int qx = 0; qx < Q1D; qx++)
+         {
+            double r = 0.0;
+            for (int dy = 0; dy < D1D; dy++)
+            {
+               r += B[qy + Q1D*dy] * t[qx + Q1D*dy];
+            }
+            u[qx + Q1D*qy] = r * O[qx + Q1D*qy];
+         }
+      for (int qy = 0; qy < Q1D; qy++)
+         for (int dx = 0; dx < D1D; dx++)
+         {
+            double r = 0.0;
+            for (int qx = 0; qx < Q1D; qx++)
+            {
+               r += B[qx + Q1D*dx] * u[qx + Q1D*qy];
+            }
+            s[dx + D1D*qy] = r;
+         }
+      for (int dy = 0; dy < D1D; dy++)
+         for (int dx = 0; dx < D1D; dx++)
+         {
+            double r = 0.0;
+            for (int qy = 0; qy < Q1D; qy++)
+            {
+               r += B[qy + Q1D*dy] * s[dx + D1D*qy];
+            }
+            Y[dx + D1D*dy] += r;
+         }
+   }
+}
+
+// y += B^t D B x on all elements, 3D case.
+static void PAMassApply3D(const int ne, const int D1D, const int Q1D,
+                          const double *B, const double *op,
+                          const double *x, double *y)
+{
+   const int M1D = std::max(D1D, Q1D);
+   Vector a_buf(M1D*M1D*M1D), b_buf(M1D*M1D*M1D);
+   double *a = a_buf.GetData(), *b = b_buf.GetData();
+
+   for (int e = 0; e < ne; e++)
+   {
+      const double *X = x + e*D1D*D1D*D1D;
+      const double *O = op + e*Q1D*Q1D*Q1D;
+      double *Y = y + e*D1D*D1D*D1D;
+
+      // a(qx,dy,dz) = sum_dx B(qx,dx) X(dx,dy,dz)
+      for (int dz = 0; dz < D1D; dz++)
+         for (int dy = 0; dy < D1D; dy++)
+            for (int qx = 0; qx < Q1D; qx++)
+            {
+               double r = 0.0;
+               for (int dx = 0; dx < D1D; dx++)
+               {
+                  r += B[qx + Q1D*dx] * X[dx + D1D*(dy + D1D*dz)];
+               }
+               a[qx + Q1D*(dy + D1D*dz)] = r;
+            }
+      // b(qx,qy,dz) = sum_dy B(qy,dy) a(qx,dy,dz)
+      for (int dz = 0; dz < D1D; dz++)
+         for (int qy = 0; qy < Q1D; qy++)
+            for (int qx = 0; qx < Q1D; qx++)
+            {
+               double r = 0.0;
+               for (int dy = 0; dy < D1D; dy++)
+               {
+                  r += B[qy + Q1D*dy] * a[qx + Q1D*(dy + D1D*dz)];
+               }
+               b[qx + Q1D*(qy + Q1D*dz)] = r;
+            }
+      // a(qx,qy,qz) = D(qx,qy,qz) sum_dz B(qz,dz) b(qx,qy,dz)
+      for (int qz = 0; qz < Q1D; qz++)
+         for (int qy = 0; qy < Q1D; qy++)
+            for (int qx = 0; qx < Q1D; qx++)
+            {
+               double r = 0.0;
+               for (int dz = 0; dz < D1D; dz++)
+               {
+                  r += B[qz + Q1D*dz] * b[qx + Q1D*(qy + Q1D*dz)];
+               }
+               const int q = qx + Q1D*(qy + Q1D*qz);
+               a[q] = r * O[q];
+            }
+      // b(qx,qy,dz) = sum_qz B(qz,dz) a(qx,qy,qz)
+      for (int dz = 0; dz < D1D; dz++)
+         for (int qy = 0; qy < Q1D; qy++)
+            for (int qx = 0; qx < Q1D; qx++)
+            {
+               double r = 0.0;
+               for (int qz = 0; qz < Q1D; qz++)
+               {
+                  r += B[qz + Q1D*dz] * a[qx + Q1D*(qy + Q1D*qz)];
+               }
+               b[qx + Q1D*(qy + Q1D*dz)] = r;
+            }
+      // a(qx,dy,dz) = sum_qy B(qy,dy) b(qx,qy,dz)
+      for (int dz = 0; dz < D1D; dz++)
+         for (int dy = 0; dy < D1D; dy++)
+            for (int qx = 0; qx < Q1D; qx++)
+            {
+               double r = 0.0;
+               for (int qy = 0; qy < Q1D; qy++)
+               {
+                  r += B[qy + Q1D*dy] * b[qx + Q1D*(qy + Q1D*dz)];
+               }
+               a[qx + Q1D*(dy + D1D*dz)] = r;
+            }
+      // Y(dx,dy,dz) += sum_qx B(qx,dx) a(qx,dy,dz)
+      for (int dz = 0; dz < D1D; dz++)
+         for (int dy = 0; dy < D1D; dy++)
+            for (int dx = 0; dx < D1D; dx++)
+            {
+               double r = 0.0;
+               for (int qx = 0; qx < Q1D; qx++)
+               {
+                  r += B[qx + Q1D*dx] * a[qx + Q1D*(dy + D1D*dz)];
+               }
+               Y[dx + D1D*(dy + D1D*dz)] += r;
+            }
+   }
+}
+
+// y += G^t D G x on all elements, 2D case. The symmetric 2x2 matrices D are
+// stored as (D00,D01,D11) at each quadrature point.
+static void PADiffusionApply2D(const int ne, const int D1D, const int Q1D,
+                               const double *B, const double *G,
+                               const double *op, const double *x, double *y)
+{
+   const int QD = Q1D*D1D, QQ = Q1D*Q1D;
+   Vector buf(2*QD + 2*QQ);
+   double *tB = buf.GetData(), *tG = tB + QD;
+   double *g0 = tG + QD, *g1 = g0 + QQ;
+
+   for (int e = 0; e < ne; e++)
+   {
+      const double *X = x + e*D1D*D1D;
+      const double *O = op + 3*e*QQ;
+      double *Y = y + e*D1D*D1D;
+
+      for (int dy = 0; dy < D1D; dy++)
+         for (int qx = 0; qx < Q1D; qx++)
+         {
+            double rB = 0.0, rG = 0.0;
+            for (int dx = 0; dx < D1D; dx++)
+            {
+               const double s = X[dx + D1D*dy];
+               rB += B[qx + Q1D*dx] * s;
+               rG += G[qx + Q1D*dx] * s;
+            }
+            tB[qx + Q1D*dy] = rB;
+            tG[qx + Q1D*dy] = rG;
+         }
+      for (int qy = 0; qy < Q1D; qy++)
+         for (int qx = 0; qx < Q1D; qx++)
+         {
+            double r0 = 0.0, r1 = 0.0;
+            for (int dy = 0; dy < D1D; dy++)
+            {
+               r0 += B[qy + Q1D*dy] * tG[qx + Q1D*dy];
+               r1 += G[qy + Q1D*dy] * tB[qx + Q1D*dy];
+            }
+            const int q = qx + Q1D*qy;
+            const double *Oq = O + 3*q;
+            g0[q] = Oq[0]*r0 + Oq[1]*r1;
+            g1[q] = Oq[1]*r0 + Oq[2]*r1;
+         }
+      // tG(dx,qy) = sum_qx G(qx,dx) g0(qx,qy); tB(dx,qy) similarly with g1
+      for (int qy = 0; qy < Q1D; qy++)
+         for (int dx = 0; dx < D1D; dx++)
+         {
+            double r0 = 0.0, r1 = 0.0;
+            for (int qx = 0; qx < Q1D; qx++)
+            {
+               r0 += G[qx + Q1D*dx] * g0[qx + Q1D*qy];
+               r1 += B[qx + Q1D*dx] * g1[qx + Q1D*qy];
+            }
+            tG[dx + D1D*qy] = r0;
+            tB[dx + D1D*qy] = r1;
+         }
+      for (int dy = 0; dy < D1D; dy++)
+         for (int dx = 0; dx < D1D; dx++)
+         {
+            double r = 0.0;
+            for (int qy = 0; qy < Q1D; qy++)
+            {
+               r += B[qy + Q1D*dy] * tG[dx + D1D*qy] +
+                    G[qy + Q1D*dy] * tB[dx + D1D*qy];
+            }
+            Y[dx + D1D*dy] += r;
+         }
+   }
+}
+
+// y += G^t D G x on all elements, 3D case. The symmetric 3x3 matrices D are
+// stored as (D00,D01,D02,D11,D12,D22) at each quadrature point.
+static void PADiffusionApply3D(const int ne, const int D1D, const int Q1D,
+                               const double *B, const double *G,
+                               const double *op, const double *x, double *y)
+{
+   const int M1D = std::max(D1D, Q1D), MMM = M1D*M1D*M1D;
+   const int QQQ = Q1D*Q1D*Q1D;
+   Vector buf(6*MMM);
+   double *t0 = buf.GetData(), *t1 = t0 + MMM, *t2 = t1 + MMM;
+   double *s0 = t2 + MMM, *s1 = s0 + MMM, *s2 = s1 + MMM;
+
+   for (int e = 0; e < ne; e++)
+   {
+      const double *X = x + e*D1D*D1D*D1D;
+      const double *O = op + 6*e*QQQ;
+      double *Y = y + e*D1D*D1D*D1D;
+
+      // Contract in x: t0 = B.X, t1 = G.X, indexed (qx,dy,dz)
+      for (int dz = 0; dz < D1D; dz++)
+         for (int dy = 0; dy < D1D; dy++)
+            for (int qx = 0; qx < Q1D; qx++)
+            {
+               double rB = 0.0, rG = 0.0;
+               for (int dx = 0; dx < D1D; dx++)
+               {
+                  const double s = X[dx + D1D*(dy + D1D*dz)];
+                  rB += B[qx + Q1D*dx] * s;
+                  rG += G[qx + Q1D*dx] * s;
+               }
+               t0[qx + Q1D*(dy + D1D*dz)] = rB;
+               t1[qx + Q1D*(dy + D1D*dz)] = rG;
+            }
+      // Contract in y: s0 = BB, s1 = GB (d/dx), s2 = BG (d/dy), (qx,qy,dz)
+      for (int dz = 0; dz < D1D; dz++)
+         for (int qy = 0; qy < Q1D; qy++)
+            for (int qx = 0; qx < Q1D; qx++)
+            {
+               double rBB = 0.0, rGB = 0.0, rBG = 0.0;
+               for (int dy = 0; dy < D1D; dy++)
+               {
+                  const int i = qx + Q1D*(dy + D1D*dz);
+                  rBB += B[qy + Q1D*dy] * t0[i];
+                  rGB += B[qy + Q1D*dy] * t1[i];
+                  rBG += G[qy + Q1D*dy] * t0[i];
+               }
+               const int j = qx + Q1D*(qy + Q1D*dz);
+               s0[j] = rBB;
+               s1[j] = rGB;
+               s2[j] = rBG;
+            }
+      // Contract in z and apply D at the quadrature points, (qx,qy,qz)
+      for (int qz = 0; qz < Q1D; qz++)
+         for (int qy = 0; qy < Q1D; qy++)
+            for (int qx = 0; qx < Q1D; qx++)
+            {
+               double r0 = 0.0, r1 = 0.0, r2 = 0.0;
+               for (int dz = 0; dz < D1D; dz++)
+               {
+                  const int j = qx + Q1D*(qy + Q1D*dz);
+                  r0 += B[qz + Q1D*dz] * s1[j];
+                  r1 += B[qz + Q1D*dz] * s2[j];
+                  r2 += G[qz + Q1D*dz] * s0[j];
+               }
+               const int q = qx + Q1D*(qy + Q1D*qz);
+               const double *Oq = O + 6*q;
+               t0[q] = Oq[0]*r0 + Oq[1]*r1 + Oq[2]*r2;
+               t1[q] = Oq[1]*r0 + Oq[3]*r1 + Oq[4]*r2;
+               t2[q] = Oq[2]*r0 + Oq[4]*r1 + Oq[5]*r2;
+            }
+      // Transposed contraction in z, (qx,qy,dz)
+      for (int dz = 0; dz < D1D; dz++)
+         for (int qy = 0; qy < Q1D; qy++)
+            for (int qx = 0; qx < Q1D; qx++)
+            {
+               double r0 = 0.0, r1 = 0.0, r2 = 0.0;
+               for (int qz = 0; qz < Q1D; qz++)
+               {
+                  const int q = qx + Q1D*(qy + Q1D*qz);
+                  r0 += B[qz + Q1D*dz] * t0[q];
+                  r1 += B[qz + Q1D*dz] * t1[q];
+                  r2 += G[qz + Q1D*dz] * t2[q];
+               }
+               const int j = qx + Q1D*(qy + Q1D*dz);
+               s0[j] = r0;
+               s1[j] = r1;
+               s2[j] = r2;
+            }
+      // Transposed contraction in y: t0 needs G in x, t1 needs B in x,
+      // indexed (qx,dy,dz)
+      for (int dz = 0; dz < D1D; dz++)
+         for (int dy = 0; dy < D1D; dy++)
+            for (int qx = 0; qx < Q1D; qx++)
+            {
+               double rG = 0.0, rB = 0.0;
+               for (int qy = 0; qy < Q1D; qy++)
+               {
+                  const int j = qx + Q1D*(qy + Q1D*dz);
+                  rG += B[qy + Q1D*dy] * s0[j];
+                  rB += G[qy + Q1D*dy] * s1[j] + B[qy + Q1D*dy] * s2[j];
+               }
+               t0[qx + Q1D*(dy + D1D*dz)] = rG;
+               t1[qx + Q1D*(dy + D1D*dz)] = rB;
+            }
+      // Transposed contraction in x
+      for (int dz = 0; dz < D1D; dz++)
+         for (int dy = 0; dy < D1D; dy++)
+            for (int dx = 0; dx < D1D; dx++)
+            {
+               double r = 0.0;
+               for (int qx = 0; qx < Q1D; qx++)
+               {
+                  const int i = qx + Q1D*(dy + D1D*dz);
+                  r += G[qx + Q1D*dx] * t0[i] + B[qx + Q1D*dx] * t1[i];
+               }
+               Y[dx + D1D*(dy + D1D*dz)] += r;
+            }
+   }
+}
+
+
+// Add the diagonal of sum_c w[c] F_c^t D_c F_c to diag on all elements, where
+// D_c is the c-th of the ncomp components of the quadrature-point data 'op'
+// and F_c is the tensor product of the 1D matrices f[c*dim + k], k < dim,
+// stored as Q1D x D1D arrays. The 1D factors are the squares (or products) of
+// the 1D basis values and derivatives, so that the diagonal is computed with
+// one contraction per dimension.
+static void PAAddDiagonal(const int dim, const int ne, const int D1D,
+                          const int Q1D, const int ncomp,
+                          const double *const *f, const double *w,
+                          const double *op, double *diag)
+{
+   const int M1D = std::max(D1D, Q1D);
+   const int nq = (dim == 2) ? Q1D*Q1D : Q1D*Q1D*Q1D;
+   const int nd = (dim == 2) ? D1D*D1D : D1D*D1D*D1D;
+   Vector a_buf(M1D*M1D*M1D), b_buf(M1D*M1D*M1D);
+   double *a = a_buf.GetData(), *b = b_buf.GetData();
+
+   for (int e = 0; e < ne; e++)
+   {
+      const double *O = op + e*nq*ncomp;
+      double *Y = diag + e*nd;
+      for (int c = 0; c < ncomp; c++)
+      {
+         const double *fx = f[c*dim], *fy = f[c*dim+1];
+         const int NZ = (dim == 2) ? 1 : Q1D;
+         // a(dx,qy,qz) = sum_qx fx(qx,dx) O_c(qx,qy,qz)
+         for (int qz = 0; qz < NZ; qz++)
+            for (int qy = 0; qy < Q1D; qy++)
+               for (int dx = 0; dx < D1D; dx++)
+               {
+                  double r = 0.0;
+                  for (int qx = 0; qx < Q1D; qx++)
+                  {
+                     r += fx[qx + Q1D*dx] *
+                          O[(qx + Q1D*(qy + Q1D*qz))*ncomp + c];
+                  }
+                  a[dx + D1D*(qy + Q1D*qz)] = r;
+               }
+         // b(dx,dy,qz) = sum_qy fy(qy,dy) a(dx,qy,qz)
+         for (int qz = 0; qz < NZ; qz++)
+            for (int dy = 0; dy < D1D; dy++)
+               for (int dx = 0; dx < D1D; dx++)
+               {
+                  double r = 0.0;
+                  for (int qy = 0; qy < Q1D; qy++)
+                  {
+                     r += fy[qy + Q1D*dy] * a[dx + D1D*(qy + Q1D*qz)];
+                  }
+                  b[dx + D1D*(dy + D1D*qz)] = r;
+               }
+         if (dim == 2)
+         {
+            for (int i = 0; i < nd; i++) { Y[i] += w[c]*b[i]; }
+            continue;
+         }
+         const double *fz = f[c*dim+2];
+         for (int dz = 0; dz < D1D; dz++)
+            for (int dy = 0; dy < D1D; dy++)
+               for (int dx = 0; dx < D1D; dx++)
+               {
+                  double r = 0.0;
+                  for (int qz = 0; qz < Q1D; qz++)
+                  {
+                     r += fz[qz + Q1D*dz] * b[dx + D1D*(dy + D1D*qz)];
+                  }
+                  Y[dx + D1D*(dy + D1D*dz)] += w[c]*r;
+               }
+      }
+   }
+}
+
+void MassIntegrator::AssemblePA(const FiniteElementSpace &fes)
+{
+   const FiniteElement &el = GetPAElement(fes);
+   MFEM_VERIFY(IntRule == NULL, "custom integration rules are not supported"
+               " with partial assembly");
+
+   const int geom = el.GetGeomType();
+   ElementTransformation *T = fes.GetElementTransformation(0);
+   const int order = 2*el.GetOrder() + T->OrderW();
+   const IntegrationRule &ir1D = IntRules.Get(Geometry::SEGMENT, order);
+   const IntegrationRule &ir = IntRules.Get(geom, order);
+   const int nq = ir.GetNPoints();
+
+   pa_dim = el.GetDim();
+   pa_ne = fes.GetNE();
+   pa_dofs1D = el.GetOrder() + 1;
+   pa_quad1D = ir1D.GetNPoints();
+   GetPATensorMaps(el, ir1D, pa_B, NULL);
+
+   // the determinants are cached by the mesh and reused on reassembly
+   const GeometricFactors *geom_factors = fes.GetMesh()->GetGeometricFactors(
+                                             ir, GeometricFactors::DETERMINANTS);
+   const double *detJ = geom_factors->detJ.GetData();
+
+   pa_data.SetSize(pa_ne*nq);
+   for (int e = 0; e < pa_ne; e++)
+   {
+      MFEM_VERIFY(fes.GetFE(e)->GetGeomType() == geom,
+                  "partial assembly requires a mesh with one element type");
+      if (Q) { T = fes.GetElementTransformation(e); }
+      for (int q = 0; q < nq; q++)
+      {
+         const IntegrationPoint &ip = ir.IntPoint(q);
+         double w = ip.weight * detJ[e*nq + q];
+         if (Q)
+         {
+            T->SetIntPoint(&ip);
+            w *= Q->Eval(*T, ip);
+         }
+         pa_data(e*nq + q) = w;
+      }
+   }
+}
+
+void MassIntegrator::AddMultPA(const Vector &x, Vector &y) const
+{
+   if (pa_dim == 2)
+   {
+      PAMassApply2D(pa_ne, pa_dofs1D, pa_quad1D, pa_B.Data(),
+                    pa_data.GetData(), x.GetData(), y.GetData());
+   }
+   else
+   {
+      PAMassApply3D(pa_ne, pa_dofs1D, pa_quad1D, pa_B.Data(),
+                    pa_data.GetData(), x.GetData(), y.GetData());
+   }
+}
+
+void MassIntegrator::AssembleDiagonalPA(Vector &diag) const
+{
+   const int n = pa_quad1D*pa_dofs1D;
+   Vector BB(n);
+   for (int i = 0; i < n; i++) { BB(i) = pa_B.Data()[i]*pa_B.Data()[i]; }
+   const double *f[3] = { BB.GetData(), BB.GetData(), BB.GetData() };
+   const double w = 1.0;
+   PAAddDiagonal(pa_dim, pa_ne, pa_dofs1D, pa_quad1D, 1, f, &w,
+                 pa_data.GetData(), diag.GetData());
+}
+
+void DiffusionIntegrator::AssemblePA(const FiniteElementSpace &fes)
+{
+   const FiniteElement &el = GetPAElement(fes);
+   MFEM_VERIFY(IntRule == NULL, "custom integration rules are not supported"
+               " with partial assembly");
+   MFEM_VERIFY(MQ == NULL, "matrix coefficients are not supported with"
+               " partial assembly");
+
+   const int geom = el.GetGeomType();
+   const int dim = el.GetDim();
+   const int order = 2*el.GetOrder() + dim - 1;
+   const IntegrationRule &ir1D = IntRules.Get(Geometry::SEGMENT, order);
+   const IntegrationRule &ir = IntRules.Get(geom, order);
+   const int nq = ir.GetNPoints();
+   const int nsym = (dim*(dim + 1))/2;
+
+   pa_dim = dim;
+   pa_ne = fes.GetNE();
+   pa_dofs1D = el.GetOrder() + 1;
+   pa_quad1D = ir1D.GetNPoints();
+   GetPATensorMaps(el, ir1D, pa_B, &pa_G);
+
+   // the geometric factors are cached by the mesh and reused on reassembly
+   const GeometricFactors *geom_factors = fes.GetMesh()->GetGeometricFactors(
+                                             ir, GeometricFactors::DETERMINANTS |
+                                             GeometricFactors::ADJUGATES);
+   const double *detJ = geom_factors->detJ.GetData();
+   const double *adjJ = geom_factors->adjJ.GetData();
+   const int sdim = fes.GetMesh()->SpaceDimension();
+
+   pa_data.SetSize(pa_ne*nq*nsym);
+   for (int e = 0; e < pa_ne; e++)
+   {
+      MFEM_VERIFY(fes.GetFE(e)->GetGeomType() == geom,
+                  "partial assembly requires a mesh with one element type");
+      ElementTransformation *T = Q ? fes.GetElementTransformation(e) : NULL;
+      // adj(J) for the points of element e, stored as nq x dim x sdim
+      const double *adj = adjJ + e*nq*dim*sdim;
+      for (int q = 0; q < nq; q++)
+      {
+         const IntegrationPoint &ip = ir.IntPoint(q);
+         // D = Q w adj(J) adj(J)^t / det(J)
+         double w = ip.weight / detJ[e*nq + q];
+         if (Q)
+         {
+            T->SetIntPoint(&ip);
+            w *= Q->Eval(*T, ip);
+         }
+         double *D = pa_data.GetData() + (e*nq + q)*nsym;
+         for (int i = 0, s = 0; i < dim; i++)
+         {
+            for (int j = i; j < dim; j++, s++)
+            {
+               double d = 0.0;
+               for (int k = 0; k < sdim; k++)
+               {
+                  d += adj[q + nq*(i + dim*k)] * adj[q + nq*(j + dim*k)];
+               }
+               D[s] = w * d;
+            }
+         }
+      }
+   }
+}
+
+void DiffusionIntegrator::AddMultPA(const Vector &x, Vector &y) const
+{
+   if (pa_dim == 2)
+   {
+      PADiffusionApply2D(pa_ne, pa_dofs1D, pa_quad1D, pa_B.Data(),
+                         pa_G.Data(), pa_data.GetData(), x.GetData(),
+                         y.GetData());
+   }
+   else
+   {
+      PADiffusionApply3D(pa_ne, pa_dofs1D, pa_quad1D, pa_B.Data(),
+                         pa_G.Data(), pa_data.GetData(), x.GetData(),
+                         y.GetData());
+   }
+}
+
+void DiffusionIntegrator::AssembleDiagonalPA(Vector &diag) const
+{
+   const int n = pa_quad1D*pa_dofs1D;
+   const double *B = pa_B.Data(), *G = pa_G.Data();
+   Vector buf(3*n);
+   double *BB = buf.GetData(), *BG = BB + n, *GG = BG + n;
+   for (int i = 0; i < n; i++)
+   {
+      BB[i] = B[i]*B[i];
+      BG[i] = B[i]*G[i];
+      GG[i] = G[i]*G[i];
+   }
+   // The components of the gradient of the basis function (dx,dy[,dz]) are
+   // (G B [B], B G [B], [B B G]); the 1D factors of the terms D_ij of the
+   // symmetric matrices are listed below in the order of the stored entries.
+   if (pa_dim == 2)
+   {
+      const double *f[6] = { GG, BB,  BG, BG,  BB, GG };
+      const double w[3] = { 1.0, 2.0, 1.0 };
+      PAAddDiagonal(2, pa_ne, pa_dofs1D, pa_quad1D, 3, f, w,
+                    pa_data.GetData(), diag.GetData());
+   }
+   else
+   {
+      const double *f[18] = { GG, BB, BB,  BG, BG, BB,  BG, BB, BG,
+                              BB, GG, BB,  BB, BG, BG,  BB, BB, GG
+                            };
+      const double w[6] = { 1.0, 2.0, 2.0, 1.0, 2.0, 1.0 };
+      PAAddDiagonal(3, pa_ne, pa_dofs1D, pa_quad1D, 6, f, w,
+                    pa_data.GetData(), diag.GetData());
+   }
+}
+
+// y += B^t (c . G x) on all elements (or y += G^t (c B x) if transpose), 2D
+// case. The vectors c are stored as (c0,c1) at each quadrature point.
+static void PAConvectionApply2D(const int ne, const int D1D, const int Q1D,
+                                const double *B, const double *G,
+                                const double *op, const double *x, double *y,
+                                const bool transpose)
+{
+   const int QD = Q1D*D1D, QQ = Q1D*Q1D;
+   Vector buf(2*QD + 2*QQ);
+   double *tB = buf.GetData(), *tG = tB + QD;
+   double *g0 = tG + QD, *g1 = g0 + QQ;
+
+   for (int e = 0; e < ne; e++)
+   {
+      const double *X = x + e*D1D*D1D;
+      const double *O = op + 2*e*QQ;
+      double *Y = y + e*D1D*D1D;
+
+      for (int dy = 0; dy < D1D; dy++)
+         for (int qx = 0; qx < Q1D; qx++)
+         {
+            double rB = 0.0, rG = 0.0;
+            for (int dx = 0; dx < D1D; dx++)
+            {
+               const double s = X[dx + D1D*dy];
+               rB += B[qx + Q1D*dx] * s;
+               rG += G[qx + Q1D*dx] * s;
+            }
+            tB[qx + Q1D*dy] = rB;
+            tG[qx + Q1D*dy] = rG;
+         }
+      for (int qy = 0; qy < Q1D; qy++)
+         for (int qx = 0; qx < Q1D; qx++)
+         {
+            const int q = qx + Q1D*qy;
+            const double *Oq = O + 2*q;
+            if (!transpose)
+            {
+               double r0 = 0.0, r1 = 0.0;
+               for (int dy = 0; dy < D1D; dy++)
+               {
+                  r0 += B[qy + Q1D*dy] * tG[qx + Q1D*dy];
+                  r1 += G[qy + Q1D*dy] * tB[qx + Q1D*dy];
+               }
+               g0[q] = Oq[0]*r0 + Oq[1]*r1;
+            }
+            else
+            {
+               double r = 0.0;
+               for (int dy = 0; dy < D1D; dy++)
+               {
+                  r += B[qy + Q1D*dy] * tB[qx + Q1D*dy];
+               }
+               g0[q] = Oq[0]*r;
+               g1[q] = Oq[1]*r;
+            }
+         }
+      if (!transpose)
+      {
+         // y = B^t B^t g0
+         for (int qy = 0; qy < Q1D; qy++)
+            for (int dx = 0; dx < D1D; dx++)
+            {
+               double r = 0.0;
+               for (int qx = 0; qx < Q1D; qx++)
+               {
+                  r += B[qx + Q1D*dx] * g0[qx + Q1D*qy];
+               }
+               tB[dx + D1D*qy] = r;
+            }
+         for (int dy = 0; dy < D1D; dy++)
+            for (int dx = 0; dx < D1D; dx++)
+            {
+               double r = 0.0;
+               for (int qy = 0; qy < Q1D; qy++)
+               {
+                  r += B[qy + Q1D*dy] * tB[dx + D1D*qy];
+               }
+               Y[dx + D1D*dy] += r;
+            }
+         continue;
+      }
+      // y = (B^t G^t) g0 + (G^t B^t) g1
+      for (int qy = 0; qy < Q1D; qy++)
+         for (int dx = 0; dx < D1D; dx++)
+         {
+            double r0 = 0.0, r1 = 0.0;
+            for (int qx = 0; qx < Q1D; qx++)
+            {
+               r0 += G[qx + Q1D*dx] * g0[qx + Q1D*qy];
+               r1 += B[qx + Q1D*dx] * g1[qx + Q1D*qy];
+            }
+            tG[dx + D1D*qy] = r0;
+            tB[dx + D1D*qy] = r1;
+         }
+      for (int dy = 0; dy < D1D; dy++)
+         for (int dx = 0; dx < D1D; dx++)
+         {
+            double r = 0.0;
+            for (int qy = 0; qy < Q1D; qy++)
+            {
+               r += B[qy + Q1D*dy] * tG[dx + D1D*qy] +
+                    G[qy + Q1D*dy] * tB[dx + D1D*qy];
+            }
+            Y[dx + D1D*dy] += r;
+         }
+   }
+}
+
+// y += B^t (c . G x) on all elements (or y += G^t (c B x) if transpose), 3D
+// case. The vectors c are stored as (c0,c1,c2) at each quadrature point.
+static void PAConvectionApply3D(const int ne, const int D1D, const int Q1D,
+                                const double *B, const double *G,
+                                const double *op, const double *x, double *y,
+                                const bool transpose)
+{
+   const int M1D = std::max(D1D, Q1D), MMM = M1D*M1D*M1D;
+   const int QQQ = Q1D*Q1D*Q1D;
+   Vector buf(6*MMM);
+   double *t0 = buf.GetData(), *t1 = t0 + MMM, *t2 = t1 + MMM;
+   double *s0 = t2 + MMM, *s1 = s0 + MMM, *s2 = s1 + MMM;
+
+   for (int e = 0; e < ne; e++)
+   {
+      const double *X = x + e*D1D*D1D*D1D;
+      const double *O = op + 3*e*QQQ;
+      double *Y = y + e*D1D*D1D*D1D;
+
+      // Contract in x: t0 = B.X, t1 = G.X, indexed (qx,dy,dz)
+      for (int dz = 0; dz < D1D; dz++)
+         for (int dy = 0; dy < D1D; dy++)
+            for (int qx = 0; qx < Q1D; qx++)
+            {
+               double rB = 0.0, rG = 0.0;
+               for (int dx = 0; dx < D1D; dx++)
+               {
+                  const double s = X[dx + D1D*(dy + D1D*dz)];
+                  rB += B[qx + Q1D*dx] * s;
+                  rG += G[qx + Q1D*dx] * s;
+               }
+               t0[qx + Q1D*(dy + D1D*dz)] = rB;
+               t1[qx + Q1D*(dy + D1D*dz)] = rG;
+            }
+      // Contract in y: s0 = BB, s1 = GB (d/dx), s2 = BG (d/dy), (qx,qy,dz)
+      for (int dz = 0; dz < D1D; dz++)
+         for (int qy = 0; qy < Q1D; qy++)
+            for (int qx = 0; qx < Q1D; qx++)
+            {
+               double rBB = 0.0, rGB = 0.0, rBG = 0.0;
+               for (int dy = 0; dy < D1D; dy++)
+               {
+                  const int i = qx + Q1D*(dy + D1D*dz);
+                  rBB += B[qy + Q1D*dy] * t0[i];
+                  rGB += B[qy + Q1D*dy] * t1[i];
+                  rBG += G[qy + Q1D*dy] * t0[i];
+               }
+               const int j = qx + Q1D*(qy + Q1D*dz);
+               s0[j] = rBB;
+               s1[j] = rGB;
+               s2[j] = rBG;
+            }
+      // Contract in z and apply c at the quadrature points, (qx,qy,qz)
+      for (int qz = 0; qz < Q1D; qz++)
+         for (int qy = 0; qy < Q1D; qy++)
+            for (int qx = 0; qx < Q1D; qx++)
+            {
+               const int q = qx + Q1D*(qy + Q1D*qz);
+               const double *Oq = O + 3*q;
+               if (!transpose)
+               {
+                  double r0 = 0.0, r1 = 0.0, r2 = 0.0;
+                  for (int dz = 0; dz < D1D; dz++)
+                  {
+                     const int j = qx + Q1D*(qy + Q1D*dz);
+                     r0 += B[qz + Q1D*dz] * s1[j];
+                     r1 += B[qz + Q1D*dz] * s2[j];
+                     r2 += G[qz + Q1D*dz] * s0[j];
+                  }
+                  t0[q] = Oq[0]*r0 + Oq[1]*r1 + Oq[2]*r2;
+               }
+               else
+               {
+                  double r = 0.0;
+                  for (int dz = 0; dz < D1D; dz++)
+                  {
+                     r += B[qz + Q1D*dz] * s0[qx + Q1D*(qy + Q1D*dz)];
+                  }
+                  t0[q] = Oq[0]*r;
+                  t1[q] = Oq[1]*r;
+                  t2[q] = Oq[2]*r;
+               }
+            }
+      if (!transpose)
+      {
+         // y = B^t B^t B^t t0
+         for (int dz = 0; dz < D1D; dz++)
+            for (int qy = 0; qy < Q1D; qy++)
+               for (int qx = 0; qx < Q1D; qx++)
+               {
+                  double r = 0.0;
+                  for (int qz = 0; qz < Q1D; qz++)
+                  {
+                     r += B[qz + Q1D*dz] * t0[qx + Q1D*(qy + Q1D*qz)];
+                  }
+                  s0[qx + Q1D*(qy + Q1D*dz)] = r;
+               }
+         for (int dz = 0; dz < D1D; dz++)
+            for (int dy = 0; dy < D1D; dy++)
+               for (int qx = 0; qx < Q1D; qx++)
+               {
+                  double r = 0.0;
+                  for (int qy = 0; qy < Q1D; qy++)
+                  {
+                     r += B[qy + Q1D*dy] * s0[qx + Q1D*(qy + Q1D*dz)];
+                  }
+                  t1[qx + Q1D*(dy + D1D*dz)] = r;
+               }
+         for (int dz = 0; dz < D1D; dz++)
+            for (int dy = 0; dy < D1D; dy++)
+               for (int dx = 0; dx < D1D; dx++)
+               {
+                  double r = 0.0;
+                  for (int qx = 0; qx < Q1D; qx++)
+                  {
+                     r += B[qx + Q1D*dx] * t1[qx + Q1D*(dy + D1D*dz)];
+                  }
+                  Y[dx + D1D*(dy + D1D*dz)] += r;
+               }
+         continue;
+      }
+      // Transposed contraction in z, (qx,qy,dz)
+      for (int dz = 0; dz < D1D; dz++)
+         for (int qy = 0; qy < Q1D; qy++)
+            for (int qx = 0; qx < Q1D; qx++)
+            {
+               double r0 = 0.0, r1 = 0.0, r2 = 0.0;
+               for (int qz = 0; qz < Q1D; qz++)
+               {
+                  const int q = qx + Q1D*(qy + Q1D*qz);
+                  r0 += B[qz + Q1D*dz] * t0[q];
+                  r1 += B[qz + Q1D*dz] * t1[q];
+                  r2 += G[qz + Q1D*dz] * t2[q];
+               }
+               const int j = qx + Q1D*(qy + Q1D*dz);
+               s0[j] = r0;
+               s1[j] = r1;
+               s2[j] = r2;
+            }
+      // Transposed contraction in y, (qx,dy,dz)
+      for (int dz = 0; dz < D1D; dz++)
+         for (int dy = 0; dy < D1D; dy++)
+            for (int qx = 0; qx < Q1D; qx++)
+            {
+               double rG = 0.0, rB = 0.0;
+               for (int qy = 0; qy < Q1D; qy++)
+               {
+                  const int j = qx + Q1D*(qy + Q1D*dz);
+                  rG += B[qy + Q1D*dy] * s0[j];
+                  rB += G[qy + Q1D*dy] * s1[j] + B[qy + Q1D*dy] * s2[j];
+               }
+               t0[qx + Q1D*(dy + D1D*dz)] = rG;
+               t1[qx + Q1D*(dy + D1D*dz)] = rB;
+            }
+      // Transposed contraction in x
+      for (int dz = 0; dz < D1D; dz++)
+         for (int dy = 0; dy < D1D; dy++)
+            for (int dx = 0; dx < D1D; dx++)
+            {
+               double r = 0.0;
+               for (int qx = 0; qx < Q1D; qx++)
+               {
+                  const int i = qx + Q1D*(dy + D1D*dz);
+                  r += G[qx + Q1D*dx] * t0[i] + B[qx + Q1D*dx] * t1[i];
+               }
+               Y[dx + D1D*(dy + D1D*dz)] += r;
+            }
+   }
+}
+
+void ConvectionIntegrator::AssemblePA(const FiniteElementSpace &fes)
+{
+   const FiniteElement &el = GetPAElement(fes);
+   MFEM_VERIFY(IntRule == NULL, "custom integration rules are not supported"
+               " with partial assembly");
+
+   const int geom = el.GetGeomType();
+   const int dim = el.GetDim();
+   ElementTransformation *T = fes.GetElementTransformation(0);
+   const int order = T->OrderGrad(&el) + T->Order() + el.GetOrder();
+   const IntegrationRule &ir1D = IntRules.Get(Geometry::SEGMENT, order);
+   const IntegrationRule &ir = IntRules.Get(geom, order);
+   const int nq = ir.GetNPoints();
+
+   pa_dim = dim;
+   pa_ne = fes.GetNE();
+   pa_dofs1D = el.GetOrder() + 1;
+   pa_quad1D = ir1D.GetNPoints();
+   GetPATensorMaps(el, ir1D, pa_B, &pa_G);
+
+   const GeometricFactors *geom_factors = fes.GetMesh()->GetGeometricFactors(
+                                             ir, GeometricFactors::ADJUGATES);
+   const double *adjJ = geom_factors->adjJ.GetData();
+   const int sdim = fes.GetMesh()->SpaceDimension();
+   Vector vq(sdim);
+
+   pa_data.SetSize(pa_ne*nq*dim);
+   for (int e = 0; e < pa_ne; e++)
+   {
+      MFEM_VERIFY(fes.GetFE(e)->GetGeomType() == geom,
+                  "partial assembly requires a mesh with one element type");
+      T = fes.GetElementTransformation(e);
+      const double *adj = adjJ + e*nq*dim*sdim;
+      for (int q = 0; q < nq; q++)
+      {
+         const IntegrationPoint &ip = ir.IntPoint(q);
+         T->SetIntPoint(&ip);
+         Q.Eval(vq, *T, ip);
+         // c = alpha w adj(J) Q
+         double *c = pa_data.GetData() + (e*nq + q)*dim;
+         for (int i = 0; i < dim; i++)
+         {
+            double d = 0.0;
+            for (int k = 0; k < sdim; k++)
+            {
+               d += adj[q + nq*(i + dim*k)] * vq(k);
+            }
+            c[i] = alpha * ip.weight * d;
+         }
+      }
+   }
+}
+
+void ConvectionIntegrator::AddMultPA(const Vector &x, Vector &y) const
+{
+   if (pa_dim == 2)
+   {
+      PAConvectionApply2D(pa_ne, pa_dofs1D, pa_quad1D, pa_B.Data(),
+                          pa_G.Data(), pa_data.GetData(), x.GetData(),
+                          y.GetData(), false);
+   }
+   else
+   {
+      PAConvectionApply3D(pa_ne, pa_dofs1D, pa_quad1D, pa_B.Data(),
+                          pa_G.Data(), pa_data.GetData(), x.GetData(),
+                          y.GetData(), false);
+   }
+}
+
+void ConvectionIntegrator::AddMultTransposePA(const Vector &x,
+                                              Vector &y) const
+{
+   if (pa_dim == 2)
+   {
+      PAConvectionApply2D(pa_ne, pa_dofs1D, pa_quad1D, pa_B.Data(),
+                          pa_G.Data(), pa_data.GetData(), x.GetData(),
+                          y.GetData(), true);
+   }
+   else
+   {
+      PAConvectionApply3D(pa_ne, pa_dofs1D, pa_quad1D, pa_B.Data(),
+                          pa_G.Data(), pa_data.GetData(), x.GetData(),
+                          y.GetData(), true);
+   }
+}
+
+
+const FiniteElement &PAFaceMaps::Init(const FiniteElementSpace &fes,
+                                      bool interior_faces,
+                                      const Array<int> *bdr_marker)
+{
+   const FiniteElement &el = GetPAElement(fes);
+   fe = &el;
+   mesh = fes.GetMesh();
+   MFEM_VERIFY(!mesh->Nonconforming(), "partial assembly of the face"
+               " integrators requires a conforming mesh");
+
+   dim = el.GetDim();
+   dofs1D = el.GetOrder() + 1;
+   interior = interior_faces;
+   faces.SetSize(0);
+   if (interior)
+   {
+      for (int f = 0; f < mesh->GetNumFaces(); f++)
+      {
+         if (mesh->FaceIsInterior(f)) { faces.Append(f); }
+      }
+   }
+   else
+   {
+      // Same selection as in BilinearForm::Assemble(): boundary elements with
+      // a marked attribute whose face is not interior.
+      for (int i = 0; i < mesh->GetNBE(); i++)
+      {
+         const int attr = mesh->GetBdrAttribute(i);
+         if (bdr_marker && (*bdr_marker)[attr-1] == 0) { continue; }
+         if (mesh->FaceIsInterior(mesh->GetBdrElementEdgeIndex(i)))
+         {
+            continue;
+         }
+         faces.Append(i);
+      }
+   }
+
+   const int nf = faces.Size();
+   elem.SetSize(2*nf);
+   for (int k = 0; k < nf; k++)
+   {
+      const int f = interior ? faces[k] :
+                    mesh->GetBdrElementEdgeIndex(faces[k]);
+      mesh->GetFaceElements(f, &elem[2*k], &elem[2*k+1]);
+      if (!interior) { elem[2*k+1] = -1; }
+   }
+   ref_face.SetSize(2*nf);
+   ref_face = -1;
+
+   const Poly_1D::Basis &basis1d =
+      dynamic_cast<const TensorBasisElement&>(el).GetBasis1D();
+   Vector u(dofs1D), d(dofs1D);
+   B_end.SetSize(dofs1D, 2);
+   G_end.SetSize(dofs1D, 2);
+   for (int end = 0; end < 2; end++)
+   {
+      basis1d.Eval(double(end), u, d);
+      for (int i = 0; i < dofs1D; i++)
+      {
+         B_end(i,end) = u(i);
+         G_end(i,end) = d(i);
+      }
+   }
+   return el;
+}
+
+void PAFaceMaps::SetIntRule(int order)
+{
+   IntRule1D = &IntRules.Get(Geometry::SEGMENT, order);
+   IntRule = &IntRules.Get(dim == 2 ? Geometry::SEGMENT : Geometry::SQUARE,
+                           order);
+   quad1D = IntRule1D->GetNPoints();
+   nq = IntRule->GetNPoints();
+   MFEM_VERIFY(nq == (dim == 2 ? quad1D : quad1D*quad1D),
+               "the face integration rule is not a tensor-product rule");
+   GetPATensorMaps(*fe, *IntRule1D, B, &G);
+   perm.SetSize(2*faces.Size()*nq);
+   work.SetSize(dofs1D*dofs1D + 2*quad1D*dofs1D + quad1D*quad1D);
+}
+
+FaceElementTransformations *PAFaceMaps::GetFaceTransformations(int k) const
+{
+   return interior ? mesh->GetInteriorFaceTransformations(faces[k]) :
+          mesh->GetBdrFaceTransformations(faces[k]);
+}
+
+void PAFaceMaps::SetFace(int k, FaceElementTransformations &Tr)
+{
+   MFEM_ASSERT(Tr.Elem1No == elem[2*k], "invalid face transformations");
+   IntegrationPoint eip;
+   for (int side = 0; side < 2; side++)
+   {
+      if (elem[2*k+side] < 0) { continue; }
+      IntegrationPointTransformation &Loc = side ? Tr.Loc2 : Tr.Loc1;
+      int *P = perm.GetData() + (2*k + side)*nq;
+      int axis = 0;
+      for (int q = 0; q < nq; q++)
+      {
+         Loc.Transform(IntRule->IntPoint(q), eip);
+         const double c[3] = { eip.x, eip.y, eip.z };
+         if (q == 0)
+         {
+            // The normal axis is the one along which the point is on the
+            // boundary of the reference element.
+            double dist = 2.0;
+            for (int i = 0; i < dim; i++)
+            {
+               const double di = std::min(fabs(c[i]), fabs(1.0 - c[i]));
+               if (di < dist) { dist = di; axis = i; }
+            }
+            ref_face[2*k+side] = 2*axis + (c[axis] > 0.5 ? 1 : 0);
+         }
+         // Find the 1D points matching the tangential coordinates.
+         int idx = 0, stride = 1;
+         for (int i = 0; i < dim; i++)
+         {
+            if (i == axis) { continue; }
+            int jmin = 0;
+            double dmin = 2.0;
+            for (int j = 0; j < quad1D; j++)
+            {
+               const double dj = fabs(c[i] - IntRule1D->IntPoint(j).x);
+               if (dj < dmin) { dmin = dj; jmin = j; }
+            }
+            MFEM_VERIFY(dmin < 1e-8, "the face points do not match the 1D"
+                        " quadrature points");
+            idx += stride*jmin;
+            stride *= quad1D;
+         }
+         P[q] = idx;
+      }
+   }
+}
+
+void PAFaceMaps::Eval(int k, int side, int deriv, const Vector &x,
+                      Vector &vals) const
+{
+   const int D = dofs1D, Q = quad1D, s = 2*k + side;
+   const int a = ref_face[s]/2, end = ref_face[s]%2;
+   // the tangential axes, in increasing order (t1 is unused in 2D)
+   const int t0 = (a == 0) ? 1 : 0, t1 = (a == 2) ? 1 : 2;
+   const int stride[3] = { 1, D, D*D };
+   const int sa = stride[a], s0 = stride[t0], s1 = (dim == 3) ? stride[t1] : 0;
+   const int n1 = (dim == 3) ? D : 1;
+   const double *E = (deriv == a) ? &G_end(0,end) : &B_end(0,end);
+   const double *M0 = (deriv == t0) ? G.Data() : B.Data();
+   const double *M1 = (deriv == t1) ? G.Data() : B.Data();
+   const double *X = x.GetData() + elem[s]*D*stride[dim-1];
+   const int *P = perm.GetData() + s*nq;
+   double *u = work.GetData(), *w = u + D*D, *v = w + Q*D;
+
+   // u(j0,j1) = sum_i E(i) X(i,j0,j1), in the normal direction
+   for (int j1 = 0; j1 < n1; j1++)
+      for (int j0 = 0; j0 < D; j0++)
+      {
+         const double *Xj = X + j0*s0 + j1*s1;
+         double r = 0.0;
+         for (int i = 0; i < D; i++)
+         {
+            r += E[i] * Xj[i*sa];
+         }
+         u[j0 + D*j1] = r;
+      }
+   // w(q0,j1) = sum_j0 M0(q0,j0) u(j0,j1)
+   for (int j1 = 0; j1 < n1; j1++)
+      for (int q0 = 0; q0 < Q; q0++)
+      {
+         double r = 0.0;
+         for (int j0 = 0; j0 < D; j0++)
+         {
+            r += M0[q0 + Q*j0] * u[j0 + D*j1];
+         }
+         w[q0 + Q*j1] = r;
+      }
+   // v(q0,q1) = sum_j1 M1(q1,j1) w(q0,j1)
+   if (dim == 3)
+   {
+      for (int q1 = 0; q1 < Q; q1++)
+         for (int q0 = 0; q0 < Q; q0++)
+         {
+            double r = 0.0;
+            for (int j1 = 0; j1 < D; j1++)
+            {
+               r += M1[q1 + Q*j1] * w[q0 + Q*j1];
+            }
+            v[q0 + Q*q1] = r;
+         }
+   }
+   else
+   {
+      v = w;
+   }
+   vals.SetSize(nq);
+   for (int q = 0; q < nq; q++)
+   {
+      vals(q) = v[P[q]];
+   }
+}
+
+void PAFaceMaps::AddEvalTranspose(int k, int side, int deriv,
+                                  const Vector &vals, Vector &y) const
+{
+   const int D = dofs1D, Q = quad1D, s = 2*k + side;
+   const int a = ref_face[s]/2, end = ref_face[s]%2;
+   const int t0 = (a == 0) ? 1 : 0, t1 = (a == 2) ? 1 : 2;
+   const int stride[3] = { 1, D, D*D };
+   const int sa = stride[a], s0 = stride[t0], s1 = (dim == 3) ? stride[t1] : 0;
+   const int n1 = (dim == 3) ? D : 1;
+   const double *E = (deriv == a) ? &G_end(0,end) : &B_end(0,end);
+   const double *M0 = (deriv == t0) ? G.Data() : B.Data();
+   const double *M1 = (deriv == t1) ? G.Data() : B.Data();
+   double *Y = y.GetData() + elem[s]*D*stride[dim-1];
+   const int *P = perm.GetData() + s*nq;
+   double *u = work.GetData(), *w = u + D*D, *v = w + Q*D;
+
+   if (dim == 2) { v = w; }
+   for (int q = 0; q < nq; q++)
+   {
+      v[P[q]] = vals(q);
+   }
+   // w(q0,j1) = sum_q1 M1(q1,j1) v(q0,q1)
+   if (dim == 3)
+   {
+      for (int j1 = 0; j1 < D; j1++)
+         for (int q0 = 0; q0 < Q; q0++)
+         {
+            double r = 0.0;
+            for (int q1 = 0; q1 < Q; q1++)
+            {
+               r += M1[q1 + Q*j1] * v[q0 + Q*q1];
+            }
+            w[q0 + Q*j1] = r;
+         }
+   }
+   // u(j0,j1) = sum_q0 M0(q0,j0) w(q0,j1)
+   for (int j1 = 0; j1 < n1; j1++)
+      for (int j0 = 0; j0 < D; j0++)
+      {
+         double r = 0.0;
+         for (int q0 = 0; q0 < Q; q0++)
+         {
+            r += M0[q0 + Q*j0] * w[q0 + Q*j1];
+         }
+         u[j0 + D*j1] = r;
+      }
+   // Y(i,j0,j1) += E(i) u(j0,j1)
+   for (int j1 = 0; j1 < n1; j1++)
+      for (int j0 = 0; j0 < D; j0++)
+      {
+         double *Yj = Y + j0*s0 + j1*s1;
+         const double r = u[j0 + D*j1];
+         for (int i = 0; i < D; i++)
+         {
+            Yj[i*sa] += E[i] * r;
+         }
+      }
+}
+
+void DGTraceIntegrator::AssemblePAFaces(const FiniteElementSpace &fes,
+                                        bool interior_faces,
+                                        const Array<int> *bdr_marker)
+{
+   MFEM_VERIFY(IntRule == NULL, "custom integration rules are not supported"
+               " with partial assembly");
+   const FiniteElement &el = pa_faces.Init(fes, interior_faces, bdr_marker);
+   const int dim = el.GetDim();
+   // Assuming order(u)==order(mesh), as in AssembleFaceMatrix()
+   const int order = fes.GetElementTransformation(0)->OrderW() +
+                     2*el.GetOrder();
+   pa_faces.SetIntRule(order);
+
+   const IntegrationRule &ir = pa_faces.GetIntRule();
+   const int nf = pa_faces.GetNFaces(), nq = ir.GetNPoints();
+   Vector vu(dim), nor(dim);
+   IntegrationPoint eip1, eip2;
+
+   pa_data.SetSize(2*nf*nq);
+   for (int k = 0; k < nf; k++)
+   {
+      FaceElementTransformations &Tr = *pa_faces.GetFaceTransformations(k);
+      pa_faces.SetFace(k, Tr);
+      double *w = pa_data.GetData() + 2*k*nq;
+      for (int p = 0; p < nq; p++)
+      {
+         const IntegrationPoint &ip = ir.IntPoint(p);
+         Tr.Loc1.Transform(ip, eip1);
+         Tr.Face->SetIntPoint(&ip);
+         Tr.Elem1->SetIntPoint(&eip1);
+         u->Eval(vu, *Tr.Elem1, eip1);
+         CalcOrtho(Tr.Face->Jacobian(), nor);
+
+         const double un = vu * nor;
+         double a = 0.5 * alpha * un, b = beta * fabs(un);
+         if (rho)
+         {
+            double rho_p;
+            if (un >= 0.0 && Tr.Elem2No >= 0)
+            {
+               Tr.Loc2.Transform(ip, eip2);
+               Tr.Elem2->SetIntPoint(&eip2);
+               rho_p = rho->Eval(*Tr.Elem2, eip2);
+            }
+            else
+            {
+               rho_p = rho->Eval(*Tr.Elem1, eip1);
+            }
+            a *= rho_p;
+            b *= rho_p;
+         }
+         w[p] = ip.weight * (a + b);
+         w[nq + p] = ip.weight * (b - a);
+      }
+   }
+}
+
+void DGTraceIntegrator::AddMultPAFaces(const Vector &x, Vector &y,
+                                       bool transpose) const
+{
+   const int nf = pa_faces.GetNFaces();
+   if (nf == 0) { return; }
+   const int nq = pa_faces.GetIntRule().GetNPoints();
+   Vector u1(nq), u2(nq), f1(nq), f2(nq);
+
+   // The face matrix is [ w1 s1 s1^t, -w2 s1 s2^t ; -w1 s2 s1^t, w2 s2 s2^t ]
+   // where s1, s2 are the traces of the two elements.
+   for (int k = 0; k < nf; k++)
+   {
+      const double *w1 = pa_data.GetData() + 2*k*nq, *w2 = w1 + nq;
+      pa_faces.Eval(k, 0, -1, x, u1);
+      if (pa_faces.GetElement(k, 1) < 0)
+      {
+         for (int p = 0; p < nq; p++) { f1(p) = w1[p] * u1(p); }
+         pa_faces.AddEvalTranspose(k, 0, -1, f1, y);
+         continue;
+      }
+      pa_faces.Eval(k, 1, -1, x, u2);
+      for (int p = 0; p < nq; p++)
+      {
+         if (!transpose)
+         {
+            f1(p) = w1[p] * u1(p) - w2[p] * u2(p);
+            f2(p) = -f1(p);
+         }
+         else
+         {
+            f1(p) = w1[p] * (u1(p) - u2(p));
+            f2(p) = w2[p] * (u2(p) - u1(p));
+         }
+      }
+      pa_faces.AddEvalTranspose(k, 0, -1, f1, y);
+      pa_faces.AddEvalTranspose(k, 1, -1, f2, y);
+   }
+}
+
+void DGDiffusionIntegrator::AssemblePAFaces(const FiniteElementSpace &fes,
+                                            bool interior_faces,
+                                            const Array<int> *bdr_marker)
+{
+   MFEM_VERIFY(IntRule == NULL, "custom integration rules are not supported"
+               " with partial assembly");
+   const FiniteElement &el = pa_faces.Init(fes, interior_faces, bdr_marker);
+   const int dim = el.GetDim();
+   pa_faces.SetIntRule(2*el.GetOrder());
+
+#ifdef MFEM_THREAD_SAFE
+   Vector nor, nh, ni;
+   DenseMatrix mq, adjJ;
+#endif
+   nor.SetSize(dim);
+   nh.SetSize(dim);
+   ni.SetSize(dim);
+   adjJ.SetSize(dim);
+   if (MQ) { mq.SetSize(dim); }
+
+   const IntegrationRule &ir = pa_faces.GetIntRule();
+   const int nf = pa_faces.GetNFaces(), nq = ir.GetNPoints();
+   const int stride = 2*dim + 1;
+   IntegrationPoint eip[2];
+
+   // at each point: adj(J1) ni1, adj(J2) ni2 (zero on the boundary), and
+   // kappa (ni1 + ni2).n, see AssembleFaceMatrix()
+   pa_data.SetSize(nf*nq*stride);
+   pa_data = 0.0;
+   for (int k = 0; k < nf; k++)
+   {
+      FaceElementTransformations &Tr = *pa_faces.GetFaceTransformations(k);
+      pa_faces.SetFace(k, Tr);
+      const int nsides = (Tr.Elem2No >= 0) ? 2 : 1;
+      for (int p = 0; p < nq; p++)
+      {
+         const IntegrationPoint &ip = ir.IntPoint(p);
+         double *d = pa_data.GetData() + (k*nq + p)*stride;
+         Tr.Face->SetIntPoint(&ip);
+         CalcOrtho(Tr.Face->Jacobian(), nor);
+         double wq = 0.0;
+         for (int side = 0; side < nsides; side++)
+         {
+            ElementTransformation &T = side ? *Tr.Elem2 : *Tr.Elem1;
+            (side ? Tr.Loc2 : Tr.Loc1).Transform(ip, eip[side]);
+            T.SetIntPoint(&eip[side]);
+            double w = ip.weight/T.Weight();
+            if (nsides == 2) { w /= 2; }
+            if (!MQ)
+            {
+               if (Q) { w *= Q->Eval(T, eip[side]); }
+               ni.Set(w, nor);
+            }
+            else
+            {
+               nh.Set(w, nor);
+               MQ->Eval(mq, T, eip[side]);
+               mq.MultTranspose(nh, ni);
+            }
+            CalcAdjugate(T.Jacobian(), adjJ);
+            adjJ.Mult(ni, nh);
+            for (int i = 0; i < dim; i++) { d[side*dim + i] = nh(i); }
+            wq += ni * nor;
+         }
+         d[2*dim] = kappa * wq;
+      }
+   }
+}
+
+void DGDiffusionIntegrator::AddMultPAFaces(const Vector &x, Vector &y,
+                                           bool transpose) const
+{
+   const int nf = pa_faces.GetNFaces();
+   if (nf == 0) { return; }
+   const int dim = pa_faces.GetDim(), stride = 2*dim + 1;
+   const int nq = pa_faces.GetIntRule().GetNPoints();
+   // The face matrix is -A + sigma A^t + kappa J, where A = s dn^t and
+   // J = s s^t in terms of the jumps of the traces, s, and the sums of the
+   // normal fluxes, dn, of the two elements.
+   const double c_flux = transpose ? sigma : -1.0;
+   const double c_jump = transpose ? -1.0 : sigma;
+   Vector u(nq), g(nq), flux(nq), jump(nq), f(nq), c(nq);
+
+   for (int k = 0; k < nf; k++)
+   {
+      const double *d = pa_data.GetData() + k*nq*stride;
+      const int nsides = (pa_faces.GetElement(k, 1) >= 0) ? 2 : 1;
+      flux = 0.0;
+      jump = 0.0;
+      for (int side = 0; side < nsides; side++)
+      {
+         pa_faces.Eval(k, side, -1, x, u);
+         if (side == 0) { jump = u; }
+         else { jump -= u; }
+         for (int i = 0; i < dim; i++)
+         {
+            pa_faces.Eval(k, side, i, x, g);
+            for (int p = 0; p < nq; p++)
+            {
+               flux(p) += d[p*stride + side*dim + i] * g(p);
+            }
+         }
+      }
+      for (int p = 0; p < nq; p++)
+      {
+         f(p) = c_flux * flux(p) + d[p*stride + 2*dim] * jump(p);
+         c(p) = c_jump * jump(p);
+      }
+      for (int side = 0; side < nsides; side++)
+      {
+         if (side == 1) { f.Neg(); }
+         pa_faces.AddEvalTranspose(k, side, -1, f, y);
+         for (int i = 0; i < dim; i++)
+         {
+            for (int p = 0; p < nq; p++)
+            {
+               g(p) = d[p*stride + side*dim + i] * c(p);
+            }
+            pa_faces.AddEvalTranspose(k, side, i, g, y);
+         }
+      }
+   }
+}
+
+}
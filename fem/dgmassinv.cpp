@@ -0,0 +1,199 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementation of class DGMassInverse
+
+#include "fem.hpp"
+#include <cmath>
+
+namespace mfem
+{
+
+DGMassInverse::DGMassInverse(FiniteElementSpace &f, Coefficient *q, Type t)
+   : Operator(f.GetVSize()), fes(&f), Q(q), type(t)
+{
+   Update();
+}
+
+void DGMassInverse::Update()
+{
+   height = width = fes->GetVSize();
+   const Table &elem_dof = fes->GetElementToDofTable();
+   MFEM_VERIFY(elem_dof.Size_of_connections() == fes->GetNDofs(),
+               "the dofs of the space must not be shared between elements");
+   for (int e = 1; e < fes->GetNE(); e++)
+   {
+      MFEM_VERIFY(elem_dof.RowSize(e) == elem_dof.RowSize(0),
+                  "all elements must have the same number of dofs");
+   }
+
+   if (type == BLOCK) { ComputeBlocks(); }
+   else { ComputeCollocated(); }
+}
+
+void DGMassInverse::ComputeBlocks()
+{
+   const int ne = fes->GetNE();
+   const int nd = (ne > 0) ? fes->GetFE(0)->GetDof() : 0;
+   inv_blocks.SetSize(nd, nd, ne);
+   if (ne == 0) { return; }
+
+   // The element mass matrices of the scalar space, computed in batches, see
+   // MassIntegrator::AssembleElementMatrices().
+   MassIntegrator *mass = Q ? new MassIntegrator(*Q) : new MassIntegrator;
+   if (fes->GetVDim() == 1)
+   {
+      mass->AssembleElementMatrices(*fes, 0, ne, inv_blocks);
+   }
+   else
+   {
+      FiniteElementSpace scalar_fes(fes->GetMesh(), fes->FEColl());
+      mass->AssembleElementMatrices(scalar_fes, 0, ne, inv_blocks);
+   }
+   delete mass;
+
+   // Invert the matrices in place.
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel
+#endif
+   {
+      DenseMatrixInverse inv;
+#ifdef MFEM_USE_OPENMP
+      #pragma omp for
+#endif
+      for (int e = 0; e < ne; e++)
+      {
+         DenseMatrix M(inv_blocks.GetData(e), nd, nd);
+         inv.Factor(M);
+         inv.GetInverseMatrix(M);
+      }
+   }
+}
+
+void DGMassInverse::ComputeCollocated()
+{
+   const int ne = fes->GetNE();
+   inv_diag.SetSize(fes->GetNDofs());
+   if (ne == 0) { return; }
+
+   // The quadrature weights at the nodes of the basis: the nodes must be
+   // tensor products of the points of the 1D Gauss-Legendre rule.
+   const FiniteElement &el = *fes->GetFE(0);
+   const int geom = el.GetGeomType(), dim = el.GetDim(), nd = el.GetDof();
+   MFEM_VERIFY(geom == Geometry::SEGMENT || geom == Geometry::SQUARE ||
+               geom == Geometry::CUBE, "collocation requires segment,"
+               " quadrilateral or hexahedral elements");
+   const IntegrationRule &ir1D = IntRules.Get(Geometry::SEGMENT,
+                                              2*el.GetOrder() + 1);
+   MFEM_VERIFY(ir1D.GetNPoints() == el.GetOrder() + 1,
+               "unexpected number of Gauss-Legendre points");
+   const IntegrationRule &nodes = el.GetNodes();
+   Vector node_weights(nd);
+   for (int i = 0; i < nd; i++)
+   {
+      const IntegrationPoint &ip = nodes.IntPoint(i);
+      const double c[3] = { ip.x, ip.y, ip.z };
+      double w = 1.0;
+      for (int d = 0; d < dim; d++)
+      {
+         int j = 0;
+         while (j < ir1D.GetNPoints() &&
+                std::fabs(ir1D.IntPoint(j).x - c[d]) > 1e-12) { j++; }
+         MFEM_VERIFY(j < ir1D.GetNPoints(), "collocation requires the"
+                     " Gauss-Legendre basis, see BasisType::GaussLegendre");
+         w *= ir1D.IntPoint(j).weight;
+      }
+      node_weights(i) = w;
+   }
+
+   // GetFE() and GetElementTransformation() on NURBS spaces or meshes modify
+   // a shared NURBSFiniteElement
+   const bool nurbs = fes->GetNURBSext() || fes->GetMesh()->NURBSext;
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel if (!nurbs)
+#endif
+   {
+      IsoparametricTransformation T;
+      Array<int> dofs;
+#ifdef MFEM_USE_OPENMP
+      #pragma omp for
+#endif
+      for (int e = 0; e < ne; e++)
+      {
+         MFEM_VERIFY(fes->GetFE(e)->GetGeomType() == geom,
+                     "all elements must have the same type");
+         fes->GetElementTransformation(e, &T);
+         fes->GetElementDofs(e, dofs);
+         for (int i = 0; i < nd; i++)
+         {
+            const IntegrationPoint &ip = nodes.IntPoint(i);
+            T.SetIntPoint(&ip);
+            double m = node_weights(i) * T.Weight();
+            if (Q) { m *= Q->Eval(T, ip); }
+            inv_diag(dofs[i]) = 1.0/m;
+         }
+      }
+   }
+}
+
+void DGMassInverse::Mult(const Vector &x, Vector &y) const
+{
+   const int ndofs = fes->GetNDofs(), vdim = fes->GetVDim();
+   // stride between the components, and between the scalar dofs
+   const bool by_nodes = (fes->GetOrdering() == Ordering::byNODES);
+   const int c_stride = by_nodes ? ndofs : 1, d_stride = by_nodes ? 1 : vdim;
+   const double *X = x.GetData();
+   double *Y = y.GetData();
+
+   if (type == COLLOCATED)
+   {
+#ifdef MFEM_USE_OPENMP
+      #pragma omp parallel for
+#endif
+      for (int d = 0; d < ndofs; d++)
+      {
+         for (int c = 0; c < vdim; c++)
+         {
+            const int vd = d*d_stride + c*c_stride;
+            Y[vd] = inv_diag(d) * X[vd];
+         }
+      }
+      return;
+   }
+
+   const Table &elem_dof = fes->GetElementToDofTable();
+   const int *I = elem_dof.GetI(), *J = elem_dof.GetJ();
+   const int ne = inv_blocks.SizeK(), nd = inv_blocks.SizeI();
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int e = 0; e < ne; e++)
+   {
+      const double *A = &inv_blocks(0,0,e);
+      const int *dofs = J + I[e];
+      for (int c = 0; c < vdim; c++)
+      {
+         const double *Xc = X + c*c_stride;
+         double *Yc = Y + c*c_stride;
+         for (int i = 0; i < nd; i++)
+         {
+            double r = 0.0;
+            for (int j = 0; j < nd; j++)
+            {
+               r += A[i + nd*j] * Xc[dofs[j]*d_stride];
+            }
+            Yc[dofs[i]*d_stride] = r;
+         }
+      }
+   }
+}
+
+}
@@ -0,0 +1,89 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_DGMASSINV
+#define MFEM_DGMASSINV
+
+#include "../config/config.hpp"
+#include "../linalg/operator.hpp"
+#include "../linalg/densemat.hpp"
+#include "fespace.hpp"
+#include "coefficient.hpp"
+
+namespace mfem
+{
+
+/** @brief The inverse of the mass matrix of a discontinuous (e.g. L2) finite
+    element space, applied element by element.
+
+    The mass matrix of a space whose dofs are not shared between elements is
+    block diagonal. This operator computes the element mass matrices once,
+    inverts them, and stores the inverses contiguously in a DenseTensor, so
+    that its action is a batch of small dense matrix-vector products which are
+    processed in parallel when OpenMP is enabled. It can replace the iterative
+    mass solve in each stage of explicit DG time integrators, see Example 9.
+
+    With the COLLOCATED type, the mass matrix is computed with the quadrature
+    rule whose points are the nodes of the basis, which gives a diagonal
+    matrix. This requires segment, quadrilateral or hexahedral elements whose
+    1D nodes are the Gauss-Legendre points (BasisType::GaussLegendre). The
+    collocated mass matrix is exact on affine elements and is a consistent
+    approximation of it otherwise.
+
+    All elements must have the same number of dofs. The vector dimension and
+    the ordering of the space are taken into account; the same block is applied
+    to all components. */
+class DGMassInverse : public Operator
+{
+public:
+   /// Types of mass matrix inverses.
+   enum Type { BLOCK, COLLOCATED };
+
+protected:
+   FiniteElementSpace *fes;
+   Coefficient *Q;
+   Type type;
+
+   /// Inverses of the element mass matrices, with the BLOCK type.
+   DenseTensor inv_blocks;
+   /// Inverse of the diagonal mass matrix (scalar dofs), with COLLOCATED.
+   Vector inv_diag;
+
+   void ComputeBlocks();
+   void ComputeCollocated();
+
+public:
+   /** @brief Construct the inverse of the mass matrix of @a f, with the
+       optional coefficient @a q, see MassIntegrator. */
+   DGMassInverse(FiniteElementSpace &f, Coefficient *q = NULL,
+                 Type t = BLOCK);
+
+   /** @brief Recompute the inverse, e.g. after the mesh nodes were moved or
+       the space was updated. */
+   void Update();
+
+   /// Return the type of the inverse.
+   Type GetType() const { return type; }
+
+   /// Return the inverses of the element mass matrices (BLOCK type).
+   const DenseTensor &GetInverseBlocks() const { return inv_blocks; }
+
+   /// Compute y = M^{-1} x.
+   virtual void Mult(const Vector &x, Vector &y) const;
+
+   /// The mass matrix is symmetric.
+   virtual void MultTranspose(const Vector &x, Vector &y) const
+   { Mult(x, y); }
+};
+
+}
+
+#endif
@@ -28,6 +28,17 @@ void ZienkiewiczZhuEstimator::ComputeEstimates()
    current_sequence = solution->FESpace()->GetMesh()->GetSequence();
 }
 
+void VertexZienkiewiczZhuEstimator::ComputeEstimates()
+{
+   if (!anisotropic) { aniso_flags.SetSize(0); }
+   const int with_subdomains = 1;
+   total_error = VertexZZErrorEstimator(*integ, *solution, error_estimates,
+                                        anisotropic ? &aniso_flags : NULL,
+                                        with_subdomains);
+
+   current_sequence = solution->FESpace()->GetMesh()->GetSequence();
+}
+
 
 #ifdef MFEM_USE_MPI
 
@@ -169,6 +169,79 @@ public:
 };
 
 
+/** @brief The VertexZienkiewiczZhuEstimator class implements a cheaper variant
+    of the Zienkiewicz-Zhu error estimation procedure, where the recovered flux
+    is linear on each element, see VertexZZErrorEstimator().
+
+    The required BilinearFormIntegrator must implement the methods
+    ComputeElementFlux() and ComputeFluxEnergy(), with nodal flux elements.
+ */
+class VertexZienkiewiczZhuEstimator : public AnisotropicErrorEstimator
+{
+protected:
+   long current_sequence;
+   Vector error_estimates;
+   double total_error;
+   bool anisotropic;
+   Array<int> aniso_flags;
+
+   BilinearFormIntegrator *integ; ///< Not owned.
+   GridFunction *solution; ///< Not owned.
+
+   /// Check if the mesh of the solution was modified.
+   bool MeshIsModified()
+   {
+      long mesh_sequence = solution->FESpace()->GetMesh()->GetSequence();
+      MFEM_ASSERT(mesh_sequence >= current_sequence, "");
+      return (mesh_sequence > current_sequence);
+   }
+
+   /// Compute the element error estimates.
+   void ComputeEstimates();
+
+public:
+   /** @brief Construct a new VertexZienkiewiczZhuEstimator object.
+       @param integ    This BilinearFormIntegrator must implement the methods
+                       ComputeElementFlux() and ComputeFluxEnergy().
+       @param sol      The solution field whose error is to be estimated. */
+   VertexZienkiewiczZhuEstimator(BilinearFormIntegrator &integ,
+                                 GridFunction &sol)
+      : current_sequence(-1),
+        total_error(),
+        anisotropic(false),
+        integ(&integ),
+        solution(&sol)
+   { }
+
+   /** @brief Enable/disable anisotropic estimates. To enable this option, the
+       BilinearFormIntegrator must support the 'd_energy' parameter in its
+       ComputeFluxEnergy() method. */
+   void SetAnisotropic(bool aniso = true) { anisotropic = aniso; }
+
+   /// Return the total error from the last error estimate.
+   double GetTotalError() const { return total_error; }
+
+   /// Get a Vector with all element errors.
+   virtual const Vector &GetLocalErrors()
+   {
+      if (MeshIsModified()) { ComputeEstimates(); }
+      return error_estimates;
+   }
+
+   /** @brief Get an Array<int> with anisotropic flags for all mesh elements.
+       Return an empty array when anisotropic estimates are not available or
+       enabled. */
+   virtual const Array<int> &GetAnisotropicFlags()
+   {
+      if (MeshIsModified()) { ComputeEstimates(); }
+      return aniso_flags;
+   }
+
+   /// Reset the error estimator.
+   virtual void Reset() { current_sequence = -1; }
+};
+
+
 #ifdef MFEM_USE_MPI
 
 /** @brief The L2ZienkiewiczZhuEstimator class implements the Zienkiewicz-Zhu
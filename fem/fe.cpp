@@ -22,7 +22,7 @@ namespace mfem
 using namespace std;
 
 FiniteElement::FiniteElement(int D, int G, int Do, int O, int F)
-   : Nodes(Do)
+   : Nodes(Do), dof2quad_list(NULL), dof2quad_size(0)
 {
    Dim = D ; GeomType = G ; Dof = Do ; Order = O ; FuncSpace = F;
    RangeType = SCALAR;
@@ -35,6 +35,136 @@ FiniteElement::FiniteElement(int D, int G, int Do, int O, int F)
 #endif
 }
 
+void DofToQuad::Setup(const FiniteElement &fe, const IntegrationRule &ir)
+{
+   FE = &fe;
+   IntRule = &ir;
+   const int dim = fe.GetDim();
+   ndof = fe.GetDof();
+   nqpt = ir.GetNPoints();
+   vdim = (fe.GetRangeType() == FiniteElement::SCALAR) ? 1 : dim;
+   switch (fe.GetDerivType())
+   {
+      case FiniteElement::GRAD: gdim = dim; break;
+      case FiniteElement::DIV: gdim = 1; break;
+      case FiniteElement::CURL: gdim = (dim == 3) ? 3 : 1; break;
+      default: gdim = 0; break;
+   }
+
+   B.SetSize(ndof, vdim*nqpt);
+   G.SetSize(ndof, gdim*nqpt);
+   DenseMatrix Bq, Gq;
+   for (int q = 0; q < nqpt; q++)
+   {
+      const IntegrationPoint &ip = ir.IntPoint(q);
+      GetB(q, Bq);
+      if (vdim == 1)
+      {
+         Vector shape(Bq.Data(), ndof);
+         fe.CalcShape(ip, shape);
+      }
+      else
+      {
+         fe.CalcVShape(ip, Bq);
+      }
+      if (gdim == 0) { continue; }
+      GetG(q, Gq);
+      switch (fe.GetDerivType())
+      {
+         case FiniteElement::GRAD: fe.CalcDShape(ip, Gq); break;
+         case FiniteElement::CURL: fe.CalcCurlShape(ip, Gq); break;
+         case FiniteElement::DIV:
+         {
+            Vector divshape(Gq.Data(), ndof);
+            fe.CalcDivShape(ip, divshape);
+            break;
+         }
+      }
+   }
+}
+
+static bool SameRule(const IntegrationRule &a, const IntegrationRule &b)
+{
+   if (a.GetNPoints() != b.GetNPoints()) { return false; }
+   for (int q = 0; q < a.GetNPoints(); q++)
+   {
+      const IntegrationPoint &ip = a.IntPoint(q), &jp = b.IntPoint(q);
+      if (ip.x != jp.x || ip.y != jp.y || ip.z != jp.z ||
+          ip.weight != jp.weight) { return false; }
+   }
+   return true;
+}
+
+const DofToQuad *FiniteElement::FindDofToQuad(const IntegrationRule &ir) const
+{
+   const DofToQuadNode *node;
+   // acquire the nodes published by GetCachedDofToQuad()
+#ifdef MFEM_USE_OPENMP
+   #pragma omp atomic read seq_cst
+#endif
+   node = dof2quad_list;
+   for ( ; node; node = node->next)
+   {
+      if (SameRule(node->ir, ir)) { return &node->maps; }
+   }
+   return NULL;
+}
+
+const DofToQuad *FiniteElement::GetCachedDofToQuad(const IntegrationRule &ir,
+                                                   bool force) const
+{
+   // lock-free path
+   const DofToQuad *maps = FindDofToQuad(ir);
+   if (maps) { return maps; }
+
+#ifdef MFEM_USE_OPENMP
+   #pragma omp critical (FiniteElementDofToQuad)
+#endif
+   {
+      // another thread may have added the tables in the meantime
+      maps = FindDofToQuad(ir);
+      if (maps == NULL && (force || dof2quad_size < MaxCachedDofToQuad))
+      {
+         DofToQuadNode *node = new DofToQuadNode;
+         ir.Copy(node->ir);
+         node->maps.Setup(*this, node->ir);
+         node->next = dof2quad_list;
+         dof2quad_size++;
+         // the node must be complete before it becomes visible to readers
+#ifdef MFEM_USE_OPENMP
+         #pragma omp atomic write seq_cst
+#endif
+         dof2quad_list = node;
+         maps = &node->maps;
+      }
+   }
+   return maps;
+}
+
+const DofToQuad &FiniteElement::GetDofToQuad(const IntegrationRule &ir) const
+{
+   return *GetCachedDofToQuad(ir, true);
+}
+
+const DofToQuad &FiniteElement::GetDofToQuad(const IntegrationRule &ir,
+                                             DofToQuad &tmp) const
+{
+   const DofToQuad *maps = GetCachedDofToQuad(ir, false);
+   if (maps) { return *maps; }
+   tmp.Setup(*this, ir);
+   return tmp;
+}
+
+FiniteElement::~FiniteElement()
+{
+   while (dof2quad_list)
+   {
+      DofToQuadNode *next = dof2quad_list->next;
+      delete dof2quad_list;
+      dof2quad_list = next;
+   }
+}
+
 void FiniteElement::CalcVShape (
    const IntegrationPoint &ip, DenseMatrix &shape) const
 {
@@ -6618,9 +6748,8 @@ Array2D<int> Poly_1D::binom;
 
 H1_SegmentElement::H1_SegmentElement(const int p, const int type)
    : NodalFiniteElement(1, Geometry::SEGMENT, p + 1, p, FunctionSpace::Pk),
-     pt_type(VerifyClosed(type)),
-     basis1d(poly1d.ClosedBasis(p, pt_type)),
-     dof_map(Dof)
+     TensorBasisElement(poly1d.ClosedBasis(p, VerifyClosed(type)), Dof),
+     pt_type(VerifyClosed(type))
 {
    const double *cp = poly1d.ClosedPoints(p, pt_type);
 
@@ -6709,9 +6838,8 @@ void H1_SegmentElement::ProjectDelta(int vertex, Vector &dofs) const
 H1_QuadrilateralElement::H1_QuadrilateralElement(const int p, const int type)
    : NodalFiniteElement(2, Geometry::SQUARE, (p + 1)*(p + 1), p,
                         FunctionSpace::Qk),
-     pt_type(VerifyClosed(type)),
-     basis1d(poly1d.ClosedBasis(p, pt_type)),
-     dof_map((p + 1)*(p + 1))
+     TensorBasisElement(poly1d.ClosedBasis(p, VerifyClosed(type)), Dof),
+     pt_type(VerifyClosed(type))
 {
    const double *cp = poly1d.ClosedPoints(p, pt_type);
 
@@ -6859,9 +6987,8 @@ void H1_QuadrilateralElement::ProjectDelta(int vertex, Vector &dofs) const
 H1_HexahedronElement::H1_HexahedronElement(const int p, const int type)
    : NodalFiniteElement(3, Geometry::CUBE, (p + 1)*(p + 1)*(p + 1), p,
                         FunctionSpace::Qk),
-     pt_type(VerifyClosed(type)),
-     basis1d(poly1d.ClosedBasis(p, pt_type)),
-     dof_map((p + 1)*(p + 1)*(p + 1))
+     TensorBasisElement(poly1d.ClosedBasis(p, VerifyClosed(type)), Dof),
+     pt_type(VerifyClosed(type))
 {
    const double *cp = poly1d.ClosedPoints(p, pt_type);
 
@@ -8154,8 +8281,8 @@ void H1Pos_TetrahedronElement::CalcDShape(const IntegrationPoint &ip,
 
 L2_SegmentElement::L2_SegmentElement(const int p, const int type)
    : NodalFiniteElement(1, Geometry::SEGMENT, p + 1, p, FunctionSpace::Pk),
-     type(VerifyOpen(type)),
-     basis1d(poly1d.OpenBasis(p, type))
+     TensorBasisElement(poly1d.OpenBasis(p, VerifyOpen(type)), 0),
+     type(VerifyOpen(type))
 {
    const double *op = poly1d.OpenPoints(p, type);
 
@@ -8259,8 +8386,8 @@ void L2Pos_SegmentElement::ProjectDelta(int vertex, Vector &dofs) const
 L2_QuadrilateralElement::L2_QuadrilateralElement(const int p, const int _type)
    : NodalFiniteElement(2, Geometry::SQUARE, (p + 1)*(p + 1), p,
                         FunctionSpace::Qk),
-     type(VerifyOpen(_type)),
-     basis1d(poly1d.OpenBasis(p, type))
+     TensorBasisElement(poly1d.OpenBasis(p, VerifyOpen(_type)), 0),
+     type(VerifyOpen(_type))
 {
    const double *op = poly1d.OpenPoints(p, type);
 
@@ -8448,8 +8575,8 @@ void L2Pos_QuadrilateralElement::ProjectDelta(int vertex, Vector &dofs) const
 L2_HexahedronElement::L2_HexahedronElement(const int p, const int _type)
    : NodalFiniteElement(3, Geometry::CUBE, (p + 1)*(p + 1)*(p + 1), p,
                         FunctionSpace::Qk),
-     type(VerifyOpen(_type)),
-     basis1d(poly1d.OpenBasis(p, type))
+     TensorBasisElement(poly1d.OpenBasis(p, VerifyOpen(_type)), 0),
+     type(VerifyOpen(_type))
 {
    const double *op = poly1d.OpenPoints(p, type);
 
@@ -10939,6 +11066,14 @@ void ND_SegmentElement::CalcVShape(const IntegrationPoint &ip,
 }
 
 
+const DofToQuad &NURBSFiniteElement::GetDofToQuad(
+   const IntegrationRule &ir) const
+{
+   MFEM_ABORT("the tables of NURBS elements are not cached, use "
+              "GetDofToQuad(ir, tmp)");
+   return FiniteElement::GetDofToQuad(ir);
+}
+
 void NURBS1DFiniteElement::CalcShape(const IntegrationPoint &ip,
                                      Vector &shape) const
 {
@@ -42,6 +42,52 @@ class Coefficient;
 class VectorCoefficient;
 class MatrixCoefficient;
 class KnotVector;
+class FiniteElement;
+
+/** @brief Tables of the reference shape functions of a FiniteElement and of
+    their derivatives at the points of an IntegrationRule.
+
+    The tables are the same for all elements that use the FiniteElement, so
+    integrators can read them instead of calling the virtual CalcShape()
+    methods at each point of each element. The tables are usually constructed
+    and owned by FiniteElement::GetDofToQuad(); NURBS elements compute them
+    for the current element in a caller-provided object. */
+class DofToQuad
+{
+public:
+   const FiniteElement *FE;
+   const IntegrationRule *IntRule;
+   int ndof, nqpt;
+   /// Width of the blocks of #B: 1 for scalar and Dim for vector elements.
+   int vdim;
+   /** @brief Width of the blocks of #G: Dim for gradients, 1 for divergences,
+       and 1 (in 2D) or 3 (in 3D) for curls; 0 if there are no derivatives. */
+   int gdim;
+   /** @brief Values of the shape functions: an ndof x (vdim*nqpt) matrix
+       whose ndof x vdim block q holds the values at point q. */
+   DenseMatrix B;
+   /** @brief Derivatives of the shape functions, of the type given by
+       FiniteElement::GetDerivType(): an ndof x (gdim*nqpt) matrix whose
+       ndof x gdim block q holds the derivatives at point q. */
+   DenseMatrix G;
+
+   DofToQuad()
+      : FE(NULL), IntRule(NULL), ndof(0), nqpt(0), vdim(0), gdim(0) { }
+   DofToQuad(const FiniteElement &fe, const IntegrationRule &ir)
+   { Setup(fe, ir); }
+
+   /// Compute the tables of @a fe at the points of @a ir.
+   void Setup(const FiniteElement &fe, const IntegrationRule &ir);
+
+   /// Set @a Bq to a view of the ndof x vdim block q of #B.
+   void GetB(int q, DenseMatrix &Bq) const
+   { Bq.UseExternalData(B.Data() + q*ndof*vdim, ndof, vdim); }
+
+   /// Set @a Gq to a view of the ndof x gdim block q of #G.
+   void GetG(int q, DenseMatrix &Gq) const
+   { Gq.UseExternalData(G.Data() + q*ndof*gdim, ndof, gdim); }
+};
+
 
 /// Abstract class for Finite Elements
 class FiniteElement
@@ -57,6 +103,31 @@ protected:
 #ifndef MFEM_THREAD_SAFE
    mutable DenseMatrix vshape; // Dof x Dim
 #endif
+   /// Node of the list of cached shape function tables, see GetDofToQuad().
+   struct DofToQuadNode
+   {
+      IntegrationRule ir; ///< Copy of the rule, identifies the tables
+      DofToQuad maps;
+      DofToQuadNode *next;
+   };
+   /** @brief Head of the list of cached tables.
+
+       Nodes are added at the head inside a critical section and published
+       with an atomic write; they are not modified or removed until
+       destruction, so GetDofToQuad() searches the list without locking after
+       an atomic read of the head. */
+   mutable DofToQuadNode *dof2quad_list;
+   mutable int dof2quad_size;
+
+   /// Maximum number of tables cached by GetDofToQuad(ir, tmp).
+   static const int MaxCachedDofToQuad = 16;
+
+   /// Search the cached tables for a rule with the points and weights of @a ir.
+   const DofToQuad *FindDofToQuad(const IntegrationRule &ir) const;
+   /** Return the cached tables for @a ir, computing them if needed; returns
+       NULL if they are not cached and the cache is full, unless @a force. */
+   const DofToQuad *GetCachedDofToQuad(const IntegrationRule &ir,
+                                       bool force) const;
 
 public:
    /// Enumeration for RangeType and DerivRangeType
@@ -283,7 +354,23 @@ public:
                            ElementTransformation &Trans,
                            DenseMatrix &div) const;
 
-   virtual ~FiniteElement () { }
+   /** @brief Return the tables of the reference shape functions and of their
+       derivatives at the points of @a ir.
+
+       The tables are computed on the first call and cached until the element
+       is destroyed. The rule is identified by its points and weights, so it
+       may be a temporary object. Intended for the rules of IntRules: every
+       new rule adds to the cache. */
+   virtual const DofToQuad &GetDofToQuad(const IntegrationRule &ir) const;
+
+   /** @brief Same as GetDofToQuad(ir), except that the tables are computed
+       in @a tmp, which is returned, when they are not cached and the cache
+       already holds MaxCachedDofToQuad tables, or when the shape functions
+       depend on the current element (NURBS). Used by the integrators. */
+   virtual const DofToQuad &GetDofToQuad(const IntegrationRule &ir,
+                                         DofToQuad &tmp) const;
+
+   virtual ~FiniteElement ();
 
    static int VerifyClosed(int pt_type)
    {
@@ -1474,15 +1561,36 @@ public:
 extern Poly_1D poly1d;
 
 
-class H1_SegmentElement : public NodalFiniteElement
+/** @brief Base class for tensor-product finite elements built from a nodal 1D
+    basis, see e.g. H1_HexahedronElement and L2_HexahedronElement. */
+class TensorBasisElement
+{
+protected:
+   Poly_1D::Basis &basis1d;
+   Array<int> dof_map;
+
+public:
+   TensorBasisElement(Poly_1D::Basis &basis, const int dof_map_size)
+      : basis1d(basis), dof_map(dof_map_size) { }
+
+   /// Return the 1D basis used to construct the tensor-product basis.
+   const Poly_1D::Basis &GetBasis1D() const { return basis1d; }
+
+   /** @brief Return the map from the lexicographic dof ordering to the native
+       dof ordering of the element; an empty map means that the two orderings
+       coincide. */
+   const Array<int> &GetDofMap() const { return dof_map; }
+};
+
+
+class H1_SegmentElement : public NodalFiniteElement,
+   public TensorBasisElement
 {
 private:
    int pt_type;
-   Poly_1D::Basis &basis1d;
 #ifndef MFEM_THREAD_SAFE
    mutable Vector shape_x, dshape_x;
 #endif
-   Array<int> dof_map;
 
 public:
    H1_SegmentElement(const int p, const int type = Quadrature1D::GaussLobatto);
@@ -1490,19 +1598,17 @@ public:
    virtual void CalcDShape(const IntegrationPoint &ip,
                            DenseMatrix &dshape) const;
    virtual void ProjectDelta(int vertex, Vector &dofs) const;
-   const Array<int> &GetDofMap() const { return dof_map; }
 };
 
 
-class H1_QuadrilateralElement : public NodalFiniteElement
+class H1_QuadrilateralElement : public NodalFiniteElement,
+   public TensorBasisElement
 {
 private:
    int pt_type;
-   Poly_1D::Basis &basis1d;
 #ifndef MFEM_THREAD_SAFE
    mutable Vector shape_x, shape_y, dshape_x, dshape_y;
 #endif
-   Array<int> dof_map;
 
 public:
    H1_QuadrilateralElement(const int p,
@@ -1511,19 +1617,17 @@ public:
    virtual void CalcDShape(const IntegrationPoint &ip,
                            DenseMatrix &dshape) const;
    virtual void ProjectDelta(int vertex, Vector &dofs) const;
-   const Array<int> &GetDofMap() const { return dof_map; }
 };
 
 
-class H1_HexahedronElement : public NodalFiniteElement
+class H1_HexahedronElement : public NodalFiniteElement,
+   public TensorBasisElement
 {
 private:
    int pt_type;
-   Poly_1D::Basis &basis1d;
 #ifndef MFEM_THREAD_SAFE
    mutable Vector shape_x, shape_y, shape_z, dshape_x, dshape_y, dshape_z;
 #endif
-   Array<int> dof_map;
 
 public:
    H1_HexahedronElement(const int p, const int type = Quadrature1D::GaussLobatto);
@@ -1531,7 +1635,6 @@ public:
    virtual void CalcDShape(const IntegrationPoint &ip,
                            DenseMatrix &dshape) const;
    virtual void ProjectDelta(int vertex, Vector &dofs) const;
-   const Array<int> &GetDofMap() const { return dof_map; }
 };
 
 class H1Pos_SegmentElement : public PositiveFiniteElement
@@ -1683,11 +1786,11 @@ public:
 };
 
 
-class L2_SegmentElement : public NodalFiniteElement
+class L2_SegmentElement : public NodalFiniteElement,
+   public TensorBasisElement
 {
 private:
    int type;
-   Poly_1D::Basis &basis1d;
 #ifndef MFEM_THREAD_SAFE
    mutable Vector shape_x, dshape_x;
 #endif
@@ -1717,11 +1820,11 @@ public:
 };
 
 
-class L2_QuadrilateralElement : public NodalFiniteElement
+class L2_QuadrilateralElement : public NodalFiniteElement,
+   public TensorBasisElement
 {
 private:
    int type;
-   Poly_1D::Basis &basis1d;
 #ifndef MFEM_THREAD_SAFE
    mutable Vector shape_x, shape_y, dshape_x, dshape_y;
 #endif
@@ -1756,11 +1859,11 @@ public:
 };
 
 
-class L2_HexahedronElement : public NodalFiniteElement
+class L2_HexahedronElement : public NodalFiniteElement,
+   public TensorBasisElement
 {
 private:
    int type;
-   Poly_1D::Basis &basis1d;
 #ifndef MFEM_THREAD_SAFE
    mutable Vector shape_x, shape_y, shape_z, dshape_x, dshape_y, dshape_z;
 #endif
@@ -2303,6 +2406,15 @@ public:
    void                 SetElement (int e)    const { elem = e; }
    Array <KnotVector*> &KnotVectors()         const { return kv; }
    Vector              &Weights    ()         const { return weights; }
+
+   /** @brief Not supported: the shape functions depend on the current
+       element, so the tables cannot be cached. */
+   virtual const DofToQuad &GetDofToQuad(const IntegrationRule &ir) const;
+
+   /// Compute the tables for the current element in @a tmp.
+   virtual const DofToQuad &GetDofToQuad(const IntegrationRule &ir,
+                                         DofToQuad &tmp) const
+   { tmp.Setup(*this, ir); return tmp; }
 };
 
 class NURBS1DFiniteElement : public NURBSFiniteElement
@@ -22,10 +22,12 @@
 #include "nonlininteg.hpp"
 #include "bilininteg.hpp"
 #include "fespace.hpp"
+#include "fespacehierarchy.hpp"
 #include "gridfunc.hpp"
 #include "linearform.hpp"
 #include "nonlinearform.hpp"
 #include "bilinearform.hpp"
+#include "dgmassinv.hpp"
 #include "hybridization.hpp"
 #include "datacollection.hpp"
 #include "estimators.hpp"
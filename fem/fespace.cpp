@@ -13,6 +13,7 @@
 
 #include "../mesh/mesh_headers.hpp"
 #include "fem.hpp"
+#include "../general/sort_pairs.hpp"
 
 #include <cmath>
 #include <cstdarg>
@@ -176,21 +177,23 @@ void FiniteElementSpace::BuildElementToDofTable() const
 {
    if (elem_dof) { return; }
 
-   Table *el_dof = new Table;
-   Array<int> dofs;
-   el_dof -> MakeI (mesh -> GetNE());
-   for (int i = 0; i < mesh -> GetNE(); i++)
+   // collect the element DOFs in a single pass, GetElementDofs is the
+   // expensive part of the construction
+   const int NE = mesh->GetNE();
+   int *I = new int[NE+1];
+   Array<int> dofs, all_dofs;
+   I[0] = 0;
+   for (int i = 0; i < NE; i++)
    {
-      GetElementDofs (i, dofs);
-      el_dof -> AddColumnsInRow (i, dofs.Size());
+      GetElementDofs(i, dofs);
+      all_dofs.Append(dofs);
+      I[i+1] = all_dofs.Size();
    }
-   el_dof -> MakeJ();
-   for (int i = 0; i < mesh -> GetNE(); i++)
-   {
-      GetElementDofs (i, dofs);
-      el_dof -> AddConnections (i, (int *)dofs, dofs.Size());
-   }
-   el_dof -> ShiftUpI();
+   int *J = new int[all_dofs.Size()];
+   std::copy(all_dofs.GetData(), all_dofs.GetData() + all_dofs.Size(), J);
+
+   Table *el_dof = new Table;
+   el_dof->SetIJ(I, J, NE);
    elem_dof = el_dof;
 }
 
@@ -201,24 +204,179 @@ void FiniteElementSpace::RebuildElementToDofTable()
    BuildElementToDofTable();
 }
 
+// Map each signed DOF in 'dofs' to new_dofs[dof], preserving its sign.
+static void RenumberSignedDofs(const Array<int> &new_dofs, int *dofs, int n)
+{
+   for (int k = 0; k < n; k++)
+   {
+      const int sdof = dofs[k];
+      const int new_dof = new_dofs[(sdof < 0) ? -1-sdof : sdof];
+      dofs[k] = (sdof < 0) ? -1-new_dof : new_dof;
+   }
+}
+
+void FiniteElementSpace::RenumberDofs(const Array<int> &new_dofs)
+{
+#ifdef MFEM_USE_MPI
+   MFEM_VERIFY(dynamic_cast<ParFiniteElementSpace*>(this) == NULL,
+               "Renumbering the DOFs of a ParFiniteElementSpace is not"
+               " supported");
+#endif
+   BuildElementToDofTable();
+
+   // compose with a previous renumbering; the DOFs computed from the mesh
+   // entities (vertex, edge, face, interior DOFs) are mapped by dof_perm
+   if (dof_perm.Size())
+   {
+      RenumberSignedDofs(new_dofs, dof_perm.GetData(), dof_perm.Size());
+   }
+   else
+   {
+      new_dofs.Copy(dof_perm);
+   }
+
+   Table *tables[2] = { elem_dof, bdrElem_dof };
+   for (int t = 0; t < 2; t++)
+   {
+      if (!tables[t]) { continue; }
+      RenumberSignedDofs(new_dofs, tables[t]->GetJ(),
+                         tables[t]->Size_of_connections());
+   }
+
+   dof_elem_array.DeleteAll();
+   dof_ldof_array.DeleteAll();
+}
+
 void FiniteElementSpace::ReorderElementToDofTable()
 {
+   BuildElementToDofTable();
+
    Array<int> dof_marker(ndofs);
 
    dof_marker = -1;
 
-   int *J = elem_dof->GetJ(), nnz = elem_dof->Size_of_connections();
+   const int *J = elem_dof->GetJ(), nnz = elem_dof->Size_of_connections();
    for (int k = 0, dof_counter = 0; k < nnz; k++)
    {
       const int sdof = J[k]; // signed dof
       const int dof = (sdof < 0) ? -1-sdof : sdof;
-      int new_dof = dof_marker[dof];
-      if (new_dof < 0)
+      if (dof_marker[dof] < 0)
+      {
+         dof_marker[dof] = dof_counter++;
+      }
+   }
+
+   RenumberDofs(dof_marker);
+}
+
+// Breadth-first search from 'root' in the graph (I,J): the vertices of the
+// connected component of 'root' are stored in 'queue' in the order they are
+// visited and their distances from 'root' are stored in 'level', which must be
+// -1 for all vertices on input. Returns the number of vertices visited.
+static int GraphLevelStructure(const int *I, const int *J, int root,
+                               Array<int> &level, Array<int> &queue)
+{
+   int head = 0, tail = 0;
+   queue[tail++] = root;
+   level[root] = 0;
+   while (head < tail)
+   {
+      const int v = queue[head++];
+      for (int k = I[v]; k < I[v+1]; k++)
       {
-         dof_marker[dof] = new_dof = dof_counter++;
+         const int u = J[k];
+         if (level[u] < 0)
+         {
+            level[u] = level[v] + 1;
+            queue[tail++] = u;
+         }
       }
-      J[k] = (sdof < 0) ? -1-new_dof : new_dof; // preserve the sign of sdof
    }
+   return tail;
+}
+
+void FiniteElementSpace::ReorderDofsRCM()
+{
+   MFEM_VERIFY(!NURBSext && !mesh->Nonconforming(),
+               "RCM reordering of NURBS or non-conforming spaces is not"
+               " supported");
+   BuildElementToDofTable();
+
+   // the graph of the DOFs sharing an element
+   Table el_dof(*elem_dof);
+   int *el_J = el_dof.GetJ();
+   for (int k = 0; k < el_dof.Size_of_connections(); k++)
+   {
+      if (el_J[k] < 0) { el_J[k] = -1-el_J[k]; }
+   }
+   Table dof_el, dof_dof;
+   Transpose(el_dof, dof_el, ndofs);
+   Mult(dof_el, el_dof, dof_dof);
+   const int *I = dof_dof.GetI(), *J = dof_dof.GetJ();
+
+   Array<int> new_dofs(ndofs), order(ndofs), level(ndofs), queue(ndofs);
+   Array<Pair<int, int> > nbrs;
+   new_dofs = -1;
+   level = -1;
+   int count = 0;
+   for (int s = 0; s < ndofs; s++)
+   {
+      if (new_dofs[s] >= 0) { continue; }
+
+      // find a pseudo-peripheral root in the component of s, see A. George and
+      // J. W. H. Liu, "An implementation of a pseudoperipheral node finder",
+      // ACM Trans. Math. Softw. 5 (1979)
+      int root = s, ecc = -1;
+      while (true)
+      {
+         const int n = GraphLevelStructure(I, J, root, level, queue);
+         const int last_level = level[queue[n-1]];
+         int cand = queue[n-1];
+         for (int k = n-1; k >= 0 && level[queue[k]] == last_level; k--)
+         {
+            const int v = queue[k];
+            if (I[v+1] - I[v] < I[cand+1] - I[cand]) { cand = v; }
+         }
+         for (int k = 0; k < n; k++) { level[queue[k]] = -1; }
+         if (last_level <= ecc) { break; }
+         ecc = last_level;
+         root = cand;
+      }
+
+      // Cuthill-McKee: breadth-first numbering, visiting the neighbors of
+      // each DOF by increasing degree
+      int head = count;
+      new_dofs[root] = count;
+      order[count++] = root;
+      while (head < count)
+      {
+         const int v = order[head++];
+         nbrs.SetSize(0);
+         for (int k = I[v]; k < I[v+1]; k++)
+         {
+            const int u = J[k];
+            if (new_dofs[u] < 0)
+            {
+               nbrs.SetSize(nbrs.Size() + 1);
+               nbrs.Last().one = I[u+1] - I[u];
+               nbrs.Last().two = u;
+            }
+         }
+         SortPairs<int, int>(nbrs.GetData(), nbrs.Size());
+         for (int k = 0; k < nbrs.Size(); k++)
+         {
+            new_dofs[nbrs[k].two] = count;
+            order[count++] = nbrs[k].two;
+         }
+      }
+   }
+
+   // reverse the Cuthill-McKee ordering
+   for (int i = 0; i < ndofs; i++)
+   {
+      new_dofs[i] = ndofs-1-new_dofs[i];
+   }
+   RenumberDofs(new_dofs);
 }
 
 void FiniteElementSpace::BuildDofToArrays()
@@ -747,9 +905,6 @@ SparseMatrix* FiniteElementSpace::RefinementMatrix(int old_ndofs,
    MFEM_VERIFY(mesh->GetLastOperation() == Mesh::REFINE, "");
    MFEM_VERIFY(ndofs >= old_ndofs, "Previous space is not coarser.");
 
-   Array<int> dofs, old_dofs, old_vdofs;
-   Vector row;
-
    const CoarseFineTransformations &rtrans = mesh->GetRefinementTransforms();
 
    int geom = mesh->GetElementBaseGeometry(); // assuming the same geom
@@ -757,52 +912,116 @@ SparseMatrix* FiniteElementSpace::RefinementMatrix(int old_ndofs,
 
    IsoparametricTransformation isotr;
    isotr.SetIdentityTransformation(geom);
+   const DenseMatrix identity(isotr.GetPointMat());
 
    int nmat = rtrans.point_matrices.SizeK();
    int ldof = fe->GetDof(); // assuming the same FE everywhere
 
-   // calculate local interpolation matrices for all refinement types
+   // calculate local interpolation matrices for all refinement types; the
+   // identity embeddings belong to elements that were not refined, their
+   // DOFs are copied from the old space instead of being interpolated
    DenseTensor localP(ldof, ldof, nmat);
+   Array<bool> is_identity(nmat);
    for (int i = 0; i < nmat; i++)
    {
-      isotr.GetPointMat() = rtrans.point_matrices(i);
+      const DenseMatrix &pm = rtrans.point_matrices(i);
+      is_identity[i] = (pm.Height() == identity.Height() &&
+                        pm.Width() == identity.Width());
+      for (int j = 0; is_identity[i] && j < pm.Height()*pm.Width(); j++)
+      {
+         is_identity[i] = (pm.Data()[j] == identity.Data()[j]);
+      }
+
+      isotr.GetPointMat() = pm;
       fe->GetLocalInterpolation(isotr, localP(i));
    }
 
-   SparseMatrix *P = new SparseMatrix(ndofs*vdim, old_ndofs*vdim, ldof);
+   // for each DOF, find the element and local DOF its row is computed from,
+   // preferring the unrefined elements (the row is then a single entry)
+   Array<int> row_elem(ndofs), row_ldof(ndofs);
+   row_elem = -1;
+   for (int pass = 0; pass < 2; pass++)
+   {
+      for (int k = 0; k < mesh->GetNE(); k++)
+      {
+         if (is_identity[rtrans.embeddings[k].matrix] != (pass == 0))
+         {
+            continue;
+         }
+         const int *dofs = elem_dof->GetRow(k);
+         for (int i = 0; i < ldof; i++)
+         {
+            int d = (dofs[i] >= 0) ? dofs[i] : (-1 - dofs[i]);
+            if (row_elem[d] < 0)
+            {
+               row_elem[d] = k;
+               row_ldof[d] = i;
+            }
+         }
+      }
+   }
 
-   Array<int> mark(P->Height());
-   mark = 0;
-   for (int k = 0; k < mesh->GetNE(); k++)
+   // count the nonzeros of each row and build the matrix directly in CSR
+   // form, the rows of the vector components are identical
+   int *I = new int[ndofs*vdim + 1];
+   I[0] = 0;
+   for (int d = 0; d < ndofs; d++)
    {
-      const Embedding &emb = rtrans.embeddings[k];
-      DenseMatrix &lP = localP(emb.matrix);
+      MFEM_ASSERT(row_elem[d] >= 0, "Row " << d << " of P not set.");
+      const Embedding &emb = rtrans.embeddings[row_elem[d]];
+      int nnz = 1;
+      if (!is_identity[emb.matrix])
+      {
+         const DenseMatrix &lP = localP(emb.matrix);
+         nnz = 0;
+         for (int j = 0; j < ldof; j++)
+         {
+            if (lP(row_ldof[d], j) != 0.0) { nnz++; }
+         }
+      }
+      for (int vd = 0; vd < vdim; vd++)
+      {
+         I[DofToVDof(d, vd) + 1] = nnz;
+      }
+   }
+   for (int r = 0; r < ndofs*vdim; r++) { I[r+1] += I[r]; }
 
-      elem_dof->GetRow(k, dofs);
-      old_elem_dof->GetRow(emb.parent, old_dofs);
+   int *J = new int[I[ndofs*vdim]];
+   double *A = new double[I[ndofs*vdim]];
+   for (int d = 0; d < ndofs; d++)
+   {
+      const int k = row_elem[d], i = row_ldof[d];
+      const Embedding &emb = rtrans.embeddings[k];
+      const int *old_dofs = old_elem_dof->GetRow(emb.parent);
+      const int s = (elem_dof->GetRow(k)[i] >= 0) ? 1 : -1;
 
       for (int vd = 0; vd < vdim; vd++)
       {
-         old_dofs.Copy(old_vdofs);
-         DofsToVDofs(vd, old_vdofs, old_ndofs);
-
-         for (int i = 0; i < ldof; i++)
+         int pos = I[DofToVDof(d, vd)];
+         for (int j = 0; j < ldof; j++)
          {
-            int r = DofToVDof(dofs[i], vd);
-            int m = (r >= 0) ? r : (-1 - r);
-
-            if (!mark[m])
+            double a;
+            if (is_identity[emb.matrix])
             {
-               lP.GetRow(i, row);
-               P->SetRow(r, old_vdofs, row); // TODO: profiler says this is slow!
-               mark[m] = 1;
+               if (j != i) { continue; }
+               a = 1.0;
             }
+            else
+            {
+               a = localP(emb.matrix)(i, j);
+               if (a == 0.0) { continue; }
+            }
+
+            int od = old_dofs[j];
+            if (od < 0) { od = -1 - od, a = -a; }
+            J[pos] = DofToVDof(od, vd, old_ndofs);
+            A[pos] = s*a;
+            pos++;
          }
       }
    }
 
-   MFEM_ASSERT(mark.Sum() == P->Height(), "Not all rows of P set.");
-   return P;
+   return new SparseMatrix(I, J, A, ndofs*vdim, old_ndofs*vdim);
 }
 
 void InvertLinearTrans(IsoparametricTransformation &trans,
@@ -1066,6 +1285,14 @@ void FiniteElementSpace::Construct()
    // later.
 }
 
+void FiniteElementSpace::PermuteDofs(Array<int> &dofs) const
+{
+   if (dof_perm.Size())
+   {
+      RenumberSignedDofs(dof_perm, dofs.GetData(), dofs.Size());
+   }
+}
+
 void FiniteElementSpace::GetElementDofs (int i, Array<int> &dofs) const
 {
    if (elem_dof)
@@ -1162,6 +1389,7 @@ void FiniteElementSpace::GetElementDofs (int i, Array<int> &dofs) const
       {
          dofs[ne+j] = k + j;
       }
+      PermuteDofs(dofs);
    }
 }
 
@@ -1258,6 +1486,7 @@ void FiniteElementSpace::GetBdrElementDofs(int i, Array<int> &dofs) const
             }
          }
       }
+      PermuteDofs(dofs);
    }
 }
 
@@ -1318,6 +1547,7 @@ void FiniteElementSpace::GetFaceDofs(int i, Array<int> &dofs) const
          dofs[ne+k] = j;
       }
    }
+   PermuteDofs(dofs);
 }
 
 void FiniteElementSpace::GetEdgeDofs(int i, Array<int> &dofs) const
@@ -1347,6 +1577,7 @@ void FiniteElementSpace::GetEdgeDofs(int i, Array<int> &dofs) const
    {
       dofs[nv+j] = k;
    }
+   PermuteDofs(dofs);
 }
 
 void FiniteElementSpace::GetVertexDofs(int i, Array<int> &dofs) const
@@ -1359,6 +1590,7 @@ void FiniteElementSpace::GetVertexDofs(int i, Array<int> &dofs) const
    {
       dofs[j] = i*nv+j;
    }
+   PermuteDofs(dofs);
 }
 
 void FiniteElementSpace::GetElementInteriorDofs (int i, Array<int> &dofs) const
@@ -1371,6 +1603,7 @@ void FiniteElementSpace::GetElementInteriorDofs (int i, Array<int> &dofs) const
    {
       dofs[j] = k + j;
    }
+   PermuteDofs(dofs);
 }
 
 void FiniteElementSpace::GetEdgeInteriorDofs (int i, Array<int> &dofs) const
@@ -1383,6 +1616,7 @@ void FiniteElementSpace::GetEdgeInteriorDofs (int i, Array<int> &dofs) const
    {
       dofs[j] = k;
    }
+   PermuteDofs(dofs);
 }
 
 void FiniteElementSpace::GetFaceInteriorDofs (int i, Array<int> &dofs) const
@@ -1398,6 +1632,7 @@ void FiniteElementSpace::GetFaceInteriorDofs (int i, Array<int> &dofs) const
          dofs[j] = k;
       }
    }
+   PermuteDofs(dofs);
 }
 
 const FiniteElement *FiniteElementSpace::GetBE (int i) const
@@ -1473,6 +1708,7 @@ void FiniteElementSpace::Destroy()
 
    dof_elem_array.DeleteAll();
    dof_ldof_array.DeleteAll();
+   dof_perm.DeleteAll();
 
    if (NURBSext)
    {
@@ -1561,6 +1797,63 @@ void FiniteElementSpace::Save(std::ostream &out) const
 }
 
 
+ElementRestriction::ElementRestriction(const FiniteElementSpace &f,
+                                       bool lexicographic)
+   : fes(f),
+     ne(f.GetNE()),
+     vdim(f.GetVDim()),
+     nd(ne > 0 ? f.GetFE(0)->GetDof() : 0)
+{
+   height = ne*vdim*nd;
+   width = fes.GetVSize();
+   indices.SetSize(height);
+
+   Array<int> dofs;
+   for (int e = 0; e < ne; e++)
+   {
+      const FiniteElement *fe = fes.GetFE(e);
+      MFEM_VERIFY(fe->GetDof() == nd, "all elements must have the same number"
+                  " of dofs");
+      const TensorBasisElement *tfe =
+         dynamic_cast<const TensorBasisElement*>(fe);
+      const Array<int> *dof_map =
+         (lexicographic && tfe && tfe->GetDofMap().Size() > 0) ?
+         &tfe->GetDofMap() : NULL;
+
+      fes.GetElementDofs(e, dofs);
+      for (int c = 0; c < vdim; c++)
+      {
+         int *e_ind = indices.GetData() + (e*vdim + c)*nd;
+         for (int j = 0; j < nd; j++)
+         {
+            e_ind[j] = fes.DofToVDof(dofs[dof_map ? (*dof_map)[j] : j], c);
+         }
+      }
+   }
+}
+
+void ElementRestriction::Mult(const Vector &x, Vector &y) const
+{
+   y.SetSize(height);
+   for (int i = 0; i < height; i++)
+   {
+      const int vdof = indices[i];
+      y(i) = (vdof >= 0) ? x(vdof) : -x(-1-vdof);
+   }
+}
+
+void ElementRestriction::MultTranspose(const Vector &x, Vector &y) const
+{
+   y.SetSize(width);
+   y = 0.0;
+   for (int i = 0; i < height; i++)
+   {
+      const int vdof = indices[i];
+      if (vdof >= 0) { y(vdof) += x(i); }
+      else { y(-1-vdof) -= x(i); }
+   }
+}
+
 void QuadratureSpace::Construct()
 {
    // protected method
@@ -84,6 +84,10 @@ protected:
 
    Array<int> dof_elem_array, dof_ldof_array;
 
+   /** Renumbering of the scalar DOFs by RenumberDofs(), applied to the DOFs
+       computed from the mesh entities. Empty if the DOFs are not renumbered. */
+   Array<int> dof_perm;
+
    NURBSExtension *NURBSext;
    int own_ext;
 
@@ -108,6 +112,16 @@ protected:
 
    void BuildElementToDofTable() const;
 
+   /** @brief Renumber the scalar DOFs, mapping each DOF @a dof to
+       @a new_dofs[dof]. The signs of the DOFs are preserved.
+
+       The renumbering is applied to the DOF tables and is stored in dof_perm,
+       so that the vertex, edge, face and interior DOFs agree with it. */
+   void RenumberDofs(const Array<int> &new_dofs);
+
+   /// Apply the renumbering dof_perm (if any) to the signed DOFs in @a dofs.
+   void PermuteDofs(Array<int> &dofs) const;
+
    /** This is a helper function to get edge (type == 0) or face (type == 1)
        DOFs. The function is aware of ghost edges/faces in parallel, for which
        an empty DOF list is returned. */
@@ -283,6 +297,16 @@ public:
        is preserved. */
    void ReorderElementToDofTable();
 
+   /** @brief Reorder the scalar DOFs with the reverse Cuthill-McKee algorithm
+       applied to the graph of the DOFs sharing an element.
+
+       This reduces the bandwidth of the assembled matrices, improving the
+       locality of their products. As with ReorderElementToDofTable(), the new
+       numbering is used by all DOF queries of the space and is lost when the
+       space is updated. Only conforming, non-NURBS meshes are supported, and
+       not ParFiniteElementSpace. */
+   void ReorderDofsRCM();
+
    void BuildDofToArrays();
 
    const Table &GetElementToDofTable() const { return *elem_dof; }
@@ -381,6 +405,39 @@ public:
 };
 
 
+/** @brief Operator mapping an L-vector, i.e. a GridFunction-size vector of a
+    FiniteElementSpace, to an E-vector, i.e. the concatenation of the local dof
+    values of all mesh elements.
+
+    The E-vector of element `e` is stored at offset `e*vdim*nd`, where `nd` is
+    the number of (scalar) dofs per element; all elements must have the same
+    number of dofs. Within each element the vector components are ordered by
+    nodes. When @a lexicographic is true, the local dofs of tensor-product
+    elements (see TensorBasisElement) are ordered lexicographically, as
+    required by the sum-factorization kernels; otherwise the native element dof
+    ordering is used. The transpose operator sums the element contributions
+    back into an L-vector. */
+class ElementRestriction : public Operator
+{
+protected:
+   const FiniteElementSpace &fes;
+   int ne, vdim, nd;
+   Array<int> indices; // signed vdof index of each E-vector entry
+
+public:
+   ElementRestriction(const FiniteElementSpace &f, bool lexicographic = true);
+
+   /// Number of (scalar) dofs per element.
+   int GetNDofs() const { return nd; }
+
+   /// Gather the element dof values: y = R x.
+   virtual void Mult(const Vector &x, Vector &y) const;
+
+   /// Assemble the element contributions: y = R^t x.
+   virtual void MultTranspose(const Vector &x, Vector &y) const;
+};
+
+
 /// Class representing the storage layout of a QuadratureFunction.
 /** Multiple QuadratureFunction%s can share the same QuadratureSpace. */
 class QuadratureSpace
@@ -411,6 +468,9 @@ public:
 
    virtual ~QuadratureSpace() { delete [] element_offsets; }
 
+   /// Rebuild the QuadratureSpace after its Mesh was modified.
+   void Update() { delete [] element_offsets; Construct(); }
+
    /// Return the total number of quadrature points.
    int GetSize() { return size; }
 
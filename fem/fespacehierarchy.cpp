@@ -0,0 +1,133 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "fem.hpp"
+
+namespace mfem
+{
+
+// Restrict the L-vector operator T (from the space fc to the space ff) to the
+// true dofs of the two spaces, if they have conforming prolongations.
+static Operator *TrueDofOperator(const FiniteElementSpace &fc,
+                                 const FiniteElementSpace &ff, Operator *T)
+{
+   const SparseMatrix *Pc = fc.GetConformingProlongation();
+   const SparseMatrix *Rf = ff.GetConformingRestriction();
+   if (!Pc && !Rf) { return T; }
+   MFEM_VERIFY(Pc && Rf, "both spaces must be non-conforming");
+   return new TripleProductOperator(const_cast<SparseMatrix*>(Rf), T,
+                                    const_cast<SparseMatrix*>(Pc),
+                                    false, true, false);
+}
+
+FiniteElementSpaceHierarchy::FiniteElementSpaceHierarchy(
+   Mesh *mesh, FiniteElementSpace *fes, bool own_mesh, bool own_fes)
+{
+   MFEM_VERIFY(fes->GetMesh() == mesh, "the space is not defined on the mesh");
+   meshes.Append(mesh);
+   fespaces.Append(fes);
+   fecs.Append(NULL);
+   prolongations.Append(NULL);
+   own_meshes.Append(own_mesh);
+   own_fespaces.Append(own_fes);
+}
+
+void FiniteElementSpaceHierarchy::AddUniformlyRefinedLevel()
+{
+   const FiniteElementSpace &fc = *fespaces.Last();
+   Mesh *mesh = new Mesh(*meshes.Last(), true);
+   FiniteElementSpace *ff =
+      new FiniteElementSpace(mesh, fc.FEColl(), fc.GetVDim(),
+                             fc.GetOrdering());
+   mesh->UniformRefinement();
+   ff->Update();
+
+   // Take the update operator from the space.
+   ff->SetUpdateOperatorOwner(false);
+   Operator *T = const_cast<Operator*>(ff->GetUpdateOperator());
+   ff->UpdatesFinished();
+   ff->SetUpdateOperatorOwner(true);
+   MFEM_VERIFY(T, "no update operator");
+
+   meshes.Append(mesh);
+   fespaces.Append(ff);
+   fecs.Append(NULL);
+   prolongations.Append(TrueDofOperator(fc, *ff, T));
+   own_meshes.Append(true);
+   own_fespaces.Append(true);
+}
+
+void FiniteElementSpaceHierarchy::AddOrderRefinedLevel(
+   FiniteElementCollection *fec)
+{
+   const FiniteElementSpace &fc = *fespaces.Last();
+   Mesh *mesh = meshes.Last();
+   FiniteElementSpace *ff =
+      new FiniteElementSpace(mesh, fec, fc.GetVDim(), fc.GetOrdering());
+
+   meshes.Append(mesh);
+   fespaces.Append(ff);
+   fecs.Append(fec);
+   prolongations.Append(TrueDofOperator(fc, *ff,
+                                        InterpolationMatrix(fc, *ff)));
+   own_meshes.Append(false);
+   own_fespaces.Append(true);
+}
+
+FiniteElementSpaceHierarchy::~FiniteElementSpaceHierarchy()
+{
+   // Delete the finer levels first: a space must be deleted before its
+   // collection and mesh.
+   for (int l = fespaces.Size() - 1; l >= 0; l--)
+   {
+      delete prolongations[l];
+      if (own_fespaces[l]) { delete fespaces[l]; }
+      delete fecs[l];
+      if (own_meshes[l]) { delete meshes[l]; }
+   }
+}
+
+SparseMatrix *InterpolationMatrix(const FiniteElementSpace &lfes,
+                                  const FiniteElementSpace &hfes)
+{
+   MFEM_VERIFY(lfes.GetMesh() == hfes.GetMesh(), "the spaces must be defined"
+               " on the same mesh");
+   MFEM_VERIFY(lfes.GetVDim() == hfes.GetVDim(), "the spaces must have the"
+               " same vector dimension");
+
+   const int vdim = lfes.GetVDim();
+   SparseMatrix *P = new SparseMatrix(hfes.GetVSize(), lfes.GetVSize());
+   DenseMatrix I;
+   Array<int> l_vdofs, h_vdofs, l_dofs, h_dofs;
+   for (int e = 0; e < hfes.GetNE(); e++)
+   {
+      const FiniteElement &l_fe = *lfes.GetFE(e);
+      const FiniteElement &h_fe = *hfes.GetFE(e);
+      h_fe.Project(l_fe, *hfes.GetElementTransformation(e), I);
+      lfes.GetElementVDofs(e, l_vdofs);
+      hfes.GetElementVDofs(e, h_vdofs);
+      const int nl = l_fe.GetDof(), nh = h_fe.GetDof();
+      l_dofs.SetSize(nl);
+      h_dofs.SetSize(nh);
+      // The dofs shared by several elements get the same (continuous) value
+      // from each of them, so the entries are set, not added.
+      for (int vd = 0; vd < vdim; vd++)
+      {
+         for (int i = 0; i < nl; i++) { l_dofs[i] = l_vdofs[vd*nl + i]; }
+         for (int i = 0; i < nh; i++) { h_dofs[i] = h_vdofs[vd*nh + i]; }
+         P->SetSubMatrix(h_dofs, l_dofs, I, 1);
+      }
+   }
+   P->Finalize();
+   return P;
+}
+
+}
@@ -0,0 +1,82 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_FESPACEHIERARCHY
+#define MFEM_FESPACEHIERARCHY
+
+#include "../config/config.hpp"
+#include "fespace.hpp"
+
+namespace mfem
+{
+
+/** @brief A sequence of nested finite element spaces with the prolongation
+    operators between them, e.g. for geometric and p-multigrid, see class
+    Multigrid.
+
+    Level 0 is the space given to the constructor. Finer levels are added by
+    uniform refinement of a copy of the mesh of the previous level, using
+    the update operator of the space (FiniteElementSpace::GetUpdateOperator)
+    as prolongation, or by increasing the order on the same mesh, using the
+    interpolation of the lower order space as prolongation. All levels have
+    the vector dimension and ordering of level 0. On non-conforming meshes,
+    the prolongations act on the true (conforming) dofs. */
+class FiniteElementSpaceHierarchy
+{
+protected:
+   Array<Mesh*> meshes;
+   Array<FiniteElementSpace*> fespaces;
+   Array<FiniteElementCollection*> fecs; // owned collections, or NULL
+   /// Prolongation from level l-1 to level l, NULL for l = 0.
+   Array<Operator*> prolongations;
+   Array<bool> own_meshes, own_fespaces;
+
+public:
+   /** @brief Start the hierarchy with the space @a fes on @a mesh; the flags
+       specify if they are deleted by the hierarchy. */
+   FiniteElementSpaceHierarchy(Mesh *mesh, FiniteElementSpace *fes,
+                               bool own_mesh, bool own_fes);
+
+   /** @brief Add a level obtained by refining uniformly the mesh of the
+       finest level, with the same finite element collection. */
+   void AddUniformlyRefinedLevel();
+
+   /** @brief Add a level on the mesh of the finest level with the collection
+       @a fec, which is deleted by the hierarchy. The space of @a fec must
+       contain the space of the finest level, e.g. H1 with a higher order. */
+   void AddOrderRefinedLevel(FiniteElementCollection *fec);
+
+   int GetNumLevels() const { return fespaces.Size(); }
+   int GetFinestLevelIndex() const { return fespaces.Size() - 1; }
+
+   Mesh &GetMeshAtLevel(int level) const { return *meshes[level]; }
+   FiniteElementSpace &GetFESpaceAtLevel(int level) const
+   { return *fespaces[level]; }
+   FiniteElementSpace &GetFinestFESpace() const
+   { return *fespaces.Last(); }
+
+   /// Return the prolongation from level @a level - 1 to @a level.
+   const Operator *GetProlongationAtLevel(int level) const
+   { return prolongations[level]; }
+
+   ~FiniteElementSpaceHierarchy();
+};
+
+/** @brief Return the interpolation matrix from the space @a lfes to the
+    space @a hfes, which must contain it and be defined on the same mesh,
+    e.g. from a lower to a higher order H1 space. Both spaces must have the
+    same vector dimension. */
+SparseMatrix *InterpolationMatrix(const FiniteElementSpace &lfes,
+                                  const FiniteElementSpace &hfes);
+
+}
+
+#endif
@@ -26,6 +26,23 @@ namespace mfem
 
 using namespace std;
 
+// Binary grid function format, see GridFunction::SaveBinary(): the 32-byte
+// identification string, followed by the header fields below, stored as
+// little-endian 64-bit integers, and the sections at the given offsets.
+static const char gf_binary_ident[] = "MFEM binary grid function v1.0\n";
+enum
+{
+   GF_BLOCK_SIZE,       // size of the whole block in bytes
+   GF_VDIM,
+   GF_ORDERING,
+   GF_NUM_VALUES,
+   GF_FEC_NAME_OFFSET,  // FiniteElementCollection name, not null-terminated
+   GF_FEC_NAME_LENGTH,
+   GF_DATA_OFFSET,      // the values, double
+   GF_RESERVED,
+   GF_NUM_FIELDS
+};
+
 GridFunction::GridFunction(Mesh *m, std::istream &input)
    : Vector()
 {
@@ -35,6 +52,15 @@ GridFunction::GridFunction(Mesh *m, std::istream &input)
 
    input >> std::ws;
    input.getline(buff, bufflen);  // 'FiniteElementSpace'
+   if (std::string(buff) + '\n' == gf_binary_ident)
+   {
+      char *buf;
+      long long size;
+      bin_io::ReadBlock(input, gf_binary_ident, GF_NUM_FIELDS, buf, size);
+      LoadBinary(m, buf, size, true);
+      delete [] buf;
+      return;
+   }
    if (strcmp(buff, "FiniteElementSpace"))
    {
       mfem_error("GridFunction::GridFunction():"
@@ -55,6 +81,51 @@ GridFunction::GridFunction(Mesh *m, std::istream &input)
    sequence = 0;
 }
 
+GridFunction::GridFunction(Mesh *m, char *buf, long long size, bool copy)
+   : Vector()
+{
+   LoadBinary(m, buf, size, copy);
+}
+
+GridFunction::GridFunction(Mesh *m, MappedFile &file)
+   : Vector()
+{
+   LoadBinary(m, file.GetData(), file.Size(), false);
+}
+
+void GridFunction::LoadBinary(Mesh *m, char *buf, long long size, bool copy)
+{
+   const long long header_size = 32 + 8*GF_NUM_FIELDS;
+   MFEM_VERIFY(size >= header_size &&
+               !strncmp(buf, gf_binary_ident, sizeof(gf_binary_ident) - 1),
+               "input is not a binary GridFunction");
+   long long h[GF_NUM_FIELDS];
+   bin_io::ReadLittleEndian(buf + 32, h, GF_NUM_FIELDS);
+   MFEM_VERIFY(h[GF_BLOCK_SIZE] <= size &&
+               h[GF_FEC_NAME_OFFSET] + h[GF_FEC_NAME_LENGTH] <= size &&
+               h[GF_DATA_OFFSET] + 8*h[GF_NUM_VALUES] <= size &&
+               h[GF_DATA_OFFSET] % 8 == 0,
+               "invalid binary GridFunction header");
+
+   std::string fec_name(buf + h[GF_FEC_NAME_OFFSET], h[GF_FEC_NAME_LENGTH]);
+   fec = FiniteElementCollection::New(fec_name.c_str());
+   fes = new FiniteElementSpace(m, fec, h[GF_VDIM], h[GF_ORDERING]);
+   MFEM_VERIFY(fes->GetVSize() == h[GF_NUM_VALUES],
+               "the binary GridFunction does not match the Mesh");
+
+   double *data = reinterpret_cast<double *>(buf + h[GF_DATA_OFFSET]);
+   if (copy || !bin_io::IsLittleEndian())
+   {
+      SetSize(fes->GetVSize());
+      bin_io::ReadLittleEndian(buf + h[GF_DATA_OFFSET], GetData(), Size());
+   }
+   else
+   {
+      NewDataAndSize(data, fes->GetVSize());
+   }
+   sequence = 0;
+}
+
 GridFunction::GridFunction(Mesh *m, GridFunction *gf_array[], int num_pieces)
 {
    // all GridFunctions must have the same FE collection, vdim, ordering
@@ -194,6 +265,50 @@ void GridFunction::MakeRef(FiniteElementSpace *f, Vector &v, int v_offset)
 }
 
 
+// GetFE() and GetElementTransformation() on NURBS spaces or meshes modify a
+// shared NURBSFiniteElement, so the element loops over such spaces are not
+// threaded.
+static bool UsesNURBS(FiniteElementSpace *fes)
+{
+   return fes->GetNURBSext() || fes->GetMesh()->NURBSext;
+}
+
+// Color the elements of 'fes' so that elements with the same color have no
+// common dofs. Without OpenMP, all elements are given the same color.
+static void ColorElementsByDofs(const FiniteElementSpace &fes, Table &colors)
+{
+   const int NE = fes.GetNE();
+#ifdef MFEM_USE_OPENMP
+   const Table &elem_dof = fes.GetElementToDofTable();
+   Table el_dof;
+   el_dof.MakeI(NE);
+   for (int i = 0; i < NE; i++)
+   {
+      el_dof.AddColumnsInRow(i, elem_dof.RowSize(i));
+   }
+   el_dof.MakeJ();
+   for (int i = 0; i < NE; i++)
+   {
+      const int *dofs = elem_dof.GetRow(i);
+      for (int j = 0; j < elem_dof.RowSize(i); j++)
+      {
+         el_dof.AddConnection(i, (dofs[j] >= 0) ? dofs[j] : -1-dofs[j]);
+      }
+   }
+   el_dof.ShiftUpI();
+   GreedyColoring(el_dof, colors, fes.GetNDofs());
+#else
+   colors.MakeI(1);
+   colors.AddColumnsInRow(0, NE);
+   colors.MakeJ();
+   for (int i = 0; i < NE; i++)
+   {
+      colors.AddConnection(0, i);
+   }
+   colors.ShiftUpI();
+#endif
+}
+
 void GridFunction::SumFluxAndCount(BilinearFormIntegrator &blfi,
                                    GridFunction &flux,
                                    Array<int>& count,
@@ -202,41 +317,60 @@ void GridFunction::SumFluxAndCount(BilinearFormIntegrator &blfi,
 {
    GridFunction &u = *this;
 
-   ElementTransformation *Transf;
-
    FiniteElementSpace *ufes = u.FESpace();
    FiniteElementSpace *ffes = flux.FESpace();
 
-   int nfe = ufes->GetNE();
-   Array<int> udofs;
-   Array<int> fdofs;
-   Vector ul, fl;
-
    flux = 0.0;
    count = 0;
 
-   for (int i = 0; i < nfe; i++)
+   // elements with the same color share no flux dofs, so their fluxes can be
+   // added concurrently
+   Table colors;
+   ColorElementsByDofs(*ffes, colors);
+   const bool nurbs = UsesNURBS(ufes) || UsesNURBS(ffes);
+
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel if (!nurbs)
+#endif
    {
-      if (subdomain >= 0 && ufes->GetAttribute(i) != subdomain)
+      // thread-private data; note: the integrator must be thread-safe
+      Array<int> udofs;
+      Array<int> fdofs;
+      Vector ul, fl;
+      IsoparametricTransformation Transf;
+
+      for (int c = 0; c < colors.Size(); c++)
       {
-         continue;
-      }
+         const int *elems = colors.GetRow(c);
+         const int num_elems = colors.RowSize(c);
+#ifdef MFEM_USE_OPENMP
+         #pragma omp for
+#endif
+         for (int j = 0; j < num_elems; j++)
+         {
+            const int i = elems[j];
+            if (subdomain >= 0 && ufes->GetAttribute(i) != subdomain)
+            {
+               continue;
+            }
 
-      ufes->GetElementVDofs(i, udofs);
-      ffes->GetElementVDofs(i, fdofs);
+            ufes->GetElementVDofs(i, udofs);
+            ffes->GetElementVDofs(i, fdofs);
 
-      u.GetSubVector(udofs, ul);
+            u.GetSubVector(udofs, ul);
 
-      Transf = ufes->GetElementTransformation(i);
-      blfi.ComputeElementFlux(*ufes->GetFE(i), *Transf, ul,
-                              *ffes->GetFE(i), fl, wcoef);
+            ufes->GetElementTransformation(i, &Transf);
+            blfi.ComputeElementFlux(*ufes->GetFE(i), Transf, ul,
+                                    *ffes->GetFE(i), fl, wcoef);
 
-      flux.AddElementVector(fdofs, fl);
+            flux.AddElementVector(fdofs, fl);
 
-      FiniteElementSpace::AdjustVDofs(fdofs);
-      for (int j = 0; j < fdofs.Size(); j++)
-      {
-         count[fdofs[j]]++;
+            FiniteElementSpace::AdjustVDofs(fdofs);
+            for (int k = 0; k < fdofs.Size(); k++)
+            {
+               count[fdofs[k]]++;
+            }
+         }
       }
    }
 }
@@ -399,6 +533,33 @@ void GridFunction::GetVectorValue(int i, const IntegrationPoint &ip,
    }
 }
 
+void GridFunction::Interpolate(const Array<int> &elem_ids,
+                               const Array<IntegrationPoint> &ips,
+                               DenseMatrix &vals) const
+{
+   MFEM_VERIFY(elem_ids.Size() == ips.Size(), "incompatible arrays");
+   const int npts = elem_ids.Size();
+   vals.SetSize(VectorDim(), npts);
+   Vector val;
+   for (int j = 0; j < npts; j++)
+   {
+      vals.GetColumnReference(j, val);
+      if (elem_ids[j] < 0) { val = 0.0; }
+      else { GetVectorValue(elem_ids[j], ips[j], val); }
+   }
+}
+
+int GridFunction::Interpolate(const DenseMatrix &point_mat, DenseMatrix &vals,
+                              bool warn) const
+{
+   Array<int> elem_ids;
+   Array<IntegrationPoint> ips;
+   const int found = fes->GetMesh()->FindPoints(point_mat, elem_ids, ips,
+                                                warn);
+   Interpolate(elem_ids, ips, vals);
+   return found;
+}
+
 void GridFunction::GetValues(int i, const IntegrationRule &ir, Vector &vals,
                              int vdim)
 const
@@ -2269,6 +2430,37 @@ void GridFunction::Save(std::ostream &out) const
    out.flush();
 }
 
+long long GridFunction::BinarySize() const
+{
+   const long long name_offset = 32 + 8*GF_NUM_FIELDS;
+   const long long data_offset =
+      bin_io::Align(name_offset + strlen(fes->FEColl()->Name()));
+   return data_offset + 8*(long long)Size();
+}
+
+void GridFunction::SaveBinary(std::ostream &out) const
+{
+   const char *fec_name = fes->FEColl()->Name();
+   long long h[GF_NUM_FIELDS];
+   h[GF_BLOCK_SIZE] = BinarySize();
+   h[GF_VDIM] = fes->GetVDim();
+   h[GF_ORDERING] = fes->GetOrdering();
+   h[GF_NUM_VALUES] = Size();
+   h[GF_FEC_NAME_OFFSET] = 32 + 8*GF_NUM_FIELDS;
+   h[GF_FEC_NAME_LENGTH] = strlen(fec_name);
+   h[GF_DATA_OFFSET] =
+      bin_io::Align(h[GF_FEC_NAME_OFFSET] + h[GF_FEC_NAME_LENGTH]);
+   h[GF_RESERVED] = 0;
+
+   bin_io::WriteIdent(out, gf_binary_ident);
+   bin_io::WriteLittleEndian(out, h, GF_NUM_FIELDS);
+   out.write(fec_name, h[GF_FEC_NAME_LENGTH]);
+   bin_io::WritePadding(out, h[GF_DATA_OFFSET] - h[GF_FEC_NAME_OFFSET] -
+                        h[GF_FEC_NAME_LENGTH]);
+   bin_io::WriteLittleEndian(out, GetData(), Size());
+   out.flush();
+}
+
 void GridFunction::SaveVTK(std::ostream &out, const std::string &field_name,
                            int ref)
 {
@@ -2497,6 +2689,26 @@ std::ostream &operator<<(std::ostream &out, const QuadratureFunction &qf)
 }
 
 
+// Return the anisotropic refinement flag for the directional error energies
+// 'd_xyz' of one element.
+static int GetAnisotropicFlag(const Vector &d_xyz)
+{
+   const int dim = d_xyz.Size();
+   double sum = 0;
+   for (int k = 0; k < dim; k++)
+   {
+      sum += d_xyz[k];
+   }
+
+   double thresh = 0.15 * 3.0/dim;
+   int flag = 0;
+   for (int k = 0; k < dim; k++)
+   {
+      if (d_xyz[k] / sum > thresh) { flag |= (1 << k); }
+   }
+   return flag;
+}
+
 double ZZErrorEstimator(BilinearFormIntegrator &blfi,
                         GridFunction &u,
                         GridFunction &flux, Vector &error_estimates,
@@ -2506,20 +2718,15 @@ double ZZErrorEstimator(BilinearFormIntegrator &blfi,
    const int with_coeff = 0;
    FiniteElementSpace *ufes = u.FESpace();
    FiniteElementSpace *ffes = flux.FESpace();
-   ElementTransformation *Transf;
 
    int dim = ufes->GetMesh()->Dimension();
    int nfe = ufes->GetNE();
-
-   Array<int> udofs;
-   Array<int> fdofs;
-   Vector ul, fl, fla, d_xyz;
+   const bool nurbs = UsesNURBS(ufes) || UsesNURBS(ffes);
 
    error_estimates.SetSize(nfe);
    if (aniso_flags)
    {
       aniso_flags->SetSize(nfe);
-      d_xyz.SetSize(dim);
    }
 
    int nsd = 1;
@@ -2538,44 +2745,205 @@ double ZZErrorEstimator(BilinearFormIntegrator &blfi,
       // This calls the parallel version when u is a ParGridFunction
       u.ComputeFlux(blfi, flux, with_coeff, (with_subdomains ? s : -1));
 
-      for (int i = 0; i < nfe; i++)
+#ifdef MFEM_USE_OPENMP
+      #pragma omp parallel if (!nurbs) reduction(+:total_error)
+#endif
       {
-         if (with_subdomains && ufes->GetAttribute(i) != s) { continue; }
+         // thread-private data; note: the integrator must be thread-safe
+         Array<int> udofs;
+         Array<int> fdofs;
+         Vector ul, fl, fla, d_xyz;
+         IsoparametricTransformation Transf;
+         if (aniso_flags) { d_xyz.SetSize(dim); }
 
-         ufes->GetElementVDofs(i, udofs);
-         ffes->GetElementVDofs(i, fdofs);
+#ifdef MFEM_USE_OPENMP
+         #pragma omp for
+#endif
+         for (int i = 0; i < nfe; i++)
+         {
+            if (with_subdomains && ufes->GetAttribute(i) != s) { continue; }
+
+            ufes->GetElementVDofs(i, udofs);
+            ffes->GetElementVDofs(i, fdofs);
+
+            u.GetSubVector(udofs, ul);
+            flux.GetSubVector(fdofs, fla);
+
+            ufes->GetElementTransformation(i, &Transf);
+            blfi.ComputeElementFlux(*ufes->GetFE(i), Transf, ul,
+                                    *ffes->GetFE(i), fl, with_coeff);
+
+            fl -= fla;
 
+            double err = blfi.ComputeFluxEnergy(*ffes->GetFE(i), Transf, fl,
+                                                (aniso_flags ? &d_xyz : NULL));
+
+            error_estimates(i) = std::sqrt(err);
+            total_error += err;
+
+            if (aniso_flags)
+            {
+               (*aniso_flags)[i] = GetAnisotropicFlag(d_xyz);
+            }
+         }
+      }
+   }
+
+   return std::sqrt(total_error);
+}
+
+double VertexZZErrorEstimator(BilinearFormIntegrator &blfi,
+                              GridFunction &u,
+                              Vector &error_estimates,
+                              Array<int>* aniso_flags,
+                              int with_subdomains)
+{
+   const int with_coeff = 0;
+   FiniteElementSpace *ufes = u.FESpace();
+   Mesh *mesh = ufes->GetMesh();
+
+   int dim = mesh->Dimension();
+   int sdim = mesh->SpaceDimension();
+   int nfe = ufes->GetNE();
+
+   error_estimates.SetSize(nfe);
+   if (aniso_flags)
+   {
+      aniso_flags->SetSize(nfe);
+   }
+
+   // the recovered flux is linear on each element
+   LinearFECollection lin_fec;
+
+   // offsets of the element fluxes at the element vertices
+   Array<int> offset(nfe+1);
+   offset[0] = 0;
+   for (int i = 0; i < nfe; i++)
+   {
+      offset[i+1] = offset[i] + sdim*mesh->GetElement(i)->GetNVertices();
+   }
+   Vector el_flux(offset[nfe]);
+
+   // compute the fluxes of all elements at their vertices
+   const bool nurbs = UsesNURBS(ufes);
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel if (!nurbs)
+#endif
+   {
+      // thread-private data; note: the integrator must be thread-safe
+      Array<int> udofs;
+      Vector ul, fl;
+      IsoparametricTransformation Transf;
+
+#ifdef MFEM_USE_OPENMP
+      #pragma omp for
+#endif
+      for (int i = 0; i < nfe; i++)
+      {
+         ufes->GetElementVDofs(i, udofs);
          u.GetSubVector(udofs, ul);
-         flux.GetSubVector(fdofs, fla);
 
-         Transf = ufes->GetElementTransformation(i);
-         blfi.ComputeElementFlux(*ufes->GetFE(i), *Transf, ul,
-                                 *ffes->GetFE(i), fl, with_coeff);
+         ufes->GetElementTransformation(i, &Transf);
+         const FiniteElement *fe =
+            lin_fec.FiniteElementForGeometry(mesh->GetElementBaseGeometry(i));
+         blfi.ComputeElementFlux(*ufes->GetFE(i), Transf, ul, *fe, fl,
+                                 with_coeff);
 
-         fl -= fla;
+         MFEM_ASSERT(fl.Size() == offset[i+1] - offset[i], "");
+         for (int j = 0; j < fl.Size(); j++)
+         {
+            el_flux(offset[i] + j) = fl(j);
+         }
+      }
+   }
 
-         double err = blfi.ComputeFluxEnergy(*ffes->GetFE(i), *Transf, fl,
-                                             (aniso_flags ? &d_xyz : NULL));
+   int nsd = 1;
+   if (with_subdomains)
+   {
+      for (int i = 0; i < nfe; i++)
+      {
+         int attr = ufes->GetAttribute(i);
+         if (attr > nsd) { nsd = attr; }
+      }
+   }
+
+   Vector vert_flux(sdim*mesh->GetNV());
+   Array<int> count(mesh->GetNV());
 
-         error_estimates(i) = std::sqrt(err);
-         total_error += err;
+   double total_error = 0.0;
+   for (int s = 1; s <= nsd; s++)
+   {
+      // average the element fluxes at the vertices of the subdomain
+      vert_flux = 0.0;
+      count = 0;
+      Array<int> v;
+      for (int i = 0; i < nfe; i++)
+      {
+         if (with_subdomains && ufes->GetAttribute(i) != s) { continue; }
 
-         if (aniso_flags)
+         mesh->GetElementVertices(i, v);
+         const double *fl = el_flux.GetData() + offset[i];
+         for (int j = 0; j < v.Size(); j++)
          {
-            double sum = 0;
-            for (int k = 0; k < dim; k++)
+            for (int k = 0; k < sdim; k++)
             {
-               sum += d_xyz[k];
+               vert_flux(sdim*v[j] + k) += fl[k*v.Size() + j];
             }
+            count[v[j]]++;
+         }
+      }
+      for (int j = 0; j < count.Size(); j++)
+      {
+         if (count[j] == 0) { continue; }
+         for (int k = 0; k < sdim; k++)
+         {
+            vert_flux(sdim*j + k) /= count[j];
+         }
+      }
+
+#ifdef MFEM_USE_OPENMP
+      #pragma omp parallel if (!nurbs) reduction(+:total_error)
+#endif
+      {
+         // thread-private data; note: the integrator must be thread-safe
+         Array<int> v;
+         Vector fl, d_xyz;
+         IsoparametricTransformation Transf;
+         if (aniso_flags) { d_xyz.SetSize(dim); }
 
-            double thresh = 0.15 * 3.0/dim;
-            int flag = 0;
-            for (int k = 0; k < dim; k++)
+#ifdef MFEM_USE_OPENMP
+         #pragma omp for
+#endif
+         for (int i = 0; i < nfe; i++)
+         {
+            if (with_subdomains && ufes->GetAttribute(i) != s) { continue; }
+
+            // difference between the recovered and the element flux
+            mesh->GetElementVertices(i, v);
+            const double *efl = el_flux.GetData() + offset[i];
+            fl.SetSize(sdim*v.Size());
+            for (int j = 0; j < v.Size(); j++)
             {
-               if (d_xyz[k] / sum > thresh) { flag |= (1 << k); }
+               for (int k = 0; k < sdim; k++)
+               {
+                  const int m = k*v.Size() + j;
+                  fl(m) = efl[m] - vert_flux(sdim*v[j] + k);
+               }
             }
 
-            (*aniso_flags)[i] = flag;
+            ufes->GetElementTransformation(i, &Transf);
+            const FiniteElement *fe =
+               lin_fec.FiniteElementForGeometry(mesh->GetElementBaseGeometry(i));
+            double err = blfi.ComputeFluxEnergy(*fe, Transf, fl,
+                                                (aniso_flags ? &d_xyz : NULL));
+
+            error_estimates(i) = std::sqrt(err);
+            total_error += err;
+
+            if (aniso_flags)
+            {
+               (*aniso_flags)[i] = GetAnisotropicFlag(d_xyz);
+            }
          }
       }
    }
@@ -2641,6 +3009,58 @@ double ComputeElementLpDistance(double p, int i,
 }
 
 
+static void CoordinatesFunction(const Vector &x, Vector &y) { y = x; }
+
+void RigidBodyModes(FiniteElementSpace &fes, DenseMatrix &modes)
+{
+   Mesh *mesh = fes.GetMesh();
+   const int dim = mesh->SpaceDimension(), nd = fes.GetNDofs();
+   MFEM_VERIFY(fes.GetVDim() == dim, "the vector dimension of the space must"
+               " be the space dimension");
+
+   GridFunction coords;
+   if (mesh->GetNodes() && mesh->GetNodes()->FESpace() == &fes)
+   {
+      coords.MakeRef(&fes, *mesh->GetNodes(), 0);
+   }
+   else
+   {
+      coords.SetSpace(&fes);
+      VectorFunctionCoefficient x_coeff(dim, CoordinatesFunction);
+      coords.ProjectCoefficient(x_coeff);
+   }
+
+   const int num_rot = (dim == 3) ? 3 : dim - 1;
+   modes.SetSize(fes.GetVSize(), dim + num_rot);
+   modes = 0.0;
+   for (int i = 0; i < nd; i++)
+   {
+      int vdof[3];
+      double x[3];
+      for (int c = 0; c < dim; c++)
+      {
+         vdof[c] = fes.DofToVDof(i, c);
+         x[c] = coords(vdof[c]);
+         modes(vdof[c], c) = 1.0;
+      }
+      if (dim >= 2)
+      {
+         // rotation in the x-y plane
+         modes(vdof[0], dim) = -x[1];
+         modes(vdof[1], dim) = x[0];
+      }
+      if (dim == 3)
+      {
+         // rotations in the y-z and z-x planes
+         modes(vdof[1], dim+1) = -x[2];
+         modes(vdof[2], dim+1) = x[1];
+         modes(vdof[2], dim+2) = -x[0];
+         modes(vdof[0], dim+2) = x[2];
+      }
+   }
+}
+
+
 double ExtrudeCoefficient::Eval(ElementTransformation &T,
                                 const IntegrationPoint &ip)
 {
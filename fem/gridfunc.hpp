@@ -13,6 +13,7 @@
 #define MFEM_GRIDFUNC
 
 #include "../config/config.hpp"
+#include "../general/binaryio.hpp"
 #include "fespace.hpp"
 #include "coefficient.hpp"
 #include "bilininteg.hpp"
@@ -58,6 +59,9 @@ protected:
 
    void Destroy();
 
+   // Initialize from a block in the binary format, see SaveBinary().
+   void LoadBinary(Mesh *m, char *buf, long long size, bool copy);
+
 public:
 
    GridFunction() { fes = NULL; fec = NULL; sequence = 0; }
@@ -85,6 +89,19 @@ public:
        are owned by the GridFunction. */
    GridFunction(Mesh *m, std::istream &input);
 
+   /** @brief Construct a GridFunction on the given Mesh from the block of
+       @a size bytes at @a buf, in the binary format created by SaveBinary().
+
+       If @a copy is false, the GridFunction uses the values stored in the
+       block without copying them (unless the host is big-endian) and the
+       block must remain valid for the lifetime of the GridFunction. */
+   GridFunction(Mesh *m, char *buf, long long size, bool copy = true);
+
+   /** @brief Construct a GridFunction on the given Mesh from a file in the
+       binary format, mapped into memory. The values are not copied, see
+       MappedFile. */
+   GridFunction(Mesh *m, MappedFile &file);
+
    GridFunction(Mesh *m, GridFunction *gf_array[], int num_pieces);
 
    /// Make the GridFunction the owner of 'fec' and 'fes'
@@ -127,6 +144,21 @@ public:
    int GetFaceVectorValues(int i, int side, const IntegrationRule &ir,
                            DenseMatrix &vals, DenseMatrix &tr) const;
 
+   /** @brief Evaluate the GridFunction at the points located with
+       Mesh::FindPoints(): the j-th column of @a vals, a VectorDim() x npts
+       matrix, is set to the value at the point @a ips[j] of the element
+       @a elem_ids[j], or to zero if @a elem_ids[j] is negative. */
+   void Interpolate(const Array<int> &elem_ids,
+                    const Array<IntegrationPoint> &ips,
+                    DenseMatrix &vals) const;
+
+   /** @brief Evaluate the GridFunction at the physical points given as the
+       columns of @a point_mat, see Mesh::FindPoints(). The values are returned
+       as the columns of @a vals, with zero values at the points that are not
+       in the mesh. Returns the number of points found. */
+   int Interpolate(const DenseMatrix &point_mat, DenseMatrix &vals,
+                   bool warn = true) const;
+
    void GetValuesFrom(GridFunction &);
 
    void GetBdrValuesFrom(GridFunction &);
@@ -332,6 +364,19 @@ public:
    /// Save the GridFunction to an output stream.
    virtual void Save(std::ostream &out) const;
 
+   /** @brief Save the GridFunction to an output stream in the binary format
+       "MFEM binary grid function v1.0".
+
+       The format stores the FiniteElementCollection name, the vector
+       dimension, the ordering and the values as little-endian data, at 8-byte
+       aligned offsets given in a fixed-size header, so that the values can be
+       used directly from a file mapped into memory. Binary grid functions can
+       also be read with GridFunction(Mesh*, std::istream&). */
+   void SaveBinary(std::ostream &out) const;
+
+   /// Returns the number of bytes written by SaveBinary().
+   long long BinarySize() const;
+
    /** Write the GridFunction in VTK format. Note that Mesh::PrintVTK must be
        called first. The parameter ref > 0 must match the one used in
        Mesh::PrintVTK. */
@@ -462,10 +507,36 @@ double ZZErrorEstimator(BilinearFormIntegrator &blfi,
                         Array<int> *aniso_flags = NULL,
                         int with_subdomains = 1);
 
+/** @brief Cheaper variant of ZZErrorEstimator() where the recovered flux is
+    linear on each element: the element fluxes are computed at the element
+    vertices only and averaged at the mesh vertices.
+
+    No flux FiniteElementSpace is needed and the fluxes are computed once per
+    element, instead of at all flux dofs and twice as in ZZErrorEstimator().
+    The integrator must support nodal flux elements in ComputeElementFlux(),
+    e.g. DiffusionIntegrator. The averaging at the vertices is local to the
+    (serial) mesh, i.e. it does not include the elements of other MPI ranks.
+    Returns the total error. */
+double VertexZZErrorEstimator(BilinearFormIntegrator &blfi,
+                              GridFunction &u,
+                              Vector &error_estimates,
+                              Array<int> *aniso_flags = NULL,
+                              int with_subdomains = 1);
+
 /// Compute the Lp distance between two grid functions on the given element.
 double ComputeElementLpDistance(double p, int i,
                                 GridFunction& gf1, GridFunction& gf2);
 
+/** @brief Compute the rigid body modes of the vector space @a fes, whose
+    vector dimension must be the space dimension, as the columns of @a modes:
+    the translations followed by the rotations (one in 2D, three in 3D).
+
+    The coordinates of the dofs are those of the mesh Nodes when @a fes is
+    their space, and the interpolant of the coordinates otherwise. The modes
+    are the near-nullspace of linear elasticity, see
+    SmoothedAggregationAMG::SetNearNullspace(). */
+void RigidBodyModes(FiniteElementSpace &fes, DenseMatrix &modes);
+
 
 /// Class used for extruding scalar GridFunctions
 class ExtrudeCoefficient : public Coefficient
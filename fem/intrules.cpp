@@ -833,6 +833,8 @@ IntegrationRules::IntegrationRules(int Ref, int _type):
 {
    refined = Ref;
 
+   for (int i = 0; i < 6; i++) { rule_tables[i] = NULL; }
+
    if (refined < 0) { own_rules = 0; return; }
 
    own_rules = 1;
@@ -858,69 +860,109 @@ IntegrationRules::IntegrationRules(int Ref, int _type):
    CubeIntRules = NULL;
 }
 
-const IntegrationRule &IntegrationRules::Get(int GeomType, int Order)
+Array<IntegrationRule *> *IntegrationRules::GetIntRuleArray(int GeomType)
 {
-   Array<IntegrationRule *> *ir_array;
-
    switch (GeomType)
    {
-      case Geometry::POINT:       ir_array = &PointIntRules; Order = 0; break;
-      case Geometry::SEGMENT:     ir_array = &SegmentIntRules; break;
-      case Geometry::TRIANGLE:    ir_array = &TriangleIntRules; break;
-      case Geometry::SQUARE:      ir_array = &SquareIntRules; break;
-      case Geometry::TETRAHEDRON: ir_array = &TetrahedronIntRules; break;
-      case Geometry::CUBE:        ir_array = &CubeIntRules; break;
+      case Geometry::POINT:       return &PointIntRules;
+      case Geometry::SEGMENT:     return &SegmentIntRules;
+      case Geometry::TRIANGLE:    return &TriangleIntRules;
+      case Geometry::SQUARE:      return &SquareIntRules;
+      case Geometry::TETRAHEDRON: return &TetrahedronIntRules;
+      case Geometry::CUBE:        return &CubeIntRules;
       default:
-         mfem_error("IntegrationRules::Get(...) : Unknown geometry type!");
-         ir_array = NULL;
+         MFEM_ABORT("Unknown geometry type: " << GeomType);
    }
+   return NULL;
+}
+
+void IntegrationRules::PublishIntRuleArray(int GeomType)
+{
+   // called inside the critical section of Get() and Set()
+   Array<IntegrationRule *> *table = new Array<IntegrationRule *>;
+   GetIntRuleArray(GeomType)->Copy(*table);
+   if (rule_tables[GeomType]) { old_tables.Append(rule_tables[GeomType]); }
+
+   // the copy must be complete before it becomes visible to readers
+#ifdef MFEM_USE_OPENMP
+   #pragma omp atomic write seq_cst
+#endif
+   rule_tables[GeomType] = table;
+}
 
-   if (Order < 0)
+const IntegrationRule &IntegrationRules::Get(int GeomType, int Order)
+{
+   if (GeomType == Geometry::POINT || Order < 0)
    {
       Order = 0;
    }
 
-   if (!HaveIntRule(*ir_array, Order))
+   // lock-free path: read the published copy of the rule array
+   const Array<IntegrationRule *> *table = NULL;
+   if (GeomType >= 0 && GeomType < 6)
    {
 #ifdef MFEM_USE_OPENMP
-      #pragma omp critical
+      #pragma omp atomic read seq_cst
 #endif
+      table = rule_tables[GeomType];
+   }
+   if (table && Order < table->Size() && (*table)[Order])
+   {
+      return *(*table)[Order];
+   }
+
+   const IntegrationRule *ir;
+#ifdef MFEM_USE_OPENMP
+   #pragma omp critical (IntegrationRules)
+#endif
+   {
+      Array<IntegrationRule *> *ir_array = GetIntRuleArray(GeomType);
+      if (!HaveIntRule(*ir_array, Order))
       {
-         if (!HaveIntRule(*ir_array, Order))
+         GenerateIntegrationRule(GeomType, Order);
+         PublishIntRuleArray(GeomType);
+      }
+      else
+      {
+         // the rule may have been generated as a by-product of another
+         // geometry (e.g. SEGMENT rules for SQUARE), without being published
+         table = rule_tables[GeomType];
+         if (!table || Order >= table->Size() || (*table)[Order] == NULL)
          {
-            GenerateIntegrationRule(GeomType, Order);
+            PublishIntRuleArray(GeomType);
          }
       }
+      ir = (*ir_array)[Order];
    }
-
-   return *(*ir_array)[Order];
+   return *ir;
 }
 
-void IntegrationRules::Set(int GeomType, int Order, IntegrationRule &IntRule)
+void IntegrationRules::Prepare(int GeomType, int MaxOrder)
 {
-   Array<IntegrationRule *> *ir_array;
-
-   switch (GeomType)
+   for (int order = 0; order <= MaxOrder; order++)
    {
-      case Geometry::POINT:       ir_array = &PointIntRules; break;
-      case Geometry::SEGMENT:     ir_array = &SegmentIntRules; break;
-      case Geometry::TRIANGLE:    ir_array = &TriangleIntRules; break;
-      case Geometry::SQUARE:      ir_array = &SquareIntRules; break;
-      case Geometry::TETRAHEDRON: ir_array = &TetrahedronIntRules; break;
-      case Geometry::CUBE:        ir_array = &CubeIntRules; break;
-      default:
-         mfem_error("IntegrationRules::Set(...) : Unknown geometry type!");
-         ir_array = NULL;
+      Get(GeomType, order);
    }
+}
 
-   if (HaveIntRule(*ir_array, Order))
+void IntegrationRules::Set(int GeomType, int Order, IntegrationRule &IntRule)
+{
+#ifdef MFEM_USE_OPENMP
+   #pragma omp critical (IntegrationRules)
+#endif
    {
-      MFEM_ABORT("Overwriting set rules is not supported!");
-   }
+      Array<IntegrationRule *> *ir_array = GetIntRuleArray(GeomType);
 
-   AllocIntRule(*ir_array, Order);
+      if (HaveIntRule(*ir_array, Order))
+      {
+         MFEM_ABORT("Overwriting set rules is not supported!");
+      }
+
+      AllocIntRule(*ir_array, Order);
 
-   (*ir_array)[Order] = &IntRule;
+      (*ir_array)[Order] = &IntRule;
+      PublishIntRuleArray(GeomType);
+   }
 }
 
 void IntegrationRules::DeleteIntRuleArray(Array<IntegrationRule *> &ir_array)
@@ -942,6 +984,9 @@ void IntegrationRules::DeleteIntRuleArray(Array<IntegrationRule *> &ir_array)
 
 IntegrationRules::~IntegrationRules()
 {
+   for (int i = 0; i < 6; i++) { delete rule_tables[i]; }
+   for (int i = 0; i < old_tables.Size(); i++) { delete old_tables[i]; }
+
    if (!own_rules) { return; }
 
    DeleteIntRuleArray(PointIntRules);
@@ -1459,6 +1504,7 @@ IntegrationRule *IntegrationRules::SquareIntegrationRule(int Order)
    if (!HaveIntRule(SegmentIntRules, RealOrder))
    {
       SegmentIntegrationRule(RealOrder);
+      PublishIntRuleArray(Geometry::SEGMENT);
    }
    AllocIntRule(SquareIntRules, RealOrder); // RealOrder >= Order
    SquareIntRules[RealOrder-1] =
@@ -1584,6 +1630,7 @@ IntegrationRule *IntegrationRules::CubeIntegrationRule(int Order)
    if (!HaveIntRule(SegmentIntRules, RealOrder))
    {
       SegmentIntegrationRule(RealOrder);
+      PublishIntRuleArray(Geometry::SEGMENT);
    }
    AllocIntRule(CubeIntRules, RealOrder);
    CubeIntRules[RealOrder-1] =
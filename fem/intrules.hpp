@@ -296,6 +296,16 @@ private:
    Array<IntegrationRule *> TetrahedronIntRules;
    Array<IntegrationRule *> CubeIntRules;
 
+   /** @brief Read-only copies of the rule arrays above, indexed by geometry
+       type, which Get() reads without locking.
+
+       The rule arrays are modified only inside a critical section; after each
+       modification, a new copy of the modified array is published here. The
+       replaced copies are kept in #old_tables until destruction because other
+       threads may still be reading them. */
+   Array<IntegrationRule *> *rule_tables[6];
+   Array<Array<IntegrationRule *> *> old_tables;
+
    void AllocIntRule(Array<IntegrationRule *> &ir_array, int Order)
    {
       if (ir_array.Size() <= Order)
@@ -320,6 +330,9 @@ private:
    IntegrationRule *TetrahedronIntegrationRule(int Order);
    IntegrationRule *CubeIntegrationRule(int Order);
 
+   Array<IntegrationRule *> *GetIntRuleArray(int GeomType);
+   void PublishIntRuleArray(int GeomType);
+
    void DeleteIntRuleArray(Array<IntegrationRule *> &ir_array);
 
 public:
@@ -328,9 +341,18 @@ public:
    explicit IntegrationRules(int Ref = 0,
                              int type = Quadrature1D::GaussLegendre);
 
-   /// Returns an integration rule for given GeomType and Order.
+   /** @brief Returns an integration rule for given GeomType and Order.
+
+       Rules are generated the first time they are requested. Requests for
+       existing rules do not lock and can be made concurrently by any number
+       of threads. */
    const IntegrationRule &Get(int GeomType, int Order);
 
+   /** @brief Generate the rules of orders 0 to @a MaxOrder for the given
+       geometry type, so that later calls to Get() with these orders, e.g. in
+       threaded assembly, only read the existing rules. */
+   void Prepare(int GeomType, int MaxOrder);
+
    void Set(int GeomType, int Order, IntegrationRule &IntRule);
 
    void SetOwnRules(int o) { own_rules = o; }
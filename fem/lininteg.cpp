@@ -29,9 +29,7 @@ void DomainLFIntegrator::AssembleRHSElementVect(const FiniteElement &el,
 {
    int dof = el.GetDof();
 
-   shape.SetSize(dof);       // vector of size dof
    elvect.SetSize(dof);
-   elvect = 0.0;
 
    const IntegrationRule *ir = IntRule;
    if (ir == NULL)
@@ -41,17 +39,19 @@ void DomainLFIntegrator::AssembleRHSElementVect(const FiniteElement &el,
       ir = &IntRules.Get(el.GetGeomType(), oa * el.GetOrder() + ob);
    }
 
+   // elvect = B qvals, where the columns of B are the values of the shape
+   // functions at the points, tabulated once per element type
+   DofToQuad nurbs_maps;
+   const DofToQuad &maps = el.GetDofToQuad(*ir, nurbs_maps);
+   qvals.SetSize(ir->GetNPoints());
    for (int i = 0; i < ir->GetNPoints(); i++)
    {
       const IntegrationPoint &ip = ir->IntPoint(i);
 
       Tr.SetIntPoint (&ip);
-      double val = Tr.Weight() * Q.Eval(Tr, ip);
-
-      el.CalcShape(ip, shape);
-
-      add(elvect, ip.weight * val, shape, elvect);
+      qvals(i) = ip.weight * Tr.Weight() * Q.Eval(Tr, ip);
    }
+   maps.B.Mult(qvals, elvect);
 }
 
 void BoundaryLFIntegrator::AssembleRHSElementVect(
@@ -59,9 +59,7 @@ void BoundaryLFIntegrator::AssembleRHSElementVect(
 {
    int dof = el.GetDof();
 
-   shape.SetSize(dof);        // vector of size dof
    elvect.SetSize(dof);
-   elvect = 0.0;
 
    const IntegrationRule *ir = IntRule;
    if (ir == NULL)
@@ -70,17 +68,18 @@ void BoundaryLFIntegrator::AssembleRHSElementVect(
       ir = &IntRules.Get(el.GetGeomType(), intorder);
    }
 
+   // elvect = B qvals, with the tabulated shape function values B
+   DofToQuad nurbs_maps;
+   const DofToQuad &maps = el.GetDofToQuad(*ir, nurbs_maps);
+   qvals.SetSize(ir->GetNPoints());
    for (int i = 0; i < ir->GetNPoints(); i++)
    {
       const IntegrationPoint &ip = ir->IntPoint(i);
 
       Tr.SetIntPoint (&ip);
-      double val = Tr.Weight() * Q.Eval(Tr, ip);
-
-      el.CalcShape(ip, shape);
-
-      add(elvect, ip.weight * val, shape, elvect);
+      qvals(i) = ip.weight * Tr.Weight() * Q.Eval(Tr, ip);
    }
+   maps.B.Mult(qvals, elvect);
 }
 
 void BoundaryNormalLFIntegrator::AssembleRHSElementVect(
@@ -161,12 +160,9 @@ void VectorDomainLFIntegrator::AssembleRHSElementVect(
    int vdim = Q.GetVDim();
    int dof  = el.GetDof();
 
-   double val,cf;
-
-   shape.SetSize(dof);       // vector of size dof
+   double val;
 
    elvect.SetSize(dof * vdim);
-   elvect = 0.0;
 
    const IntegrationRule *ir = IntRule;
    if (ir == NULL)
@@ -175,26 +171,28 @@ void VectorDomainLFIntegrator::AssembleRHSElementVect(
       ir = &IntRules.Get(el.GetGeomType(), intorder);
    }
 
-   for (int i = 0; i < ir->GetNPoints(); i++)
+   // elvect, as a dof x vdim matrix, is B qvals, with the tabulated shape
+   // function values B and the weighted coefficient values qvals (nq x vdim)
+   DofToQuad nurbs_maps;
+   const DofToQuad &maps = el.GetDofToQuad(*ir, nurbs_maps);
+   const int nq = ir->GetNPoints();
+   qvals.SetSize(nq, vdim);
+   for (int i = 0; i < nq; i++)
    {
       const IntegrationPoint &ip = ir->IntPoint(i);
 
       Tr.SetIntPoint (&ip);
-      val = Tr.Weight();
+      val = ip.weight * Tr.Weight();
 
-      el.CalcShape(ip, shape);
       Q.Eval (Qvec, Tr, ip);
 
       for (int k = 0; k < vdim; k++)
       {
-         cf = val * Qvec(k);
-
-         for (int s = 0; s < dof; s++)
-         {
-            elvect(dof*k+s) += ip.weight * cf * shape(s);
-         }
+         qvals(i,k) = val * Qvec(k);
       }
    }
+   DenseMatrix elmat(elvect.GetData(), dof, vdim);
+   Mult(maps.B, qvals, elmat);
 }
 
 void VectorBoundaryLFIntegrator::AssembleRHSElementVect(
@@ -46,7 +46,7 @@ public:
 /// Class for domain integration L(v) := (f, v)
 class DomainLFIntegrator : public LinearFormIntegrator
 {
-   Vector shape;
+   Vector qvals;
    Coefficient &Q;
    int oa, ob;
 public:
@@ -72,7 +72,7 @@ public:
 /// Class for boundary integration L(v) := (g, v)
 class BoundaryLFIntegrator : public LinearFormIntegrator
 {
-   Vector shape;
+   Vector qvals;
    Coefficient &Q;
    int oa, ob;
 public:
@@ -130,7 +130,8 @@ public:
 class VectorDomainLFIntegrator : public LinearFormIntegrator
 {
 private:
-   Vector shape, Qvec;
+   Vector Qvec;
+   DenseMatrix qvals;
    VectorCoefficient &Q;
 
 public:
@@ -684,6 +684,144 @@ double L2ZZErrorEstimator(BilinearFormIntegrator &flux_integrator,
    return pow(glob_error, 1.0/norm_p);
 }
 
+
+int ParRebalancer::ElementDataSize(int i) const
+{
+   int size = 0;
+   Array<int> vdofs;
+   for (int k = 0; k < gridfuncs.Size(); k++)
+   {
+      gridfuncs[k]->ParFESpace()->GetElementVDofs(i, vdofs);
+      size += vdofs.Size();
+   }
+   for (int k = 0; k < quadfuncs.Size(); k++)
+   {
+      QuadratureFunction *qf = quadfuncs[k];
+      size += qf->GetElementIntRule(i).GetNPoints() * qf->GetVDim();
+   }
+   return size;
+}
+
+void ParRebalancer::GetElementData(int i, double *data) const
+{
+   Array<int> vdofs;
+   Vector values;
+   for (int k = 0; k < gridfuncs.Size(); k++)
+   {
+      const ParGridFunction &gf = *gridfuncs[k];
+      gf.ParFESpace()->GetElementVDofs(i, vdofs);
+      for (int j = 0; j < vdofs.Size(); j++)
+      {
+         // copy the values without the DOF signs, see RebalanceMatrix()
+         const int vdof = vdofs[j];
+         *(data++) = gf((vdof >= 0) ? vdof : -1-vdof);
+      }
+   }
+   for (int k = 0; k < quadfuncs.Size(); k++)
+   {
+      quadfuncs[k]->GetElementValues(i, values);
+      for (int j = 0; j < values.Size(); j++)
+      {
+         *(data++) = values(j);
+      }
+   }
+}
+
+void ParRebalancer::SetElementData(int i, const double *data)
+{
+   Array<int> vdofs;
+   Vector values;
+   for (int k = 0; k < gridfuncs.Size(); k++)
+   {
+      ParGridFunction &gf = *gridfuncs[k];
+      gf.ParFESpace()->GetElementVDofs(i, vdofs);
+      for (int j = 0; j < vdofs.Size(); j++)
+      {
+         const int vdof = vdofs[j];
+         gf((vdof >= 0) ? vdof : -1-vdof) = *(data++);
+      }
+   }
+   for (int k = 0; k < quadfuncs.Size(); k++)
+   {
+      // 'values' is a reference to the data of the QuadratureFunction
+      quadfuncs[k]->GetElementValues(i, values);
+      for (int j = 0; j < values.Size(); j++)
+      {
+         values(j) = *(data++);
+      }
+   }
+}
+
+void ParRebalancer::Rebalance(const Vector *elem_weights)
+{
+   ParNCMesh *pncmesh = pmesh->pncmesh;
+   MFEM_VERIFY(pncmesh, "Load balancing is currently not supported for "
+               "conforming meshes.");
+
+   // pack the data of the old elements while the old spaces still exist
+   const int old_ne = pmesh->GetNE();
+   Array<int> old_offsets(old_ne + 1);
+   old_offsets[0] = 0;
+   for (int i = 0; i < old_ne; i++)
+   {
+      old_offsets[i+1] = old_offsets[i] + ElementDataSize(i);
+   }
+   Vector old_data(old_offsets[old_ne]);
+   for (int i = 0; i < old_ne; i++)
+   {
+      GetElementData(i, old_data.GetData() + old_offsets[i]);
+   }
+
+   if (elem_weights) { pmesh->Rebalance(*elem_weights); }
+   else { pmesh->Rebalance(); }
+
+   // send the data of the elements we gave away, using the communication
+   // pattern recorded by ParNCMesh::Rebalance()
+   pncmesh->SendRebalanceData(old_offsets, old_data);
+
+   // update the spaces without the transfer operators, then the fields; this
+   // only resizes them, their values are set below
+   for (int k = 0; k < gridfuncs.Size(); k++)
+   {
+      gridfuncs[k]->ParFESpace()->Update(false);
+      gridfuncs[k]->Update();
+   }
+   Array<QuadratureSpace*> qspaces;
+   for (int k = 0; k < quadfuncs.Size(); k++)
+   {
+      QuadratureSpace *qspace = quadfuncs[k]->GetSpace();
+      if (qspaces.Find(qspace) < 0)
+      {
+         qspace->Update();
+         qspaces.Append(qspace);
+      }
+      quadfuncs[k]->SetSpace(qspace);
+   }
+
+   // copy the data of the elements we kept
+   const Array<int> &old_index = pncmesh->GetRebalanceOldIndex();
+   for (int i = 0; i < pmesh->GetNE(); i++)
+   {
+      if (old_index[i] >= 0)
+      {
+         SetElementData(i, old_data.GetData() + old_offsets[old_index[i]]);
+      }
+   }
+
+   // receive the data of the elements we obtained from others
+   Array<int> new_elements;
+   Vector new_data;
+   pncmesh->RecvRebalanceData(new_elements, new_data);
+
+   int pos = 0;
+   for (int i = 0; i < new_elements.Size(); i++)
+   {
+      SetElementData(new_elements[i], new_data.GetData() + pos);
+      pos += ElementDataSize(new_elements[i]);
+   }
+   MFEM_VERIFY(pos == new_data.Size(), "invalid size of the received data");
+}
+
 }
 
 #endif // MFEM_USE_MPI
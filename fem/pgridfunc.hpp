@@ -289,6 +289,54 @@ double L2ZZErrorEstimator(BilinearFormIntegrator &flux_integrator,
                           Vector &errors, int norm_p = 2, double solver_tol = 1e-12,
                           int solver_max_it = 200);
 
+
+/** @brief Load balancing of a nonconforming ParMesh that migrates the data of
+    several ParGridFunction%s and QuadratureFunction%s together.
+
+    The values of all registered fields on each element are packed together,
+    so the data of all fields is migrated in a single message exchange,
+    instead of one exchange per space in ParFiniteElementSpace::Update() plus
+    one parallel matrix-vector product per ParGridFunction::Update().
+
+    Usage: register the fields with Register() and call Rebalance() instead of
+    ParMesh::Rebalance(). Rebalance() also updates the spaces of the registered
+    fields (without transfer operators) and the fields themselves. The values
+    of the registered ParGridFunction%s are copied element by element, i.e. the
+    DOFs that are not in any local element are not transferred, as in
+    ParFiniteElementSpace::RebalanceMatrix(). */
+class ParRebalancer
+{
+protected:
+   ParMesh *pmesh; ///< Not owned.
+   Array<ParGridFunction*> gridfuncs; ///< Not owned.
+   Array<QuadratureFunction*> quadfuncs; ///< Not owned.
+
+   /// Return the number of values of all registered fields on element @a i.
+   int ElementDataSize(int i) const;
+
+   /// Copy the values of all registered fields on element @a i to @a data.
+   void GetElementData(int i, double *data) const;
+
+   /// Set the values of all registered fields on element @a i from @a data.
+   void SetElementData(int i, const double *data);
+
+public:
+   ParRebalancer(ParMesh &pmesh) : pmesh(&pmesh) { }
+
+   /// Migrate @a gf in Rebalance(). Its space must be defined on the ParMesh.
+   void Register(ParGridFunction &gf) { gridfuncs.Append(&gf); }
+
+   /// Migrate @a qf in Rebalance(). Its space must be defined on the ParMesh.
+   void Register(QuadratureFunction &qf) { quadfuncs.Append(&qf); }
+
+   /** @brief Rebalance the ParMesh and migrate the registered fields.
+
+       If @a elem_weights is not NULL, it contains a weight (cost) for each
+       local element and the partition balances the total weight, see
+       ParNCMesh::Rebalance(). */
+   void Rebalance(const Vector *elem_weights = NULL);
+};
+
 }
 
 #endif // MFEM_USE_MPI
@@ -0,0 +1,107 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "binaryio.hpp"
+#include "error.hpp"
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define MFEM_HAVE_MMAP
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace mfem
+{
+
+namespace bin_io
+{
+
+void WriteIdent(std::ostream &out, const char *ident)
+{
+   const size_t len = std::strlen(ident);
+   MFEM_ASSERT(len < 32 && ident[len-1] == '\n', "invalid ident: " << ident);
+   out.write(ident, len);
+   WritePadding(out, 32 - len);
+}
+
+void ReadBlock(std::istream &in, const char *ident, int num_fields,
+               char *&buf, long long &size)
+{
+   const size_t len = std::strlen(ident);
+   const long long header_size = 32 + 8*num_fields;
+
+   // the identification string, without the padding, was already read
+   char header[256];
+   MFEM_ASSERT(header_size <= 256, "header too large");
+   std::memcpy(header, ident, len);
+   in.read(header + len, header_size - len);
+   MFEM_VERIFY(in.good(), "error reading the binary header");
+
+   ReadLittleEndian(header + 32, &size, 1);
+   MFEM_VERIFY(size >= header_size, "invalid binary block size: " << size);
+
+   buf = new char[size];
+   std::memcpy(buf, header, header_size);
+   in.read(buf + header_size, size - header_size);
+   MFEM_VERIFY(in.good(), "error reading the binary data");
+}
+
+}
+
+MappedFile::MappedFile(const char *filename)
+   : data(NULL), size(0), mapped(false)
+{
+#ifdef MFEM_HAVE_MMAP
+   int fd = open(filename, O_RDONLY);
+   MFEM_VERIFY(fd >= 0, "can not open file: " << filename);
+   struct stat st;
+   MFEM_VERIFY(fstat(fd, &st) == 0, "can not stat file: " << filename);
+   size = st.st_size;
+   if (size > 0)
+   {
+      void *addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+      if (addr != MAP_FAILED)
+      {
+         data = static_cast<char *>(addr);
+         mapped = true;
+      }
+   }
+   close(fd);
+   if (mapped || size == 0) { return; }
+#endif
+
+   // read the whole file into a buffer
+   std::ifstream in(filename, std::ios::in | std::ios::binary);
+   MFEM_VERIFY(in, "can not open file: " << filename);
+   in.seekg(0, std::ios::end);
+   size = in.tellg();
+   in.seekg(0, std::ios::beg);
+   data = new char[size];
+   in.read(data, size);
+   MFEM_VERIFY(in.good() || size == 0, "error reading file: " << filename);
+}
+
+MappedFile::~MappedFile()
+{
+#ifdef MFEM_HAVE_MMAP
+   if (mapped)
+   {
+      munmap(data, size);
+      return;
+   }
+#endif
+   delete [] data;
+}
+
+}
@@ -0,0 +1,143 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_BINARYIO
+#define MFEM_BINARYIO
+
+#include "../config/config.hpp"
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <cstddef>
+
+namespace mfem
+{
+
+/// Helper functions for the binary file formats of Mesh and GridFunction.
+namespace bin_io
+{
+
+/// Returns true if the byte order of the host is little-endian.
+inline bool IsLittleEndian()
+{
+   const int one = 1;
+   return (*reinterpret_cast<const char *>(&one) == 1);
+}
+
+/// Reverse the byte order of the @a n values in @a data.
+template <typename T>
+inline void SwapBytes(T *data, size_t n)
+{
+   for (size_t i = 0; i < n; i++)
+   {
+      char *b = reinterpret_cast<char *>(data + i);
+      for (size_t j = 0; j < sizeof(T)/2; j++)
+      {
+         std::swap(b[j], b[sizeof(T)-1-j]);
+      }
+   }
+}
+
+/// Write the @a n values in @a data to @a out in little-endian byte order.
+template <typename T>
+inline void WriteLittleEndian(std::ostream &out, const T *data, size_t n)
+{
+   if (IsLittleEndian())
+   {
+      out.write(reinterpret_cast<const char *>(data), n*sizeof(T));
+      return;
+   }
+   for (size_t i = 0; i < n; i++)
+   {
+      T v = data[i];
+      SwapBytes(&v, 1);
+      out.write(reinterpret_cast<const char *>(&v), sizeof(T));
+   }
+}
+
+/** @brief Copy the @a n little-endian values stored at @a buf to @a data,
+    converting them to the byte order of the host. */
+template <typename T>
+inline void ReadLittleEndian(const char *buf, T *data, size_t n)
+{
+   std::memcpy(data, buf, n*sizeof(T));
+   if (!IsLittleEndian()) { SwapBytes(data, n); }
+}
+
+/// Write @a n zero bytes to @a out.
+inline void WritePadding(std::ostream &out, size_t n)
+{
+   const char zeros[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+   for ( ; n > 8; n -= 8) { out.write(zeros, 8); }
+   out.write(zeros, n);
+}
+
+/** @brief Round up @a offset to a multiple of 8 bytes, the alignment of all
+    sections in the binary formats. */
+inline long long Align(long long offset) { return (offset + 7) & ~7LL; }
+
+/** @brief Write the identification string @a ident of a binary format,
+    padded with zeros to 32 bytes. The string must end with a newline, so that
+    it can be read with std::getline(). */
+void WriteIdent(std::ostream &out, const char *ident);
+
+/** @brief Read the rest of a binary block from @a in, after its
+    identification string @a ident was read with std::getline().
+
+    The block starts with the 32 bytes of @a ident, followed by @a num_fields
+    little-endian 64-bit integers, the first of which is the size of the block
+    in bytes. On return, @a buf holds the whole block; its storage must be
+    released with delete []. */
+void ReadBlock(std::istream &in, const char *ident, int num_fields,
+               char *&buf, long long &size);
+
+}
+
+/** @brief A file mapped into memory, used to load the binary Mesh and
+    GridFunction formats without copying their data.
+
+    On POSIX systems, the file is mapped with mmap() as a private (copy on
+    write) mapping: the data can be modified in memory, but the changes are
+    not written to the file. On other systems, the file is read into a buffer.
+    Objects that use the data of the file without copying it, see e.g.
+    GridFunction::GridFunction(Mesh*, MappedFile&), must be destroyed before
+    the MappedFile. */
+class MappedFile
+{
+private:
+   char *data;
+   size_t size;
+   bool mapped;
+
+   // not copyable
+   MappedFile(const MappedFile &);
+   MappedFile &operator=(const MappedFile &);
+
+public:
+   /// Map the file @a filename into memory.
+   explicit MappedFile(const char *filename);
+
+   /// Returns the address of the first byte of the file.
+   char *GetData() { return data; }
+   const char *GetData() const { return data; }
+
+   /// Returns the size of the file in bytes.
+   size_t Size() const { return size; }
+
+   /// Returns true if the file is mapped with mmap().
+   bool IsMapped() const { return mapped; }
+
+   ~MappedFile();
+};
+
+}
+
+#endif
@@ -268,6 +268,11 @@ GroupCommunicator::GroupCommunicator(GroupTopology &gt)
    group_buf_size = 0;
    requests = NULL;
    statuses = NULL;
+   comm_lock = 0;
+   num_requests = 0;
+   comm_data = NULL;
+   comm_type = MPI_DATATYPE_NULL;
+   comm_layout = -1;
 }
 
 void GroupCommunicator::Create(Array<int> &ldof_group)
@@ -317,19 +322,23 @@ void GroupCommunicator::Finalize()
          group_buf_size += gr_requests * group_ldof.RowSize(gr);
       }
 
+   // allocate the persistent buffer for the largest instantiated type
+   group_buf.SetSize(group_buf_size*sizeof(double));
+
    requests = new MPI_Request[request_counter];
    statuses = new MPI_Status[request_counter];
 }
 
 template <class T>
-void GroupCommunicator::Bcast(T *ldata, int layout)
+void GroupCommunicator::BcastBegin(T *ldata, int layout)
 {
+   MFEM_VERIFY(comm_lock == 0, "a split-phase operation is already pending");
+
    if (group_buf_size == 0) { return; }
 
    T *buf;
    if (layout == 0)
    {
-      group_buf.SetSize(group_buf_size*sizeof(T));
       buf = (T *)group_buf.GetData();
    }
    else
@@ -389,13 +398,32 @@ void GroupCommunicator::Bcast(T *ldata, int layout)
       buf += nldofs;
    }
 
-   MPI_Waitall(request_counter, requests, statuses);
+   comm_lock = 1;
+   num_requests = request_counter;
+   comm_data = ldata;
+   comm_type = MPITypeMap<T>::mpi_type;
+   comm_layout = layout;
+}
+
+template <class T>
+void GroupCommunicator::BcastEnd(T *ldata, int layout)
+{
+   if (group_buf_size == 0) { return; }
+
+   MFEM_VERIFY(comm_lock == 1, "BcastBegin was not called");
+   MFEM_VERIFY(comm_data == ldata && comm_type == MPITypeMap<T>::mpi_type &&
+               comm_layout == layout, "BcastEnd must be called with the data, "
+               "type, and layout given to BcastBegin");
+
+   MPI_Waitall(num_requests, requests, statuses);
+   comm_lock = 0;
+   num_requests = 0;
 
    if (layout == 0)
    {
       // copy the received data from the buffer to ldata
-      buf = (T *)group_buf.GetData();
-      for (gr = 1; gr < group_ldof.Size(); gr++)
+      T *buf = (T *)group_buf.GetData();
+      for (int gr = 1; gr < group_ldof.Size(); gr++)
       {
          const int nldofs = group_ldof.RowSize(gr);
 
@@ -405,7 +433,7 @@ void GroupCommunicator::Bcast(T *ldata, int layout)
          if (!gtopo.IAmMaster(gr)) // we are not the master
          {
             const int *ldofs = group_ldof.GetRow(gr);
-            for (i = 0; i < nldofs; i++)
+            for (int i = 0; i < nldofs; i++)
             {
                ldata[ldofs[i]] = buf[i];
             }
@@ -416,41 +444,39 @@ void GroupCommunicator::Bcast(T *ldata, int layout)
 }
 
 template <class T>
-void GroupCommunicator::Reduce(T *ldata, void (*Op)(OpData<T>))
+void GroupCommunicator::ReduceBegin(const T *ldata)
 {
+   MFEM_VERIFY(comm_lock == 0, "a split-phase operation is already pending");
+
    if (group_buf_size == 0) { return; }
 
    int i, gr, request_counter = 0;
-   OpData<T> opd;
+   T *buf = (T *)group_buf.GetData();
 
-   group_buf.SetSize(group_buf_size*sizeof(T));
-   opd.ldata = ldata;
-   opd.buf = (T *)group_buf.GetData();
    for (gr = 1; gr < group_ldof.Size(); gr++)
    {
-      opd.nldofs = group_ldof.RowSize(gr);
+      const int nldofs = group_ldof.RowSize(gr);
 
       // ignore groups without dofs
-      if (opd.nldofs == 0) { continue; }
-
-      opd.ldofs = group_ldof.GetRow(gr);
+      if (nldofs == 0) { continue; }
 
       if (!gtopo.IAmMaster(gr)) // we are not the master
       {
-         for (i = 0; i < opd.nldofs; i++)
+         const int *ldofs = group_ldof.GetRow(gr);
+         for (i = 0; i < nldofs; i++)
          {
-            opd.buf[i] = ldata[opd.ldofs[i]];
+            buf[i] = ldata[ldofs[i]];
          }
 
-         MPI_Isend(opd.buf,
-                   opd.nldofs,
+         MPI_Isend(buf,
+                   nldofs,
                    MPITypeMap<T>::mpi_type,
                    gtopo.GetGroupMasterRank(gr),
                    43822 + gtopo.GetGroupMasterGroup(gr),
                    gtopo.GetComm(),
                    &requests[request_counter]);
          request_counter++;
-         opd.buf += opd.nldofs;
+         buf += nldofs;
       }
       else // we are the master
       {
@@ -460,25 +486,46 @@ void GroupCommunicator::Reduce(T *ldata, void (*Op)(OpData<T>))
          {
             if (nbs[i] != 0)
             {
-               MPI_Irecv(opd.buf,
-                         opd.nldofs,
+               MPI_Irecv(buf,
+                         nldofs,
                          MPITypeMap<T>::mpi_type,
                          gtopo.GetNeighborRank(nbs[i]),
                          43822 + gtopo.GetGroupMasterGroup(gr),
                          gtopo.GetComm(),
                          &requests[request_counter]);
                request_counter++;
-               opd.buf += opd.nldofs;
+               buf += nldofs;
             }
          }
       }
    }
 
-   MPI_Waitall(request_counter, requests, statuses);
+   comm_lock = 2;
+   num_requests = request_counter;
+   comm_data = ldata;
+   comm_type = MPITypeMap<T>::mpi_type;
+   comm_layout = 0;
+}
+
+template <class T>
+void GroupCommunicator::ReduceEnd(T *ldata, void (*Op)(OpData<T>))
+{
+   if (group_buf_size == 0) { return; }
+
+   MFEM_VERIFY(comm_lock == 2, "ReduceBegin was not called");
+   MFEM_VERIFY(comm_data == ldata && comm_type == MPITypeMap<T>::mpi_type,
+               "ReduceEnd must be called with the data and type given to "
+               "ReduceBegin");
+
+   MPI_Waitall(num_requests, requests, statuses);
+   comm_lock = 0;
+   num_requests = 0;
 
    // perform the reduce operation
+   OpData<T> opd;
+   opd.ldata = ldata;
    opd.buf = (T *)group_buf.GetData();
-   for (gr = 1; gr < group_ldof.Size(); gr++)
+   for (int gr = 1; gr < group_ldof.Size(); gr++)
    {
       opd.nldofs = group_ldof.RowSize(gr);
 
@@ -572,13 +619,17 @@ GroupCommunicator::~GroupCommunicator()
 // @cond DOXYGEN_SKIP
 
 // instantiate GroupCommunicator::Bcast and Reduce for int and double
-template void GroupCommunicator::Bcast<int>(int *);
-template void GroupCommunicator::Bcast<int>(int *, int);
-template void GroupCommunicator::Reduce<int>(int *, void (*)(OpData<int>));
-
-template void GroupCommunicator::Bcast<double>(double *);
-template void GroupCommunicator::Bcast<double>(double *, int);
-template void GroupCommunicator::Reduce<double>(
+// (the split-phase methods, the blocking ones are inline)
+template void GroupCommunicator::BcastBegin<int>(int *, int);
+template void GroupCommunicator::BcastEnd<int>(int *, int);
+template void GroupCommunicator::ReduceBegin<int>(const int *);
+template void GroupCommunicator::ReduceEnd<int>(
+   int *, void (*)(OpData<int>));
+
+template void GroupCommunicator::BcastBegin<double>(double *, int);
+template void GroupCommunicator::BcastEnd<double>(double *, int);
+template void GroupCommunicator::ReduceBegin<double>(const double *);
+template void GroupCommunicator::ReduceEnd<double>(
    double *, void (*)(OpData<double>));
 
 // @endcond
@@ -123,6 +123,15 @@ private:
    Array<char> group_buf;
    MPI_Request *requests;
    MPI_Status  *statuses;
+   /// Pending split-phase operation: 0 - none, 1 - Bcast, 2 - Reduce
+   int comm_lock;
+   /// Number of requests posted by the pending split-phase operation
+   int num_requests;
+   /** Data pointer, MPI type, and layout given to the Begin method of the
+       pending split-phase operation; verified by the End method. */
+   const void *comm_data;
+   MPI_Datatype comm_type;
+   int comm_layout;
 
 public:
    GroupCommunicator(GroupTopology &gt);
@@ -132,7 +141,9 @@ public:
    /** Fill-in the returned Table reference to initialize the communicator
        then call Finalize. */
    Table &GroupLDofTable() { return group_ldof; }
-   /// Allocate internal buffers after the GroupLDofTable is defined
+   /** Allocate internal buffers after the GroupLDofTable is defined. The
+       buffer is large enough for int and double data, so that it is reused
+       by all Bcast and Reduce operations. */
    void Finalize();
 
    /// Get a reference to the group topology object
@@ -144,7 +155,27 @@ public:
           0 - data is an array on all ldofs
           1 - data is an array on the shared ldofs as given by group_ldof
    */
-   template <class T> void Bcast(T *data, int layout);
+   template <class T> void Bcast(T *data, int layout)
+   { BcastBegin(data, layout); BcastEnd(data, layout); }
+
+   /** @brief Begin a split-phase broadcast: the shared data of the groups
+       where we are the master is packed and sent, and the receives of the
+       other groups are posted.
+
+       After this call, the caller may overlap local work with the
+       communication, e.g. the action of a matrix-free operator on the
+       interior elements. With @a layout 0, the data sent by the master is
+       packed into an internal buffer and may be modified after this call.
+       With @a layout 1, @a data itself is sent, so it must not be modified
+       until BcastEnd(). In both cases, the ldofs received from other
+       processors must not be accessed until BcastEnd() is called with the
+       same @a data and @a layout. Only one split-phase operation can be
+       pending at a time. This method is instantiated for int and double. */
+   template <class T> void BcastBegin(T *data, int layout);
+
+   /** @brief Complete the broadcast started by BcastBegin(): wait for the
+       messages and copy the received data to the non-master ldofs. */
+   template <class T> void BcastEnd(T *data, int layout);
 
    /** @brief Broadcast within each group where the master is the root.
        This method is instantiated for int and double. */
@@ -166,10 +197,26 @@ public:
        The reduce operation is given by the second argument (see below for list
        of the supported operations.) This method is instantiated for int and
        double. */
-   template <class T> void Reduce(T *ldata, void (*Op)(OpData<T>));
+   template <class T> void Reduce(T *ldata, void (*Op)(OpData<T>))
+   { ReduceBegin(ldata); ReduceEnd(ldata, Op); }
    template <class T> void Reduce(Array<T> &ldata, void (*Op)(OpData<T>))
    { Reduce<T>((T *)ldata, Op); }
 
+   /** @brief Begin a split-phase reduce: the data of the groups where we are
+       not the master is packed and sent, and the receives of the groups
+       where we are the master are posted.
+
+       After this call, @a ldata may be modified, except for the ldofs of the
+       groups where we are the master, which are combined with the received
+       data in ReduceEnd(). Only one split-phase operation can be pending at a
+       time. This method is instantiated for int and double. */
+   template <class T> void ReduceBegin(const T *ldata);
+
+   /** @brief Complete the reduce started by ReduceBegin(): wait for the
+       messages and apply the reduce operation @a Op to the ldofs of the
+       groups where we are the master. */
+   template <class T> void ReduceEnd(T *ldata, void (*Op)(OpData<T>));
+
    /// Reduce operation Sum, instantiated for int and double
    template <class T> static void Sum(OpData<T>);
    /// Reduce operation Min, instantiated for int and double
@@ -465,6 +465,45 @@ void Transpose(const Array<int> &A, Table &At, int _ncols_A)
    At.ShiftUpI();
 }
 
+void GreedyColoring(const Table &A, Table &colors, int _ncols_A)
+{
+   const int *i_A     = A.GetI();
+   const int *j_A     = A.GetJ();
+   const int  nrows_A = A.Size();
+
+   Table At;
+   Transpose(A, At, _ncols_A);
+   const int *i_At = At.GetI();
+   const int *j_At = At.GetJ();
+
+   // color_marker[c] == i means that color c is used by a neighbor of row i
+   Array<int> row_color(nrows_A), color_marker;
+   row_color = -1;
+   int num_colors = 0;
+   for (int i = 0; i < nrows_A; i++)
+   {
+      for (int j = i_A[i]; j < i_A[i+1]; j++)
+      {
+         const int col = j_A[j];
+         for (int k = i_At[col]; k < i_At[col+1]; k++)
+         {
+            const int c = row_color[j_At[k]];
+            if (c >= 0) { color_marker[c] = i; }
+         }
+      }
+      int c = 0;
+      while (c < num_colors && color_marker[c] == i) { c++; }
+      if (c == num_colors)
+      {
+         color_marker.Append(-1);
+         num_colors++;
+      }
+      row_color[i] = c;
+   }
+
+   Transpose(row_color, colors, num_colors);
+}
+
 void Mult (const Table &A, const Table &B, Table &C)
 {
    int  i, j, k, l, m;
@@ -175,6 +175,14 @@ void Transpose(const Array<int> &A, Table &At, int _ncols_A = -1);
 void Mult (const Table &A, const Table &B, Table &C);
 Table * Mult (const Table &A, const Table &B);
 
+/** @brief Greedy coloring of the rows of @a A such that rows with the same
+    color have no common columns.
+
+    On return, row `c` of the Table @a colors lists (in increasing order) the
+    rows of @a A with color `c`. This is useful, e.g., for thread-parallel
+    assembly, where rows of @a A are elements and columns are dofs. */
+void GreedyColoring(const Table &A, Table &colors, int _ncols_A = -1);
+
 
 /** Data type STable. STable is similar to Table, but it's for symmetric
     connectivity, i.e. TYPE I is equivalent to TYPE II. In the first
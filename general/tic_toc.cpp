@@ -395,6 +395,9 @@ inline double StopWatch::SystTime()
 #endif
 }
 
+// Flop counter used by the template classes, see config/tconfig.hpp.
+long long flop_count;
+
 } // namespace internal
 
 
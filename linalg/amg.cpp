@@ -0,0 +1,439 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "linalg.hpp"
+#include <iostream>
+#include <cmath>
+
+namespace mfem
+{
+
+SmoothedAggregationAMG::SmoothedAggregationAMG()
+   : theta(0.05), coarse_size(500), max_levels(10),
+     smoother_type(GAUSS_SEIDEL), smoother_order(2), print_level(0),
+     block_size(1), interleaved(false), coarse_prec(NULL)
+{ }
+
+void SmoothedAggregationAMG::SetSystemsOptions(int bs, bool intl)
+{
+   MFEM_VERIFY(bs > 0, "invalid number of components: " << bs);
+   block_size = bs;
+   interleaved = intl;
+   nullspace.SetSize(0);
+}
+
+void SmoothedAggregationAMG::SetNearNullspace(const DenseMatrix &B, int bs,
+                                              bool intl)
+{
+   SetSystemsOptions(bs, intl);
+   nullspace = B;
+}
+
+int SmoothedAggregationAMG::Aggregate(const SparseMatrix &A, int bs,
+                                      bool intl, Array<int> &aggregates) const
+{
+   const int n = A.Height(), nn = n/bs;
+   const int *I = A.GetI(), *J = A.GetJ();
+   const double *V = A.GetData();
+   MFEM_VERIFY(nn*bs == n, "the size of the matrix, " << n << ", is not a"
+               " multiple of the number of components, " << bs);
+
+   // Squared Frobenius norms of the node blocks: the entries of the node
+   // matrix, accumulated with a marker array for each node row.
+   Array<int> node_I(nn+1), node_J;
+   Array<double> node_V;
+   Vector node_diag(nn);
+   Array<int> pos(nn);
+   pos = -1;
+   node_I[0] = 0;
+   for (int i = 0; i < nn; i++)
+   {
+      const int start = node_J.Size();
+      node_diag(i) = 0.0;
+      for (int c = 0; c < bs; c++)
+      {
+         const int r = intl ? i*bs + c : c*nn + i;
+         for (int k = I[r]; k < I[r+1]; k++)
+         {
+            const int j = intl ? J[k]/bs : J[k] % nn;
+            const double a2 = V[k]*V[k];
+            if (j == i) { node_diag(i) += a2; continue; }
+            if (pos[j] < start)
+            {
+               pos[j] = node_J.Size();
+               node_J.Append(j);
+               node_V.Append(0.0);
+            }
+            node_V[pos[j]] += a2;
+         }
+      }
+      node_I[i+1] = node_J.Size();
+      node_diag(i) = sqrt(node_diag(i));
+   }
+   for (int k = 0; k < node_V.Size(); k++) { node_V[k] = sqrt(node_V[k]); }
+
+   // Strong connections: |a_ij| > theta sqrt(|a_ii a_jj|)
+   Array<int> S_I(nn+1), S_J;
+   S_I[0] = 0;
+   for (int i = 0; i < nn; i++)
+   {
+      for (int k = node_I[i]; k < node_I[i+1]; k++)
+      {
+         const int j = node_J[k];
+         if (node_V[k] > theta*sqrt(node_diag(i)*node_diag(j)))
+         {
+            S_J.Append(j);
+         }
+      }
+      S_I[i+1] = S_J.Size();
+   }
+
+   // -1: without strong connections, -2: not aggregated yet
+   aggregates.SetSize(nn);
+   for (int i = 0; i < nn; i++)
+   {
+      aggregates[i] = (S_I[i+1] > S_I[i]) ? -2 : -1;
+   }
+
+   // Phase 1: the nodes whose strong neighbors are all free form an aggregate
+   // with them.
+   int num_aggregates = 0;
+   for (int i = 0; i < nn; i++)
+   {
+      if (aggregates[i] != -2) { continue; }
+      bool free_nbrs = true;
+      for (int k = S_I[i]; k < S_I[i+1]; k++)
+      {
+         if (aggregates[S_J[k]] >= 0) { free_nbrs = false; break; }
+      }
+      if (!free_nbrs) { continue; }
+      aggregates[i] = num_aggregates;
+      for (int k = S_I[i]; k < S_I[i+1]; k++)
+      {
+         aggregates[S_J[k]] = num_aggregates;
+      }
+      num_aggregates++;
+   }
+
+   // Phase 2: the remaining nodes join the aggregate of their strongest
+   // aggregated neighbor, as assigned in phase 1.
+   Array<int> phase1;
+   aggregates.Copy(phase1);
+   for (int i = 0; i < nn; i++)
+   {
+      if (aggregates[i] != -2) { continue; }
+      double max_a = -1.0;
+      for (int k = node_I[i]; k < node_I[i+1]; k++)
+      {
+         const int j = node_J[k];
+         if (phase1[j] >= 0 && node_V[k] > max_a &&
+             node_V[k] > theta*sqrt(node_diag(i)*node_diag(j)))
+         {
+            max_a = node_V[k];
+            aggregates[i] = phase1[j];
+         }
+      }
+   }
+
+   // Phase 3: the nodes left, whose strong neighbors are all free, form new
+   // aggregates with them.
+   for (int i = 0; i < nn; i++)
+   {
+      if (aggregates[i] != -2) { continue; }
+      aggregates[i] = num_aggregates;
+      for (int k = S_I[i]; k < S_I[i+1]; k++)
+      {
+         if (aggregates[S_J[k]] == -2)
+         {
+            aggregates[S_J[k]] = num_aggregates;
+         }
+      }
+      num_aggregates++;
+   }
+
+   return num_aggregates;
+}
+
+SparseMatrix *SmoothedAggregationAMG::TentativeProlongator(
+   const Array<int> &aggregates, int num_aggregates, int bs, bool intl,
+   const DenseMatrix &Bf, DenseMatrix &Bc) const
+{
+   const int nn = aggregates.Size(), n = nn*bs, nv = Bf.Width();
+   const int nc = num_aggregates*nv;
+
+   // lists of the nodes of the aggregates
+   Array<int> agg_I(num_aggregates+1), agg_J;
+   agg_I = 0;
+   for (int i = 0; i < nn; i++)
+   {
+      if (aggregates[i] >= 0) { agg_I[aggregates[i]+1]++; }
+   }
+   agg_I.PartialSum();
+   agg_J.SetSize(agg_I[num_aggregates]);
+   {
+      Array<int> next(num_aggregates);
+      for (int a = 0; a < num_aggregates; a++) { next[a] = agg_I[a]; }
+      for (int i = 0; i < nn; i++)
+      {
+         if (aggregates[i] >= 0) { agg_J[next[aggregates[i]]++] = i; }
+      }
+   }
+
+   // Each aggregated dof interpolates nv coarse dofs.
+   int *I = new int[n+1];
+   I[0] = 0;
+   for (int r = 0; r < n; r++)
+   {
+      const int i = intl ? r/bs : r % nn;
+      I[r+1] = I[r] + ((aggregates[i] >= 0) ? nv : 0);
+   }
+   int *J = new int[I[n]];
+   double *V = new double[I[n]];
+
+   Bc.SetSize(nc, nv);
+   Bc = 0.0;
+   Array<int> rows;
+   DenseMatrix Q;
+   Vector v;
+   for (int a = 0; a < num_aggregates; a++)
+   {
+      rows.SetSize(0);
+      for (int k = agg_I[a]; k < agg_I[a+1]; k++)
+      {
+         for (int c = 0; c < bs; c++)
+         {
+            rows.Append(intl ? agg_J[k]*bs + c : c*nn + agg_J[k]);
+         }
+      }
+      const int m = rows.Size();
+      MFEM_VERIFY(m >= nv, "aggregate " << a << " has " << m << " dofs, less"
+                  " than the " << nv << " near-nullspace vectors");
+
+      // modified Gram-Schmidt: B_a = Q R, with dependent columns of B_a
+      // replaced by unit vectors orthogonalized against the previous ones
+      Q.SetSize(m, nv);
+      for (int j = 0; j < nv; j++)
+      {
+         for (int k = 0; k < m; k++) { Q(k,j) = Bf(rows[k],j); }
+      }
+      for (int j = 0; j < nv; j++)
+      {
+         Vector qj(Q.GetColumn(j), m);
+         const double norm0 = qj.Norml2();
+         for (int i = 0; i < j; i++)
+         {
+            Vector qi(Q.GetColumn(i), m);
+            const double r = qi*qj;
+            qj.Add(-r, qi);
+            Bc(a*nv+i,j) = r;
+         }
+         double norm = qj.Norml2();
+         if (norm > 1e-10*norm0)
+         {
+            Bc(a*nv+j,j) = norm;
+            qj /= norm;
+            continue;
+         }
+         double best = 0.0;
+         for (int t = 0; t < m; t++)
+         {
+            v.SetSize(m);
+            v = 0.0;
+            v(t) = 1.0;
+            for (int i = 0; i < j; i++)
+            {
+               Vector qi(Q.GetColumn(i), m);
+               v.Add(-(qi*v), qi);
+            }
+            norm = v.Norml2();
+            if (norm > best) { best = norm; qj = v; }
+            if (best > 0.5) { break; }
+         }
+         qj /= best;
+      }
+
+      for (int k = 0; k < m; k++)
+      {
+         const int r = rows[k];
+         for (int j = 0; j < nv; j++)
+         {
+            J[I[r]+j] = a*nv + j;
+            V[I[r]+j] = Q(k,j);
+         }
+      }
+   }
+
+   return new SparseMatrix(I, J, V, n, nc);
+}
+
+SparseMatrix *SmoothedAggregationAMG::SmoothProlongator(
+   const SparseMatrix &A, const SparseMatrix &Pt) const
+{
+   const int n = A.Height();
+   Vector dinv(n);
+   A.GetDiag(dinv);
+   for (int i = 0; i < n; i++)
+   {
+      MFEM_VERIFY(dinv(i) != 0.0, "zero diagonal entry in row " << i);
+      dinv(i) = 1.0/dinv(i);
+   }
+
+   // Power iterations for the largest eigenvalue of D^{-1} A, with the
+   // Rayleigh quotient in the D-inner product.
+   Vector x(n), Ax(n);
+   x.Randomize(1);
+   x /= x.Norml2();
+   double rho = 1.0;
+   for (int it = 0; it < 15; it++)
+   {
+      A.Mult(x, Ax);
+      double xDx = 0.0;
+      for (int i = 0; i < n; i++) { xDx += x(i)*x(i)/dinv(i); }
+      rho = (x*Ax)/xDx;
+      for (int i = 0; i < n; i++) { x(i) = dinv(i)*Ax(i); }
+      const double norm = x.Norml2();
+      if (norm == 0.0) { break; }
+      x /= norm;
+   }
+
+   SparseMatrix *AP = mfem::Mult(A, Pt);
+   AP->ScaleRows(dinv);
+   SparseMatrix *P = mfem::Add(1.0, Pt, -4.0/(3.0*rho), *AP);
+   delete AP;
+   return P;
+}
+
+Solver *SmoothedAggregationAMG::MakeSmoother(const SparseMatrix &A) const
+{
+   if (smoother_type == CHEBYSHEV)
+   {
+      Vector diag;
+      A.GetDiag(diag);
+      Array<int> empty;
+      return new OperatorChebyshevSmoother(A, diag, empty, smoother_order);
+   }
+   return new GSSmoother(A, 0, 1);
+}
+
+Solver *SmoothedAggregationAMG::MakeCoarseSolver(const SparseMatrix &A)
+{
+   const int n = A.Height();
+   if (n > 4000)
+   {
+      // the coarsening stalled or reached the maximum number of levels
+      coarse_prec = new GSSmoother(A);
+      CGSolver *cg = new CGSolver;
+      cg->SetRelTol(1e-10);
+      cg->SetMaxIter(1000);
+      cg->SetPrintLevel(-1);
+      cg->SetPreconditioner(*coarse_prec);
+      cg->SetOperator(A);
+      return cg;
+   }
+   const int *I = A.GetI(), *J = A.GetJ();
+   const double *V = A.GetData();
+   coarse_mat.SetSize(n);
+   coarse_mat = 0.0;
+   for (int i = 0; i < n; i++)
+   {
+      for (int k = I[i]; k < I[i+1]; k++)
+      {
+         coarse_mat(i,J[k]) = V[k];
+      }
+   }
+   return new DenseMatrixInverse(coarse_mat);
+}
+
+void SmoothedAggregationAMG::SetOperator(const Operator &op)
+{
+   const SparseMatrix *A = dynamic_cast<const SparseMatrix*>(&op);
+   MFEM_VERIFY(A, "SmoothedAggregationAMG requires a SparseMatrix");
+   MFEM_VERIFY(A->Finalized(), "the matrix must be finalized");
+
+   DeleteLevels();
+   delete coarse_prec;
+   coarse_prec = NULL;
+
+   // default near-nullspace: the constants of each component
+   DenseMatrix Bf(nullspace);
+   if (Bf.Width() == 0)
+   {
+      const int nn = A->Height()/block_size;
+      Bf.SetSize(A->Height(), block_size);
+      Bf = 0.0;
+      for (int i = 0; i < nn; i++)
+      {
+         for (int c = 0; c < block_size; c++)
+         {
+            Bf(interleaved ? i*block_size + c : c*nn + i, c) = 1.0;
+         }
+      }
+   }
+   MFEM_VERIFY(Bf.Height() == A->Height(), "the near-nullspace vectors do not"
+               " match the size of the matrix");
+
+   // coarsening, from the finest level
+   Array<SparseMatrix*> mats, prolongs;
+   mats.Append(const_cast<SparseMatrix*>(A));
+   int bs = block_size;
+   bool intl = interleaved;
+   Array<int> aggregates;
+   DenseMatrix Bc;
+   while (mats.Last()->Height() > coarse_size && mats.Size() < max_levels)
+   {
+      const SparseMatrix &Af = *mats.Last();
+      const int num_aggregates = Aggregate(Af, bs, intl, aggregates);
+      const int nc = num_aggregates*Bf.Width();
+      if (num_aggregates == 0 || nc >= Af.Height()) { break; }
+
+      SparseMatrix *Pt = TentativeProlongator(aggregates, num_aggregates, bs,
+                                              intl, Bf, Bc);
+      SparseMatrix *P = SmoothProlongator(Af, *Pt);
+      delete Pt;
+      mats.Append(mfem::RAP(*P, Af, *P));
+      prolongs.Append(P);
+
+      // the coarse dofs of each aggregate are the components of a node
+      Bf = Bc;
+      bs = Bf.Width();
+      intl = true;
+   }
+
+   // the levels of the Multigrid, from the coarsest
+   const int nl = mats.Size();
+   AddLevel(mats[nl-1], MakeCoarseSolver(*mats[nl-1]), NULL, nl > 1, true);
+   for (int l = nl-2; l >= 0; l--)
+   {
+      AddLevel(mats[l], MakeSmoother(*mats[l]), prolongs[l], l > 0, true,
+               true);
+   }
+
+   if (print_level > 0)
+   {
+      std::cout << "SmoothedAggregationAMG: " << nl << " levels, sizes:";
+      for (int l = 0; l < nl; l++) { std::cout << ' ' << mats[l]->Height(); }
+      std::cout << ", operator complexity: " << GetOperatorComplexity()
+                << '\n';
+   }
+}
+
+double SmoothedAggregationAMG::GetOperatorComplexity() const
+{
+   if (operators.Size() == 0) { return 0.0; }
+   double nnz = 0.0;
+   for (int l = 0; l < operators.Size(); l++)
+   {
+      nnz += static_cast<SparseMatrix*>(operators[l])->NumNonZeroElems();
+   }
+   return nnz/static_cast<SparseMatrix*>(operators.Last())->NumNonZeroElems();
+}
+
+}
@@ -0,0 +1,138 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_AMG
+#define MFEM_AMG
+
+#include "../config/config.hpp"
+#include "multigrid.hpp"
+#include "sparsemat.hpp"
+#include "densemat.hpp"
+
+namespace mfem
+{
+
+/** @brief Serial smoothed aggregation algebraic multigrid for a SparseMatrix.
+
+    The hierarchy is built by SetOperator() from the matrix alone:
+
+    - the strong connections of the (block) node graph are the pairs with
+      |a_ij| > theta sqrt(|a_ii a_jj|), where for systems a_ij is the Frobenius
+      norm of the block coupling the nodes i and j;
+    - the nodes are grouped into aggregates of strongly connected neighbors;
+      nodes without strong connections, e.g. eliminated essential dofs, are
+      left to the smoother;
+    - the tentative prolongator interpolates the near-nullspace vectors
+      exactly: their restriction to each aggregate is orthonormalized and the
+      triangular factors are the near-nullspace of the coarse level;
+    - the prolongator is the tentative one smoothed by one damped Jacobi step,
+      P = (I - 4/(3 rho) D^{-1} A) P_tent, where rho estimates the spectral
+      radius of D^{-1} A;
+    - the coarse matrix is the Galerkin product P^T A P, see RAP().
+
+    The coarsening stops when the size of the matrix is at most the coarse
+    size, where a dense LU factorization is used as coarse solver. The levels
+    are smoothed with symmetric Gauss-Seidel (GSSmoother) or with
+    OperatorChebyshevSmoother, so that the V-cycle is a symmetric
+    preconditioner for CGSolver when the matrix is symmetric.
+
+    By default, the near-nullspace consists of the constant vectors of each
+    component. For elasticity, the rigid body modes should be given with
+    SetNearNullspace(), see RigidBodyModes() and Example 2. */
+class SmoothedAggregationAMG : public Multigrid
+{
+public:
+   enum SmootherType { GAUSS_SEIDEL, CHEBYSHEV };
+
+protected:
+   double theta;
+   int coarse_size, max_levels;
+   SmootherType smoother_type;
+   int smoother_order;
+   int print_level;
+
+   /// Number of components and their layout, see SetNearNullspace().
+   int block_size;
+   bool interleaved;
+   DenseMatrix nullspace;
+
+   DenseMatrix coarse_mat;
+   Solver *coarse_prec;
+
+   /** @brief Compute the aggregate of each node (-1 for the nodes without
+       strong connections) and return the number of aggregates. */
+   int Aggregate(const SparseMatrix &A, int bs, bool intl,
+                 Array<int> &aggregates) const;
+
+   /** @brief Build the tentative prolongator for the given aggregates and
+       the near-nullspace @a Bf; the coarse near-nullspace is returned in
+       @a Bc. */
+   SparseMatrix *TentativeProlongator(const Array<int> &aggregates,
+                                      int num_aggregates, int bs, bool intl,
+                                      const DenseMatrix &Bf,
+                                      DenseMatrix &Bc) const;
+
+   /// Return P = (I - omega D^{-1} A) Pt.
+   SparseMatrix *SmoothProlongator(const SparseMatrix &A,
+                                   const SparseMatrix &Pt) const;
+
+   Solver *MakeSmoother(const SparseMatrix &A) const;
+   Solver *MakeCoarseSolver(const SparseMatrix &A);
+
+public:
+   SmoothedAggregationAMG();
+
+   /** @brief Set the strength of connection threshold, theta (default:
+       0.05). */
+   void SetStrengthThreshold(double th) { theta = th; }
+
+   /// Set the size of the coarsest matrix (default: 500).
+   void SetCoarseSize(int size) { coarse_size = size; }
+
+   /// Set the maximum number of levels (default: 10).
+   void SetMaxLevels(int levels) { max_levels = levels; }
+
+   /** @brief Set the type of smoother (default: symmetric Gauss-Seidel) and
+       the order of the Chebyshev smoother. */
+   void SetSmoother(SmootherType type, int order = 2)
+   { smoother_type = type; smoother_order = order; }
+
+   /// Print the sizes of the levels when the hierarchy is built.
+   void SetPrintLevel(int print_lvl) { print_level = print_lvl; }
+
+   /** @brief Set the number of components of a system, whose near-nullspace
+       is the constant vectors of each component.
+
+       If @a intl is true, the components of each node are consecutive
+       (Ordering::byVDIM), otherwise the dofs of each component are consecutive
+       (Ordering::byNODES). */
+   void SetSystemsOptions(int bs, bool intl = false);
+
+   /** @brief Set the near-nullspace vectors, the columns of @a B, of a system
+       with @a bs components, see SetSystemsOptions().
+
+       The number of columns of @a B should not be larger than @a bs times the
+       size of the smallest aggregates, which contain at least two nodes. */
+   void SetNearNullspace(const DenseMatrix &B, int bs, bool intl = false);
+
+   /// Build the hierarchy for @a op, which must be a SparseMatrix.
+   virtual void SetOperator(const Operator &op);
+
+   /** @brief Return the operator complexity: the total number of nonzeros of
+       the matrices of all levels relative to that of the finest one. */
+   double GetOperatorComplexity() const;
+
+   virtual ~SmoothedAggregationAMG() { delete coarse_prec; }
+};
+
+}
+
+#endif
@@ -0,0 +1,246 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementation of class BCSRMatrix
+
+#include "bcsrmat.hpp"
+#include <algorithm>
+
+namespace mfem
+{
+
+BCSRMatrix::BCSRMatrix(const SparseMatrix &A, int B_)
+   : Operator(A.Height(), A.Width()), B(B_), transp(NULL)
+{
+   MFEM_VERIFY(A.Finalized(), "the matrix must be finalized");
+   MFEM_VERIFY(B > 0 && height % B == 0 && width % B == 0,
+               "the matrix size is not a multiple of the block size " << B);
+
+   num_block_rows = height/B;
+   num_block_cols = width/B;
+
+   const int *AI = A.GetI(), *AJ = A.GetJ();
+   const double *data = A.GetData();
+
+   // the block columns of each block row
+   Array<int> marker(num_block_cols);
+   marker = -1;
+   I.SetSize(num_block_rows+1);
+   I[0] = 0;
+   for (int bi = 0; bi < num_block_rows; bi++)
+   {
+      int nnzb = 0;
+      for (int i = bi*B; i < (bi+1)*B; i++)
+      {
+         for (int k = AI[i]; k < AI[i+1]; k++)
+         {
+            const int bj = AJ[k]/B;
+            if (marker[bj] != bi) { marker[bj] = bi; nnzb++; }
+         }
+      }
+      I[bi+1] = I[bi] + nnzb;
+   }
+
+   J.SetSize(I[num_block_rows]);
+   vals.SetSize(B*B*I[num_block_rows]);
+   vals = 0.0;
+   marker = -1;
+   for (int bi = 0; bi < num_block_rows; bi++)
+   {
+      int nnzb = I[bi];
+      for (int i = bi*B; i < (bi+1)*B; i++)
+      {
+         for (int k = AI[i]; k < AI[i+1]; k++)
+         {
+            const int bj = AJ[k]/B;
+            if (marker[bj] < I[bi]) { marker[bj] = nnzb; J[nnzb++] = bj; }
+         }
+      }
+      // sort the block columns of the row
+      std::sort(J.GetData() + I[bi], J.GetData() + I[bi+1]);
+      for (int p = I[bi]; p < I[bi+1]; p++)
+      {
+         marker[J[p]] = p;
+      }
+      for (int i = bi*B; i < (bi+1)*B; i++)
+      {
+         for (int k = AI[i]; k < AI[i+1]; k++)
+         {
+            const int p = marker[AJ[k]/B];
+            vals[(p*B + i - bi*B)*B + AJ[k] % B] = data[k];
+         }
+      }
+      for (int p = I[bi]; p < I[bi+1]; p++)
+      {
+         marker[J[p]] = -1;
+      }
+   }
+}
+
+// Compute the block row products with a fixed block size B.
+template <int B>
+static void BCSRAddMult(const int num_block_rows, const int *I, const int *J,
+                        const double *vals, const double *xp, double *yp,
+                        const double a, const bool add)
+{
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int bi = 0; bi < num_block_rows; bi++)
+   {
+      double t[B];
+      for (int r = 0; r < B; r++) { t[r] = 0.0; }
+      for (int p = I[bi]; p < I[bi+1]; p++)
+      {
+         const double *blk = vals + p*B*B;
+         const double *xb = xp + J[p]*B;
+         for (int r = 0; r < B; r++)
+         {
+            for (int c = 0; c < B; c++)
+            {
+               t[r] += blk[r*B + c]*xb[c];
+            }
+         }
+      }
+      double *yb = yp + bi*B;
+      for (int r = 0; r < B; r++)
+      {
+         if (add) { yb[r] += a*t[r]; }
+         else { yb[r] = t[r]; }
+      }
+   }
+}
+
+// Version of BCSRAddMult with a general block size.
+static void BCSRAddMult(const int B, const int num_block_rows, const int *I,
+                        const int *J, const double *vals, const double *xp,
+                        double *yp, const double a, const bool add)
+{
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int bi = 0; bi < num_block_rows; bi++)
+   {
+      double *yb = yp + bi*B;
+      if (!add)
+      {
+         for (int r = 0; r < B; r++) { yb[r] = 0.0; }
+      }
+      const double s = add ? a : 1.0;
+      for (int p = I[bi]; p < I[bi+1]; p++)
+      {
+         const double *blk = vals + p*B*B;
+         const double *xb = xp + J[p]*B;
+         for (int r = 0; r < B; r++)
+         {
+            double t = 0.0;
+            for (int c = 0; c < B; c++)
+            {
+               t += blk[r*B + c]*xb[c];
+            }
+            yb[r] += s*t;
+         }
+      }
+   }
+}
+
+void BCSRMatrix::AddMult(const Vector &x, Vector &y, const double a,
+                         bool add) const
+{
+   MFEM_ASSERT(x.Size() == width, "invalid input vector size");
+   MFEM_ASSERT(y.Size() == height, "invalid output vector size");
+
+   const int nbr = num_block_rows;
+   const double *xp = x.GetData();
+   double *yp = y.GetData();
+   switch (B)
+   {
+      case 1: BCSRAddMult<1>(nbr, I, J, vals, xp, yp, a, add); break;
+      case 2: BCSRAddMult<2>(nbr, I, J, vals, xp, yp, a, add); break;
+      case 3: BCSRAddMult<3>(nbr, I, J, vals, xp, yp, a, add); break;
+      default: BCSRAddMult(B, nbr, I, J, vals, xp, yp, a, add); break;
+   }
+}
+
+const BCSRMatrix *BCSRMatrix::GetTranspose() const
+{
+   // lock-free path: the transpose is published once it is complete
+   const BCSRMatrix *At_ptr;
+#ifdef MFEM_USE_OPENMP
+   #pragma omp atomic read seq_cst
+#endif
+   At_ptr = transp;
+   if (At_ptr) { return At_ptr; }
+
+#ifdef MFEM_USE_OPENMP
+   #pragma omp critical (BCSRMatrixTranspose)
+#endif
+   {
+      // another thread may have built the transpose in the meantime
+      if (!transp)
+      {
+         SparseMatrix *A = ToSparseMatrix();
+         SparseMatrix *At = Transpose(*A);
+         delete A;
+         BCSRMatrix *tmp = new BCSRMatrix(*At, B);
+         delete At;
+#ifdef MFEM_USE_OPENMP
+         #pragma omp atomic write seq_cst
+#endif
+         transp = tmp;
+      }
+      At_ptr = transp;
+   }
+   return At_ptr;
+}
+
+void BCSRMatrix::MultTranspose(const Vector &x, Vector &y) const
+{
+   GetTranspose()->Mult(x, y);
+}
+
+void BCSRMatrix::AddMultTranspose(const Vector &x, Vector &y,
+                                  const double a) const
+{
+   GetTranspose()->AddMult(x, y, a);
+}
+
+SparseMatrix *BCSRMatrix::ToSparseMatrix() const
+{
+   const int nnz = vals.Size();
+   int *AI = new int[height+1];
+   int *AJ = new int[nnz];
+   double *data = new double[nnz];
+
+   AI[0] = 0;
+   for (int bi = 0; bi < num_block_rows; bi++)
+   {
+      for (int r = 0; r < B; r++)
+      {
+         const int i = bi*B + r;
+         int k = AI[i];
+         for (int p = I[bi]; p < I[bi+1]; p++)
+         {
+            for (int c = 0; c < B; c++)
+            {
+               AJ[k] = J[p]*B + c;
+               data[k] = vals[(p*B + r)*B + c];
+               k++;
+            }
+         }
+         AI[i+1] = k;
+      }
+   }
+
+   return new SparseMatrix(AI, AJ, data, height, width);
+}
+
+}
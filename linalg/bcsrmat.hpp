@@ -0,0 +1,93 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_BCSRMAT
+#define MFEM_BCSRMAT
+
+#include "../config/config.hpp"
+#include "../general/array.hpp"
+#include "operator.hpp"
+#include "sparsemat.hpp"
+
+namespace mfem
+{
+
+/** @brief Sparse matrix in the blocked CSR (BCSR) format, with dense square
+    blocks of size B x B.
+
+    This format is suitable for matrices from vector finite element spaces
+    with Ordering::byVDIM, where B is the vector dimension: the matrix is then
+    the CSR matrix of the scalar space with each entry replaced by a B x B
+    block. Storing one column index per block reduces the memory traffic of
+    the matrix-vector product, which is computed with fixed-size block kernels
+    for B = 1, 2, 3 that the compiler can unroll and vectorize. The block rows
+    are processed in parallel when OpenMP is enabled.
+
+    The matrix is constructed from a finalized SparseMatrix and its entries
+    can not be modified. */
+class BCSRMatrix : public Operator
+{
+protected:
+   int B; ///< Block size
+   int num_block_rows, num_block_cols;
+   /// CSR structure of the blocks.
+   Array<int> I, J;
+   /// Values of the blocks, each block stored row-wise.
+   Array<double> vals;
+
+   /** The transpose, constructed on the first call to MultTranspose(); the
+       construction is thread-safe. */
+   mutable BCSRMatrix *transp;
+
+   void AddMult(const Vector &x, Vector &y, const double a, bool add) const;
+   const BCSRMatrix *GetTranspose() const;
+
+private:
+   // not copyable: the transpose is owned
+   BCSRMatrix(const BCSRMatrix &);
+   BCSRMatrix &operator=(const BCSRMatrix &);
+
+public:
+   /** @brief Construct the BCSR version of the finalized matrix @a A with
+       block size @a B. The dimensions of @a A must be multiples of @a B. */
+   BCSRMatrix(const SparseMatrix &A, int B);
+
+   /// Matrix vector multiplication: y = A x.
+   virtual void Mult(const Vector &x, Vector &y) const
+   { AddMult(x, y, 1.0, false); }
+
+   /// y += a A x
+   void AddMult(const Vector &x, Vector &y, const double a = 1.0) const
+   { AddMult(x, y, a, true); }
+
+   /** @brief Multiply by the transpose: y = A^t x. On the first call, the
+       transpose is constructed and stored in the BCSR format. */
+   virtual void MultTranspose(const Vector &x, Vector &y) const;
+
+   /// y += a A^t x
+   void AddMultTranspose(const Vector &x, Vector &y,
+                         const double a = 1.0) const;
+
+   /// Returns the block size B.
+   int GetBlockSize() const { return B; }
+
+   /// Returns the number of stored entries, including the zeros in the blocks.
+   int NumStoredEntries() const { return vals.Size(); }
+
+   /// Returns a new SparseMatrix with the entries of the matrix.
+   SparseMatrix *ToSparseMatrix() const;
+
+   virtual ~BCSRMatrix() { delete transp; }
+};
+
+}
+
+#endif
@@ -18,6 +18,8 @@
 #include "operator.hpp"
 #include "matrix.hpp"
 #include "sparsemat.hpp"
+#include "sellmat.hpp"
+#include "bcsrmat.hpp"
 #include "blockvector.hpp"
 #include "blockmatrix.hpp"
 #include "blockoperator.hpp"
@@ -25,6 +27,8 @@
 #include "densemat.hpp"
 #include "ode.hpp"
 #include "solvers.hpp"
+#include "multigrid.hpp"
+#include "amg.hpp"
 #include "handle.hpp"
 
 #ifdef MFEM_USE_SUNDIALS
@@ -0,0 +1,145 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "multigrid.hpp"
+
+namespace mfem
+{
+
+Multigrid::Multigrid()
+   : Solver(0), cycle_type(VCYCLE), pre_smoothing_steps(1),
+     post_smoothing_steps(1)
+{ }
+
+void Multigrid::AddLevel(Operator *op, Solver *smoother,
+                         const Operator *prolongation, bool own_op,
+                         bool own_smoother, bool own_prolongation)
+{
+   MFEM_VERIFY(op->Height() == op->Width(), "the operator must be square");
+   MFEM_VERIFY(smoother, "missing smoother or coarse solver");
+   if (operators.Size() == 0)
+   {
+      MFEM_VERIFY(prolongation == NULL, "the coarsest level has no"
+                  " prolongation");
+   }
+   else
+   {
+      MFEM_VERIFY(prolongation &&
+                  prolongation->Height() == op->Height() &&
+                  prolongation->Width() == operators.Last()->Height(),
+                  "invalid prolongation from level " << operators.Size()-1);
+   }
+   operators.Append(op);
+   smoothers.Append(smoother);
+   prolongations.Append(prolongation);
+   own_operators.Append(own_op);
+   own_smoothers.Append(own_smoother);
+   own_prolongations.Append(own_prolongation);
+   B.Append(new Vector(op->Height()));
+   X.Append(new Vector(op->Height()));
+   R.Append(new Vector(op->Height()));
+   height = width = op->Height();
+}
+
+void Multigrid::Cycle(int level) const
+{
+   Solver &S = *smoothers[level];
+   Vector &b = *B[level], &x = *X[level], &r = *R[level];
+
+   if (level == 0)
+   {
+      S.iterative_mode = false;
+      S.Mult(b, x);
+      return;
+   }
+
+   // pre-smoothing, starting with a zero initial guess
+   x = 0.0;
+   for (int i = 0; i < pre_smoothing_steps; i++)
+   {
+      S.iterative_mode = (i > 0);
+      S.Mult(b, x);
+   }
+
+   // coarse grid correction
+   operators[level]->Mult(x, r);
+   subtract(b, r, r);
+   prolongations[level]->MultTranspose(r, *B[level-1]);
+   Cycle(level-1);
+   Vector &xc = *X[level-1];
+   if (cycle_type == WCYCLE && level > 1)
+   {
+      // second cycle for the residual of the coarse problem
+      Vector &bc = *B[level-1], xc0(xc);
+      operators[level-1]->Mult(xc0, *R[level-1]);
+      bc -= *R[level-1];
+      Cycle(level-1);
+      xc += xc0;
+   }
+   prolongations[level]->Mult(xc, r);
+   x += r;
+
+   // post-smoothing
+   S.iterative_mode = true;
+   for (int i = 0; i < post_smoothing_steps; i++)
+   {
+      S.Mult(b, x);
+   }
+}
+
+void Multigrid::Mult(const Vector &x, Vector &y) const
+{
+   MFEM_VERIFY(operators.Size() > 0, "the Multigrid has no levels");
+   const int l = operators.Size() - 1;
+   if (iterative_mode)
+   {
+      operators[l]->Mult(y, *B[l]);
+      subtract(x, *B[l], *B[l]);
+      Cycle(l);
+      y += *X[l];
+   }
+   else
+   {
+      *B[l] = x;
+      Cycle(l);
+      y = *X[l];
+   }
+}
+
+void Multigrid::DeleteLevels()
+{
+   for (int l = 0; l < operators.Size(); l++)
+   {
+      if (own_operators[l]) { delete operators[l]; }
+      if (own_smoothers[l]) { delete smoothers[l]; }
+      if (own_prolongations[l]) { delete prolongations[l]; }
+      delete B[l];
+      delete X[l];
+      delete R[l];
+   }
+   operators.SetSize(0);
+   smoothers.SetSize(0);
+   prolongations.SetSize(0);
+   own_operators.SetSize(0);
+   own_smoothers.SetSize(0);
+   own_prolongations.SetSize(0);
+   B.SetSize(0);
+   X.SetSize(0);
+   R.SetSize(0);
+   height = width = 0;
+}
+
+Multigrid::~Multigrid()
+{
+   DeleteLevels();
+}
+
+}
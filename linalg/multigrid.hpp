@@ -0,0 +1,99 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_MULTIGRID
+#define MFEM_MULTIGRID
+
+#include "../config/config.hpp"
+#include "../general/array.hpp"
+#include "operator.hpp"
+
+namespace mfem
+{
+
+/** @brief Multigrid solver defined by a hierarchy of operators, smoothers and
+    prolongations.
+
+    Level 0 is the coarsest level; its "smoother" is used as the coarse
+    solver, e.g. a CGSolver or a direct solver. Each finer level is added with
+    the prolongation from the previous (coarser) level, whose transpose is used
+    as restriction. The operators, smoothers and prolongations only need to
+    implement Mult() (and MultTranspose() for the prolongations), so the
+    hierarchy may be matrix-free, e.g. with partially assembled operators and
+    OperatorChebyshevSmoother, see FiniteElementSpaceHierarchy and Example 1.
+
+    Each call to Mult() performs one V- or W-cycle; with the symmetric default
+    settings and symmetric smoothers, the cycle is a symmetric preconditioner
+    suitable for CGSolver. The iterative_mode flag of the smoothers is set by
+    the cycle. */
+class Multigrid : public Solver
+{
+public:
+   enum CycleType { VCYCLE, WCYCLE };
+
+protected:
+   Array<Operator*> operators;
+   Array<Solver*> smoothers;
+   /// Prolongation from level l-1 to level l, NULL for l = 0.
+   Array<const Operator*> prolongations;
+   Array<bool> own_operators, own_smoothers, own_prolongations;
+
+   CycleType cycle_type;
+   int pre_smoothing_steps, post_smoothing_steps;
+
+   /// Right-hand sides, solutions and residuals of all levels.
+   mutable Array<Vector*> B, X, R;
+
+   void Cycle(int level) const;
+
+   /// Delete the owned objects of all levels and remove the levels.
+   void DeleteLevels();
+
+public:
+   Multigrid();
+
+   /** @brief Add a level finer than the current ones, or the coarsest level
+       with the first call, in which case @a prolongation must be NULL.
+
+       The @a prolongation maps vectors of the previous level to vectors of
+       this level. The ownership flags specify which objects are deleted by the
+       Multigrid. */
+   void AddLevel(Operator *op, Solver *smoother, const Operator *prolongation,
+                 bool own_op = false, bool own_smoother = false,
+                 bool own_prolongation = false);
+
+   int NumLevels() const { return operators.Size(); }
+
+   Operator *GetOperatorAtLevel(int level) { return operators[level]; }
+   Solver *GetSmootherAtLevel(int level) { return smoothers[level]; }
+
+   /** @brief Set the type of cycle and the number of pre- and post-smoothing
+       steps (default: V-cycle with one pre- and one post-smoothing step). */
+   void SetCycle(CycleType type, int pre_steps, int post_steps)
+   {
+      cycle_type = type;
+      pre_smoothing_steps = pre_steps;
+      post_smoothing_steps = post_steps;
+   }
+
+   /// Apply one cycle for the operator of the finest level.
+   virtual void Mult(const Vector &x, Vector &y) const;
+
+   /// The operators are set with AddLevel().
+   virtual void SetOperator(const Operator &op)
+   { MFEM_ABORT("use AddLevel() to set the operators"); }
+
+   virtual ~Multigrid();
+};
+
+}
+
+#endif
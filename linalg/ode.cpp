@@ -11,6 +11,8 @@
 
 #include "operator.hpp"
 #include "ode.hpp"
+#include <cmath>
+#include <algorithm>
 
 namespace mfem
 {
@@ -100,6 +102,23 @@ void RK4Solver::Init(TimeDependentOperator &_f)
    z.SetSize(n);
 }
 
+// Compute y = x + ay k and z = x + az k (if init_z) or z += az k.
+static void RK4Update(const Vector &x, double ay, const Vector &k, Vector &y,
+                      double az, Vector &z, bool init_z)
+{
+   const int n = x.Size();
+   const double *xd = x.GetData(), *kd = k.GetData();
+   double *yd = y.GetData(), *zd = z.GetData();
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int i = 0; i < n; i++)
+   {
+      yd[i] = xd[i] + ay*kd[i];
+      zd[i] = (init_z ? xd[i] : zd[i]) + az*kd[i];
+   }
+}
+
 void RK4Solver::Step(Vector &x, double &t, double &dt)
 {
    //   0  |
@@ -109,19 +128,17 @@ void RK4Solver::Step(Vector &x, double &t, double &dt)
    // -----+-------------------
    //      | 1/6  1/3  1/3  1/6
 
+   // The two updates after each stage are fused in one pass.
    f->SetTime(t);
    f->Mult(x, k); // k1
-   add(x, dt/2, k, y);
-   add(x, dt/6, k, z);
+   RK4Update(x, dt/2, k, y, dt/6, z, true);
 
    f->SetTime(t + dt/2);
    f->Mult(y, k); // k2
-   add(x, dt/2, k, y);
-   z.Add(dt/3, k);
+   RK4Update(x, dt/2, k, y, dt/3, z, false);
 
    f->Mult(y, k); // k3
-   add(x, dt, k, y);
-   z.Add(dt/3, k);
+   RK4Update(x, dt, k, y, dt/3, z, false);
 
    f->SetTime(t + dt);
    f->Mult(y, k); // k4
@@ -137,6 +154,8 @@ ExplicitRKSolver::ExplicitRKSolver(int _s, const double *_a, const double *_b,
    b = _b;
    c = _c;
    k = new Vector[s];
+   coef.SetSize(s);
+   terms.SetSize(s);
 }
 
 void ExplicitRKSolver::Init(TimeDependentOperator &_f)
@@ -162,22 +181,30 @@ void ExplicitRKSolver::Step(Vector &x, double &t, double &dt)
 
    f->SetTime(t);
    f->Mult(x, k[0]);
-   for (int l = 0, i = 1; i < s; i++)
+   for (int l = 0, i = 1; i < s; l += i, i++)
    {
-      add(x, a[l++]*dt, k[0], y);
-      for (int j = 1; j < i; j++)
-      {
-         y.Add(a[l++]*dt, k[j]);
-      }
+      CombineStages(x, dt, i, a + l, y);
 
       f->SetTime(t + c[i-1]*dt);
       f->Mult(y, k[i]);
    }
-   for (int i = 0; i < s; i++)
+   CombineStages(x, dt, s, b, x);
+   t += dt;
+}
+
+void ExplicitRKSolver::CombineStages(const Vector &x, double dt, int n,
+                                     const double *w, Vector &z)
+{
+   int m = 0;
+   for (int j = 0; j < n; j++)
    {
-      x.Add(b[i]*dt, k[i]);
+      if (w[j] != 0.0)
+      {
+         coef[m] = w[j]*dt;
+         terms[m++] = &k[j];
+      }
    }
-   t += dt;
+   AddLinearCombination(x, m, coef.GetData(), terms.GetData(), z);
 }
 
 ExplicitRKSolver::~ExplicitRKSolver()
@@ -185,6 +212,62 @@ ExplicitRKSolver::~ExplicitRKSolver()
    delete [] k;
 }
 
+void LowStorageRKSolver::Init(TimeDependentOperator &_f)
+{
+   ODESolver::Init(_f);
+   int n = f->Width();
+   dx.SetSize(n);
+   k.SetSize(n);
+}
+
+void LowStorageRKSolver::Step(Vector &x, double &t, double &dt)
+{
+   const int n = x.Size();
+   double *xd = x.GetData(), *dxd = dx.GetData();
+   const double *kd = k.GetData();
+   for (int i = 0; i < s; i++)
+   {
+      f->SetTime(t + c[i]*dt);
+      f->Mult(x, k);
+      const double Ai = A[i], Bi = B[i];
+#ifdef MFEM_USE_OPENMP
+      #pragma omp parallel for
+#endif
+      for (int j = 0; j < n; j++)
+      {
+         // A[0] = 0: dx is not used before it is set in the first stage
+         dxd[j] = (i ? Ai*dxd[j] : 0.0) + dt*kd[j];
+         xd[j] += Bi*dxd[j];
+      }
+   }
+   t += dt;
+}
+
+const double LSRK54Solver::A[] =
+{
+   0.0,
+   -567301805773.0/1357537059087.0,
+   -2404267990393.0/2016746695238.0,
+   -3550918686646.0/2091501179385.0,
+   -1275806237668.0/842570457699.0
+};
+const double LSRK54Solver::B[] =
+{
+   1432997174477.0/9575080441755.0,
+   5161836677717.0/13612068292357.0,
+   1720146321549.0/2090206949498.0,
+   3134564353537.0/4481467310338.0,
+   2277821191437.0/14882151754819.0
+};
+const double LSRK54Solver::c[] =
+{
+   0.0,
+   1432997174477.0/9575080441755.0,
+   2526269341429.0/6820363962896.0,
+   2006345519317.0/3224310063776.0,
+   2802321613138.0/2924317926251.0
+};
+
 const double RK6Solver::a[] =
 {
    .6e-1,
@@ -485,4 +568,342 @@ void SDIRK33Solver::Step(Vector &x, double &t, double &dt)
    t += dt;
 }
 
+
+// Compute z = x + dt sum_j w[j] k[j], j < n, skipping zero weights.
+static void CombineStages(const Vector &x, double dt, int n, const double *w,
+                          const Vector *k, Array<double> &coef,
+                          Array<const Vector *> &terms, Vector &z)
+{
+   int m = 0;
+   for (int j = 0; j < n; j++)
+   {
+      if (w[j] != 0.0)
+      {
+         coef[m] = w[j]*dt;
+         terms[m++] = &k[j];
+      }
+   }
+   AddLinearCombination(x, m, coef.GetData(), terms.GetData(), z);
+}
+
+AdaptiveODESolver::AdaptiveODESolver(int order)
+{
+#ifdef MFEM_USE_MPI
+   parallel = false;
+#endif
+   err_order = order;
+   norm_type = RMS_NORM;
+   abs_tol = 1e-6;
+   rel_tol = 1e-6;
+   safety = 0.9;
+   min_factor = 0.2;
+   max_factor = 5.0;
+   dt_min = 0.0;
+   dt_max = 0.0;
+   // PI controller of Gustafsson, with the gains recommended by Hairer and
+   // Wanner, Section IV.2.
+   beta1 = 0.7/(order + 1);
+   beta2 = 0.4/(order + 1);
+   err_prev = dt_last = 0.0;
+   rejected = false;
+   num_accepted = num_rejected = 0;
+}
+
+void AdaptiveODESolver::Init(TimeDependentOperator &_f)
+{
+   ODESolver::Init(_f);
+   int n = f->Width();
+   x_new.SetSize(n);
+   err.SetSize(n);
+   err_prev = dt_last = 0.0;
+   rejected = false;
+   num_accepted = num_rejected = 0;
+}
+
+double AdaptiveODESolver::ErrorNorm(const Vector &x0, const Vector &x1,
+                                    const Vector &e) const
+{
+   const int n = e.Size();
+   double loc[2] = { 0.0, double(n) };
+   for (int i = 0; i < n; i++)
+   {
+      const double sc = abs_tol + rel_tol*std::max(fabs(x0(i)), fabs(x1(i)));
+      const double r = fabs(e(i))/sc;
+      if (norm_type == MAX_NORM) { loc[0] = std::max(loc[0], r); }
+      else { loc[0] += r*r; }
+   }
+#ifdef MFEM_USE_MPI
+   if (parallel)
+   {
+      double glob[2];
+      if (norm_type == MAX_NORM)
+      {
+         MPI_Allreduce(loc, glob, 1, MPI_DOUBLE, MPI_MAX, comm);
+      }
+      else
+      {
+         MPI_Allreduce(loc, glob, 2, MPI_DOUBLE, MPI_SUM, comm);
+      }
+      loc[0] = glob[0];
+      loc[1] = glob[1];
+   }
+#endif
+   if (norm_type == MAX_NORM) { return loc[0]; }
+   return (loc[1] > 0.0) ? sqrt(loc[0]/loc[1]) : 0.0;
+}
+
+void AdaptiveODESolver::Step(Vector &x, double &t, double &dt)
+{
+   const double expo = 1.0/(err_order + 1);
+   double h = (dt_max > 0.0) ? std::min(dt, dt_max) : dt;
+   h = std::max(h, dt_min);
+   while (1)
+   {
+      TryStep(x, t, h, x_new, err);
+      const double en = ErrorNorm(x, x_new, err);
+
+      if (en <= 1.0 || h <= dt_min)
+      {
+         // Accepted step: the proposed step size is given by the PI
+         // controller, with the previous error bounded away from zero.
+         double fac = max_factor;
+         if (en > 0.0)
+         {
+            fac = safety*pow(en, -beta1);
+            if (err_prev > 0.0) { fac *= pow(err_prev, beta2); }
+         }
+         fac = std::min(std::max(fac, min_factor), max_factor);
+         // Do not increase the step size right after a rejection.
+         if (rejected) { fac = std::min(fac, 1.0); }
+
+         x = x_new;
+         t += h;
+         dt_last = h;
+         err_prev = std::max(en, 1e-4);
+         rejected = false;
+         num_accepted++;
+         AcceptStep();
+
+         dt = h*fac;
+         if (dt_max > 0.0) { dt = std::min(dt, dt_max); }
+         dt = std::max(dt, dt_min);
+         return;
+      }
+
+      // Rejected step (en > 1 or NaN): retry with a smaller step size.
+      double fac = (en > 1.0) ? safety*pow(en, -expo) : min_factor;
+      fac = std::min(std::max(fac, min_factor), safety);
+      h = std::max(h*fac, dt_min);
+      rejected = true;
+      num_rejected++;
+      MFEM_VERIFY(t + h > t, "AdaptiveODESolver: step size underflow at t = "
+                  << t);
+   }
+}
+
+void AdaptiveODESolver::Run(Vector &x, double &t, double &dt, double tf)
+{
+   while (t < tf)
+   {
+      const bool last = (t + dt >= tf);
+      double h = last ? (tf - t) : dt;
+      const double t0 = t, dt_prop = dt;
+      Step(x, t, h);
+      if (last && dt_last == tf - t0)
+      {
+         // The step was shortened to reach tf: keep the previous proposal.
+         t = tf;
+         dt = std::max(h, dt_prop);
+      }
+      else
+      {
+         dt = h;
+      }
+   }
+}
+
+
+EmbeddedRKSolver::EmbeddedRKSolver(int _s, const double *_a,
+                                   const double *_b, const double *_bh,
+                                   const double *_c, int order, bool _fsal)
+   : AdaptiveODESolver(order)
+{
+   s = _s;
+   a = _a;
+   b = _b;
+   c = _c;
+   fsal = _fsal;
+   fsal_x = NULL;
+   fsal_t = try_t = try_dt = 0.0;
+   k = new Vector[s];
+   e.SetSize(s);
+   for (int i = 0; i < s; i++) { e[i] = b[i] - _bh[i]; }
+   coef.SetSize(s);
+   terms.SetSize(s);
+}
+
+void EmbeddedRKSolver::Init(TimeDependentOperator &_f)
+{
+   AdaptiveODESolver::Init(_f);
+   int n = f->Width();
+   y.SetSize(n);
+   for (int i = 0; i < s; i++)
+   {
+      k[i].SetSize(n);
+   }
+   fsal_x = NULL;
+}
+
+void EmbeddedRKSolver::TryStep(const Vector &x, double t, double dt,
+                               Vector &xn, Vector &er)
+{
+   // With fsal, k[0] = f(t, x) was computed as the last stage of the previous
+   // accepted step, or by a rejected try; recompute it when the step starts
+   // from a different vector or time.
+   if (!fsal || fsal_x != x.GetData() || fsal_t != t)
+   {
+      f->SetTime(t);
+      f->Mult(x, k[0]);
+      fsal_x = fsal ? x.GetData() : NULL;
+      fsal_t = t;
+   }
+   try_t = t;
+   try_dt = dt;
+   for (int l = 0, i = 1; i < s; l += i, i++)
+   {
+      // With fsal, the last row of a[] is b[], so y is the new solution.
+      CombineStages(x, dt, i, a + l, k, coef, terms, y);
+
+      f->SetTime(t + c[i-1]*dt);
+      f->Mult(y, k[i]);
+   }
+   if (fsal) { xn = y; }
+   else { CombineStages(x, dt, s, b, k, coef, terms, xn); }
+   er = 0.0;
+   CombineStages(er, dt, s, e, k, coef, terms, er);
+}
+
+void EmbeddedRKSolver::AcceptStep()
+{
+   // AdaptiveODESolver::Step() copies the new solution into the same vector
+   // and advances the time by the same sum
+   if (fsal) { k[0].Swap(k[s-1]); fsal_t = try_t + try_dt; }
+}
+
+EmbeddedRKSolver::~EmbeddedRKSolver()
+{
+   delete [] k;
+}
+
+const double DormandPrince54Solver::a[] =
+{
+   1./5,
+   3./40, 9./40,
+   44./45, -56./15, 32./9,
+   19372./6561, -25360./2187, 64448./6561, -212./729,
+   9017./3168, -355./33, 46732./5247, 49./176, -5103./18656,
+   35./384, 0., 500./1113, 125./192, -2187./6784, 11./84
+};
+const double DormandPrince54Solver::b[] =
+{
+   35./384, 0., 500./1113, 125./192, -2187./6784, 11./84, 0.
+};
+const double DormandPrince54Solver::bh[] =
+{
+   5179./57600, 0., 7571./16695, 393./640, -92097./339200, 187./2100, 1./40
+};
+const double DormandPrince54Solver::c[] =
+{
+   1./5, 3./10, 4./5, 8./9, 1., 1.
+};
+
+const double BogackiShampine32Solver::a[] =
+{
+   1./2,
+   0., 3./4,
+   2./9, 1./3, 4./9
+};
+const double BogackiShampine32Solver::b[] =
+{
+   2./9, 1./3, 4./9, 0.
+};
+const double BogackiShampine32Solver::bh[] =
+{
+   7./24, 1./4, 1./3, 1./8
+};
+const double BogackiShampine32Solver::c[] =
+{
+   1./2, 3./4, 1.
+};
+
+
+EmbeddedSDIRKSolver::EmbeddedSDIRKSolver(int _s, const double *_a,
+                                         const double *_b, const double *_bh,
+                                         const double *_c, int order)
+   : AdaptiveODESolver(order)
+{
+   s = _s;
+   a = _a;
+   b = _b;
+   c = _c;
+   k = new Vector[s];
+   e.SetSize(s);
+   for (int i = 0; i < s; i++) { e[i] = b[i] - _bh[i]; }
+   coef.SetSize(s);
+   terms.SetSize(s);
+}
+
+void EmbeddedSDIRKSolver::Init(TimeDependentOperator &_f)
+{
+   AdaptiveODESolver::Init(_f);
+   int n = f->Width();
+   y.SetSize(n);
+   for (int i = 0; i < s; i++)
+   {
+      k[i].SetSize(n);
+   }
+}
+
+void EmbeddedSDIRKSolver::TryStep(const Vector &x, double t, double dt,
+                                  Vector &xn, Vector &er)
+{
+   // k[i] = f(y + a_ii dt k[i], t + c[i] dt), y = x + dt sum_{j<i} a_ij k[j]
+   for (int l = 0, i = 0; i < s; l += i + 1, i++)
+   {
+      CombineStages(x, dt, i, a + l, k, coef, terms, y);
+
+      f->SetTime(t + c[i]*dt);
+      f->ImplicitSolve(a[l+i]*dt, y, k[i]);
+   }
+   CombineStages(x, dt, s, b, k, coef, terms, xn);
+   er = 0.0;
+   CombineStages(er, dt, s, e, k, coef, terms, er);
+}
+
+EmbeddedSDIRKSolver::~EmbeddedSDIRKSolver()
+{
+   delete [] k;
+}
+
+const double SDIRK54Solver::a[] =
+{
+   1./4,
+   1./2, 1./4,
+   17./50, -1./25, 1./4,
+   371./1360, -137./2720, 15./544, 1./4,
+   25./24, -49./48, 125./16, -85./12, 1./4
+};
+const double SDIRK54Solver::b[] =
+{
+   25./24, -49./48, 125./16, -85./12, 1./4
+};
+const double SDIRK54Solver::bh[] =
+{
+   59./48, -17./96, 225./32, -85./12, 0.
+};
+const double SDIRK54Solver::c[] =
+{
+   1./4, 3./4, 11./20, 1./2, 1.
+};
+
 }
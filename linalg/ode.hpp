@@ -15,6 +15,10 @@
 #include "../config/config.hpp"
 #include "operator.hpp"
 
+#ifdef MFEM_USE_MPI
+#include <mpi.h>
+#endif
+
 namespace mfem
 {
 
@@ -171,6 +175,13 @@ private:
    int s;
    const double *a, *b, *c;
    Vector y, *k;
+   // Work arrays for the stage combinations, see AddLinearCombination().
+   Array<double> coef;
+   Array<const Vector *> terms;
+
+   /// Compute z = x + dt sum_j w[j] k[j], j < n, skipping zero weights.
+   void CombineStages(const Vector &x, double dt, int n, const double *w,
+                      Vector &z);
 
 public:
    ExplicitRKSolver(int _s, const double *_a, const double *_b,
@@ -208,6 +219,46 @@ public:
 };
 
 
+/** @brief A low-storage explicit Runge-Kutta method in the 2N form of
+    Williamson:
+
+        dx = A[i] dx + dt f(t + c[i] dt, x),  x = x + B[i] dx,  i = 0,...,s-1,
+
+    with A[0] = 0. Besides the solution, the method stores only the increment
+    dx and the result of the operator, independently of the number of stages,
+    and each stage updates dx and x in a single pass over the data. */
+class LowStorageRKSolver : public ODESolver
+{
+private:
+   int s;
+   const double *A, *B, *c;
+   Vector dx, k;
+
+public:
+   LowStorageRKSolver(int _s, const double *_A, const double *_B,
+                      const double *_c)
+      : s(_s), A(_A), B(_B), c(_c) { }
+
+   virtual void Init(TimeDependentOperator &_f);
+
+   virtual void Step(Vector &x, double &t, double &dt);
+};
+
+
+/** The 5-stage, 4th order low-storage RK method of Carpenter and Kennedy,
+    "Fourth-order 2N-storage Runge-Kutta schemes", NASA TM-109112, 1994. It
+    needs one less vector than RK4Solver and has a larger stability region
+    along the imaginary axis per function evaluation. */
+class LSRK54Solver : public LowStorageRKSolver
+{
+private:
+   static const double A[5], B[5], c[5];
+
+public:
+   LSRK54Solver() : LowStorageRKSolver(5, A, B, c) { }
+};
+
+
 /// Backward Euler ODE solver. L-stable.
 class BackwardEulerSolver : public ODESolver
 {
@@ -282,6 +333,210 @@ public:
    virtual void Step(Vector &x, double &t, double &dt);
 };
 
+
+/** @brief Abstract base class for ODE solvers with step size control based
+    on an embedded error estimate.
+
+    Each call to Step() performs one accepted step. The step size @a dt [in] is
+    tried first; steps whose error estimate is too large are rejected and
+    repeated with a smaller step size. On output, @a t is advanced by the step
+    size that was accepted, see GetLastStep(), and @a dt is the step size
+    proposed for the next step by a PI controller, so that a time stepping loop
+    that feeds @a dt back to Step() adapts the step size automatically.
+
+    The error estimate is measured in the norm selected with SetNormType(),
+    weighted component-wise by abs_tol + rel_tol max(|x_i|, |x_new_i|); a step
+    is accepted when this norm is not larger than one. Derived classes may
+    redefine ErrorNorm() to use a different norm. */
+class AdaptiveODESolver : public ODESolver
+{
+public:
+   /// Norms available for the weighted error estimate.
+   enum NormType { MAX_NORM, RMS_NORM };
+
+#ifdef MFEM_USE_MPI
+private:
+   bool parallel;
+   MPI_Comm comm;
+#endif
+
+protected:
+   /// Order of the embedded error estimate, used in the step size control.
+   int err_order;
+   NormType norm_type;
+   double abs_tol, rel_tol;
+   double safety, min_factor, max_factor, dt_min, dt_max;
+   /// Exponents of the current and of the previous error in the PI controller.
+   double beta1, beta2;
+
+   double err_prev, dt_last;
+   bool rejected;
+   int num_accepted, num_rejected;
+
+   Vector x_new, err;
+
+   /** @brief Compute a step of size @a dt from @a x at time @a t; return the
+       new solution in @a xn and the local error estimate in @a e. */
+   virtual void TryStep(const Vector &x, double t, double dt, Vector &xn,
+                        Vector &e) = 0;
+
+   /// Called when the step computed by the last TryStep() is accepted.
+   virtual void AcceptStep() { }
+
+   /** @brief Return the weighted norm of the error estimate @a e of a step
+       from @a x0 to @a x1. */
+   virtual double ErrorNorm(const Vector &x0, const Vector &x1,
+                            const Vector &e) const;
+
+public:
+   /// The error estimate is assumed to be @a order-th order accurate.
+   AdaptiveODESolver(int order);
+
+#ifdef MFEM_USE_MPI
+   /// Compute the error norms globally over @a _comm.
+   void SetComm(MPI_Comm _comm) { parallel = true; comm = _comm; }
+#endif
+
+   virtual void Init(TimeDependentOperator &_f);
+
+   void SetTolerances(double rtol, double atol)
+   { rel_tol = rtol; abs_tol = atol; }
+   void SetNormType(NormType type) { norm_type = type; }
+   /// Set the bounds of the step size (dt_max = 0 means no upper bound).
+   void SetStepBounds(double min_dt, double max_dt)
+   { dt_min = min_dt; dt_max = max_dt; }
+   /** @brief Set the safety factor and the bounds of the ratio between two
+       consecutive step sizes. */
+   void SetStepFactors(double safe, double min_fac, double max_fac)
+   { safety = safe; min_factor = min_fac; max_factor = max_fac; }
+   /** @brief Set the exponents of the PI controller, which proposes the step
+       size h (1/err)^b1 (err_prev)^b2; @a b2 = 0 gives the classical
+       controller and @a b1 > @a b2 is required for the step size to grow. */
+   void SetControllerGains(double b1, double b2) { beta1 = b1; beta2 = b2; }
+
+   /// Return the step size of the last accepted step.
+   double GetLastStep() const { return dt_last; }
+   int GetNumAcceptedSteps() const { return num_accepted; }
+   int GetNumRejectedSteps() const { return num_rejected; }
+
+   virtual void Step(Vector &x, double &t, double &dt);
+
+   /** @brief Integrate up to @a tf, shortening the last step so that @a t
+       [out] is equal to @a tf. */
+   virtual void Run(Vector &x, double &t, double &dt, double tf);
+};
+
+
+/** An explicit Runge-Kutta method with an embedded error estimate, given by a
+    Butcher tableau as in ExplicitRKSolver, with the additional weights bh[]
+    of the embedded method. When @a fsal is true, the last stage is evaluated
+    at the new solution (first same as last) and is reused as the first stage
+    of the next step, provided that Step() is called again with the same
+    vector and time that it returned; call Init() after modifying the
+    solution vector in place. */
+class EmbeddedRKSolver : public AdaptiveODESolver
+{
+private:
+   int s;
+   const double *a, *b, *c;
+   bool fsal;
+   /// Solution data and time at which the cached first stage k[0] is valid.
+   const double *fsal_x;
+   double fsal_t, try_t, try_dt;
+   Vector y, *k;
+   Array<double> e; // b - bh
+   Array<double> coef;
+   Array<const Vector *> terms;
+
+protected:
+   virtual void TryStep(const Vector &x, double t, double dt, Vector &xn,
+                        Vector &er);
+   virtual void AcceptStep();
+
+public:
+   EmbeddedRKSolver(int _s, const double *_a, const double *_b,
+                    const double *_bh, const double *_c, int order,
+                    bool _fsal);
+
+   virtual void Init(TimeDependentOperator &_f);
+
+   virtual ~EmbeddedRKSolver();
+};
+
+
+/** The 7-stage, 5th order Dormand-Prince method with an embedded 4th order
+    error estimate (first same as last, 6 evaluations per step). */
+class DormandPrince54Solver : public EmbeddedRKSolver
+{
+private:
+   static const double a[21], b[7], bh[7], c[6];
+
+public:
+   DormandPrince54Solver() : EmbeddedRKSolver(7, a, b, bh, c, 4, true) { }
+};
+
+
+/** The 4-stage, 3rd order Bogacki-Shampine method with an embedded 2nd order
+    error estimate (first same as last, 3 evaluations per step). */
+class BogackiShampine32Solver : public EmbeddedRKSolver
+{
+private:
+   static const double a[6], b[4], bh[4], c[3];
+
+public:
+   BogackiShampine32Solver() : EmbeddedRKSolver(4, a, b, bh, c, 2, true) { }
+};
+
+
+/** A singly diagonal implicit Runge-Kutta (SDIRK) method with an embedded
+    error estimate, given by the lower triangular Butcher tableau (including
+    the diagonal, whose entries are all equal)
+    +--------+------------------------+
+    | c[0]   | a[0]                   |
+    | c[1]   | a[1] a[2]              |
+    | ...    |    ...                 |
+    | c[s-1] | ...    a[s(s+1)/2-1]   |
+    +--------+------------------------+
+    |        | b[0] b[1] ... b[s-1]   |
+    |        | bh[0] bh[1] ... bh[s-1]|
+    +--------+------------------------+
+    The stages are computed with TimeDependentOperator::ImplicitSolve(). */
+class EmbeddedSDIRKSolver : public AdaptiveODESolver
+{
+private:
+   int s;
+   const double *a, *b, *c;
+   Vector y, *k;
+   Array<double> e; // b - bh
+   Array<double> coef;
+   Array<const Vector *> terms;
+
+protected:
+   virtual void TryStep(const Vector &x, double t, double dt, Vector &xn,
+                        Vector &er);
+
+public:
+   EmbeddedSDIRKSolver(int _s, const double *_a, const double *_b,
+                       const double *_bh, const double *_c, int order);
+
+   virtual void Init(TimeDependentOperator &_f);
+
+   virtual ~EmbeddedSDIRKSolver();
+};
+
+
+/** Five stage, singly diagonal implicit Runge-Kutta (SDIRK) method of order 4
+    with an embedded 3rd order error estimate, from Hairer and Wanner, "Solving
+    Ordinary Differential Equations II", Section IV.6. L-stable. */
+class SDIRK54Solver : public EmbeddedSDIRKSolver
+{
+private:
+   static const double a[15], b[5], bh[5], c[5];
+
+public:
+   SDIRK54Solver() : EmbeddedSDIRKSolver(5, a, b, bh, c, 3) { }
+};
+
 }
 
 #endif
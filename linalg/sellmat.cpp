@@ -0,0 +1,240 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementation of class SELLMatrix
+
+#include "sellmat.hpp"
+#include "../general/sort_pairs.hpp"
+
+namespace mfem
+{
+
+SELLMatrix::SELLMatrix(const SparseMatrix &A, int C_, int sigma_)
+   : Operator(A.Height(), A.Width()), C(C_), transp(NULL)
+{
+   MFEM_VERIFY(A.Finalized(), "the matrix must be finalized");
+   MFEM_VERIFY(C == 1 || C == 2 || C == 4 || C == 8 || C == 16,
+               "invalid slice height C = " << C);
+
+   sigma = ((std::max(sigma_, 1) + C - 1)/C)*C;
+   num_slices = (height + C - 1)/C;
+
+   const int *I = A.GetI(), *J = A.GetJ();
+   const double *data = A.GetData();
+
+   // sort the rows by decreasing length within each window of sigma rows
+   Array<Pair<int,int> > row_len(height);
+   for (int i = 0; i < height; i++)
+   {
+      row_len[i].one = -(I[i+1] - I[i]);
+      row_len[i].two = i;
+   }
+   for (int w = 0; w < height; w += sigma)
+   {
+      SortPairs<int,int>(row_len.GetData() + w, std::min(sigma, height - w));
+   }
+
+   rows.SetSize(num_slices*C);
+   slice_ptr.SetSize(num_slices+1);
+   slice_ptr[0] = 0;
+   for (int s = 0; s < num_slices; s++)
+   {
+      int len = 0;
+      for (int l = 0; l < C; l++)
+      {
+         const int k = s*C + l;
+         rows[k] = (k < height) ? row_len[k].two : -1;
+         if (k < height) { len = std::max(len, -row_len[k].one); }
+      }
+      slice_ptr[s+1] = slice_ptr[s] + len*C;
+   }
+
+   cols.SetSize(slice_ptr[num_slices]);
+   vals.SetSize(slice_ptr[num_slices]);
+   for (int s = 0; s < num_slices; s++)
+   {
+      const int len = (slice_ptr[s+1] - slice_ptr[s])/C;
+      int *scols = cols.GetData() + slice_ptr[s];
+      double *svals = vals.GetData() + slice_ptr[s];
+      for (int l = 0; l < C; l++)
+      {
+         const int i = rows[s*C + l];
+         const int nnz = (i >= 0) ? I[i+1] - I[i] : 0;
+         for (int k = 0; k < len; k++)
+         {
+            if (k < nnz)
+            {
+               scols[k*C + l] = J[I[i] + k];
+               svals[k*C + l] = data[I[i] + k];
+            }
+            else
+            {
+               // padding: reuse the last column of the row, for locality
+               scols[k*C + l] = (nnz > 0) ? J[I[i] + nnz - 1] : 0;
+               svals[k*C + l] = 0.0;
+            }
+         }
+      }
+   }
+}
+
+// Compute the products with the rows of all slices; the inner loops have the
+// fixed length C so that they can be vectorized.
+template <int C>
+static void SELLAddMult(const int num_slices, const int *rows,
+                        const int *slice_ptr, const int *cols,
+                        const double *vals, const double *xp, double *yp,
+                        const double a, const bool add)
+{
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int s = 0; s < num_slices; s++)
+   {
+      double t[C];
+      for (int l = 0; l < C; l++) { t[l] = 0.0; }
+
+      const int *scols = cols + slice_ptr[s];
+      const double *svals = vals + slice_ptr[s];
+      const int len = (slice_ptr[s+1] - slice_ptr[s])/C;
+      for (int k = 0; k < len; k++)
+      {
+         for (int l = 0; l < C; l++)
+         {
+            t[l] += svals[k*C + l]*xp[scols[k*C + l]];
+         }
+      }
+
+      const int *srows = rows + s*C;
+      for (int l = 0; l < C; l++)
+      {
+         const int i = srows[l];
+         if (i < 0) { continue; }
+         if (add) { yp[i] += a*t[l]; }
+         else { yp[i] = t[l]; }
+      }
+   }
+}
+
+void SELLMatrix::AddMult(const Vector &x, Vector &y, const double a,
+                         bool add) const
+{
+   MFEM_ASSERT(x.Size() == width, "invalid input vector size");
+   MFEM_ASSERT(y.Size() == height, "invalid output vector size");
+
+   const int ns = num_slices;
+   const double *xp = x.GetData();
+   double *yp = y.GetData();
+   switch (C)
+   {
+      case 1: SELLAddMult<1>(ns, rows, slice_ptr, cols, vals, xp, yp, a, add);
+         break;
+      case 2: SELLAddMult<2>(ns, rows, slice_ptr, cols, vals, xp, yp, a, add);
+         break;
+      case 4: SELLAddMult<4>(ns, rows, slice_ptr, cols, vals, xp, yp, a, add);
+         break;
+      case 8: SELLAddMult<8>(ns, rows, slice_ptr, cols, vals, xp, yp, a, add);
+         break;
+      case 16: SELLAddMult<16>(ns, rows, slice_ptr, cols, vals, xp, yp, a, add);
+         break;
+   }
+}
+
+const SELLMatrix *SELLMatrix::GetTranspose() const
+{
+   // lock-free path: the transpose is published once it is complete
+   const SELLMatrix *At_ptr;
+#ifdef MFEM_USE_OPENMP
+   #pragma omp atomic read seq_cst
+#endif
+   At_ptr = transp;
+   if (At_ptr) { return At_ptr; }
+
+#ifdef MFEM_USE_OPENMP
+   #pragma omp critical (SELLMatrixTranspose)
+#endif
+   {
+      // another thread may have built the transpose in the meantime
+      if (!transp)
+      {
+         SparseMatrix *A = ToSparseMatrix();
+         SparseMatrix *At = Transpose(*A);
+         delete A;
+         SELLMatrix *tmp = new SELLMatrix(*At, C, sigma);
+         delete At;
+#ifdef MFEM_USE_OPENMP
+         #pragma omp atomic write seq_cst
+#endif
+         transp = tmp;
+      }
+      At_ptr = transp;
+   }
+   return At_ptr;
+}
+
+void SELLMatrix::MultTranspose(const Vector &x, Vector &y) const
+{
+   GetTranspose()->Mult(x, y);
+}
+
+void SELLMatrix::AddMultTranspose(const Vector &x, Vector &y,
+                                  const double a) const
+{
+   GetTranspose()->AddMult(x, y, a);
+}
+
+SparseMatrix *SELLMatrix::ToSparseMatrix() const
+{
+   int *I = new int[height+1];
+   for (int i = 0; i <= height; i++) { I[i] = 0; }
+   for (int s = 0; s < num_slices; s++)
+   {
+      const int len = (slice_ptr[s+1] - slice_ptr[s])/C;
+      for (int l = 0; l < C; l++)
+      {
+         const int i = rows[s*C + l];
+         if (i < 0) { continue; }
+         for (int k = 0; k < len; k++)
+         {
+            if (vals[slice_ptr[s] + k*C + l] != 0.0) { I[i+1]++; }
+         }
+      }
+   }
+   for (int i = 0; i < height; i++) { I[i+1] += I[i]; }
+
+   int *J = new int[I[height]];
+   double *data = new double[I[height]];
+   for (int s = 0; s < num_slices; s++)
+   {
+      const int len = (slice_ptr[s+1] - slice_ptr[s])/C;
+      for (int l = 0; l < C; l++)
+      {
+         const int i = rows[s*C + l];
+         if (i < 0) { continue; }
+         for (int k = 0; k < len; k++)
+         {
+            const int p = slice_ptr[s] + k*C + l;
+            if (vals[p] != 0.0)
+            {
+               J[I[i]] = cols[p];
+               data[I[i]] = vals[p];
+               I[i]++;
+            }
+         }
+      }
+   }
+   for (int i = height; i > 0; i--) { I[i] = I[i-1]; }
+   I[0] = 0;
+
+   return new SparseMatrix(I, J, data, height, width);
+}
+
+}
@@ -0,0 +1,99 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_SELLMAT
+#define MFEM_SELLMAT
+
+#include "../config/config.hpp"
+#include "../general/array.hpp"
+#include "operator.hpp"
+#include "sparsemat.hpp"
+
+namespace mfem
+{
+
+/** @brief Sparse matrix in the SELL-C-sigma (sliced ELLPACK) format, for fast
+    matrix-vector products.
+
+    The rows of the matrix are sorted by decreasing length within windows of
+    sigma consecutive rows and then grouped in slices of C rows. Each slice is
+    stored column-wise, padded with zeros to the length of its longest row, so
+    that the products with the C rows of a slice are computed together in
+    loops of fixed length C, which the compiler can vectorize. The slices are
+    processed in parallel when OpenMP is enabled.
+
+    The matrix is constructed from a finalized SparseMatrix and its entries
+    can not be modified. */
+class SELLMatrix : public Operator
+{
+protected:
+   int C, sigma;
+   int num_slices;
+   /// Original row index of each row in a slice; -1 for padding rows.
+   Array<int> rows;
+   /// Offsets of the slices in the arrays cols and vals.
+   Array<int> slice_ptr;
+   Array<int> cols;
+   Array<double> vals;
+
+   /** The transpose, constructed on the first call to MultTranspose(); the
+       construction is thread-safe. */
+   mutable SELLMatrix *transp;
+
+   void AddMult(const Vector &x, Vector &y, const double a, bool add) const;
+   const SELLMatrix *GetTranspose() const;
+
+private:
+   // not copyable: the transpose is owned
+   SELLMatrix(const SELLMatrix &);
+   SELLMatrix &operator=(const SELLMatrix &);
+
+public:
+   /** @brief Construct the SELL-C-sigma version of the finalized matrix @a A.
+
+       The slice height @a C must be 1, 2, 4, 8 or 16; it should be at least
+       the number of doubles in a SIMD register, e.g. 4 for AVX2 and 8 for
+       AVX-512. The sorting window @a sigma is rounded up to a multiple of
+       @a C; larger values reduce the padding but may reduce the locality of
+       the accesses to the output vector. */
+   SELLMatrix(const SparseMatrix &A, int C = 8, int sigma = 256);
+
+   /// Matrix vector multiplication: y = A x.
+   virtual void Mult(const Vector &x, Vector &y) const
+   { AddMult(x, y, 1.0, false); }
+
+   /// y += a A x
+   void AddMult(const Vector &x, Vector &y, const double a = 1.0) const
+   { AddMult(x, y, a, true); }
+
+   /** @brief Multiply by the transpose: y = A^t x. On the first call, the
+       transpose is constructed and stored in the SELL-C-sigma format. */
+   virtual void MultTranspose(const Vector &x, Vector &y) const;
+
+   /// y += a A^t x
+   void AddMultTranspose(const Vector &x, Vector &y,
+                         const double a = 1.0) const;
+
+   /// Returns the slice height C.
+   int GetSliceHeight() const { return C; }
+
+   /// Returns the number of stored entries, including the padding.
+   int NumStoredEntries() const { return vals.Size(); }
+
+   /// Returns a new SparseMatrix with the entries of the matrix.
+   SparseMatrix *ToSparseMatrix() const;
+
+   virtual ~SELLMatrix() { delete transp; }
+};
+
+}
+
+#endif
@@ -68,6 +68,23 @@ double IterativeSolver::Dot(const Vector &x, const Vector &y) const
 #endif
 }
 
+void IterativeSolver::GlobalSum(double *v, int n) const
+{
+#ifdef MFEM_USE_MPI
+   if (dot_prod_type != 0)
+   {
+      MPI_Allreduce(MPI_IN_PLACE, v, n, MPI_DOUBLE, MPI_SUM, comm);
+   }
+#endif
+}
+
+void IterativeSolver::Dots(int n, const Vector *x[], const Vector *y[],
+                           double *dots) const
+{
+   InnerProducts(n, x, y, dots);
+   GlobalSum(dots, n);
+}
+
 void IterativeSolver::SetPrintLevel(int print_lvl)
 {
 #ifndef MFEM_USE_MPI
@@ -358,16 +375,18 @@ void CGSolver::Mult(const Vector &b, Vector &x) const
    {
       alpha = nom/den;
       add(x,  alpha, d, x);     //  x = x + alpha d
-      add(r, -alpha, z, r);     //  r = r - alpha A d
 
       if (prec)
       {
+         add(r, -alpha, z, r);  //  r = r - alpha A d
          prec->Mult(r, z);      //  z = B r
          betanom = Dot(r, z);
       }
       else
       {
-         betanom = Dot(r, r);
+         //  r = r - alpha A d and (r, r) in one pass
+         betanom = r.AddAndDot(-alpha, z, r);
+         GlobalSum(&betanom, 1);
       }
       MFEM_ASSERT(IsFinite(betanom), "betanom = " << betanom);
 
@@ -440,6 +459,164 @@ void CGSolver::Mult(const Vector &b, Vector &x) const
    final_norm = sqrt(betanom);
 }
 
+void ChronopoulosGearCGSolver::UpdateVectors()
+{
+   r.SetSize(width);
+   u.SetSize(width);
+   w.SetSize(width);
+   p.SetSize(width);
+   s.SetSize(width);
+}
+
+void ChronopoulosGearCGSolver::Mult(const Vector &b, Vector &x) const
+{
+   // A.T. Chronopoulos and C.W. Gear, "s-step iterative methods for symmetric
+   // linear systems", 1989: the vector s = A p is updated by a recurrence, so
+   // that (B r, r) and (A B r, B r) can be computed together.
+   int i;
+   double r0, gamma, gamma0, delta, alpha, beta, den;
+
+   if (iterative_mode)
+   {
+      oper->Mult(x, r);
+      subtract(b, r, r); // r = b - A x
+   }
+   else
+   {
+      r = b;
+      x = 0.0;
+   }
+
+   // without a preconditioner, B r is r itself
+   Vector &z = prec ? u : r;
+   const Vector *dx[2] = { &z, &w };
+   const Vector *dy[2] = { &r, &z };
+   double dots[2];
+
+   if (prec)
+   {
+      prec->Mult(r, u); // u = B r
+   }
+   oper->Mult(z, w);    // w = A B r
+   Dots(2, dx, dy, dots);
+   gamma0 = gamma = dots[0];
+   delta = dots[1];
+   MFEM_ASSERT(IsFinite(gamma), "gamma = " << gamma);
+
+   if (print_level == 1 || print_level == 3)
+   {
+      cout << "   Iteration : " << setw(3) << 0 << "  (B r, r) = "
+           << gamma << (print_level == 3 ? " ...\n" : "\n");
+   }
+
+   r0 = std::max(gamma*rel_tol*rel_tol, abs_tol*abs_tol);
+   if (gamma <= r0)
+   {
+      converged = 1;
+      final_iter = 0;
+      final_norm = sqrt(gamma);
+      return;
+   }
+   if (delta <= 0.0)
+   {
+      if (print_level >= 0)
+      {
+         cout << "Negative denominator in step 0 of CG: " << delta << '\n';
+      }
+      converged = 0;
+      final_iter = 0;
+      final_norm = sqrt(gamma);
+      return;
+   }
+
+   alpha = gamma/delta;
+   p = z;
+   s = w;
+
+   // start iteration
+   converged = 0;
+   final_iter = max_iter;
+   for (i = 1; true; )
+   {
+      x.Add(alpha, p);       //  x = x + alpha p
+      r.Add(-alpha, s);      //  r = r - alpha A p
+      if (prec)
+      {
+         prec->Mult(r, u);   //  u = B r
+      }
+      oper->Mult(z, w);      //  w = A B r
+
+      beta = gamma;
+      Dots(2, dx, dy, dots); //  the only global reduction of the iteration
+      gamma = dots[0];
+      delta = dots[1];
+      MFEM_ASSERT(IsFinite(gamma), "gamma = " << gamma);
+
+      if (print_level == 1)
+      {
+         cout << "   Iteration : " << setw(3) << i << "  (B r, r) = "
+              << gamma << '\n';
+      }
+
+      if (gamma < r0)
+      {
+         if (print_level == 2)
+         {
+            cout << "Number of CG iterations: " << i << '\n';
+         }
+         else if (print_level == 3)
+         {
+            cout << "   Iteration : " << setw(3) << i << "  (B r, r) = "
+                 << gamma << '\n';
+         }
+         converged = 1;
+         final_iter = i;
+         break;
+      }
+
+      if (++i > max_iter)
+      {
+         break;
+      }
+
+      beta = gamma/beta;
+      den = delta - beta*gamma/alpha; // = (A p, p) for the new p
+      if (den <= 0.0)
+      {
+         if (print_level >= 0)
+         {
+            cout << "CG: The operator is not positive definite. (Ap, p) = "
+                 << den << '\n';
+         }
+         final_iter = i-1;
+         break;
+      }
+      alpha = gamma/den;
+      add(z, beta, p, p);    //  p = B r + beta p
+      add(w, beta, s, s);    //  s = A B r + beta s
+   }
+   if (print_level >= 0 && !converged)
+   {
+      if (print_level != 1)
+      {
+         if (print_level != 3)
+         {
+            cout << "   Iteration : " << setw(3) << 0 << "  (B r, r) = "
+                 << gamma0 << " ...\n";
+         }
+         cout << "   Iteration : " << setw(3) << final_iter << "  (B r, r) = "
+              << gamma << '\n';
+      }
+      cout << "CG: No convergence!" << '\n';
+   }
+   if (print_level >= 1 || (print_level >= 0 && !converged))
+   {
+      cout << "Average reduction factor = "
+           << pow (gamma/gamma0, 0.5/final_iter) << '\n';
+   }
+   final_norm = sqrt(gamma);
+}
+
 void CG(const Operator &A, const Vector &b, Vector &x,
         int print_iter, int max_num_iter,
         double RTOLERANCE, double ATOLERANCE)
@@ -864,6 +1041,445 @@ void GMRES(const Operator &A, Solver &B, const Vector &b, Vector &x,
 }
 
 
+void BlockIterativeSolver::OperMult(const DenseMatrix &X, DenseMatrix &Y) const
+{
+   const SparseMatrix *A = dynamic_cast<const SparseMatrix*>(oper);
+   if (A && A->Finalized())
+   {
+      A->Mult(X, Y);
+      return;
+   }
+   Y.SetSize(oper->Height(), X.Width());
+   for (int c = 0; c < X.Width(); c++)
+   {
+      Vector x(X.Data() + c*X.Height(), X.Height());
+      Vector y(Y.GetColumn(c), Y.Height());
+      oper->Mult(x, y);
+   }
+}
+
+void BlockIterativeSolver::PrecMult(const DenseMatrix &X, DenseMatrix &Y) const
+{
+   if (!prec)
+   {
+      Y = X;
+      return;
+   }
+   Y.SetSize(prec->Height(), X.Width());
+   for (int c = 0; c < X.Width(); c++)
+   {
+      Vector x(X.Data() + c*X.Height(), X.Height());
+      Vector y(Y.GetColumn(c), Y.Height());
+      prec->Mult(x, y);
+   }
+}
+
+void BlockIterativeSolver::BlockDot(const DenseMatrix &X, const DenseMatrix &Y,
+                                    DenseMatrix &G) const
+{
+   G.SetSize(X.Width(), Y.Width());
+   MultAtB(X, Y, G);
+   GlobalSum(G.Data(), G.Height()*G.Width());
+}
+
+void BlockIterativeSolver::ColumnDots(const DenseMatrix &X,
+                                      const DenseMatrix &Y, Vector &d) const
+{
+   const int n = X.Height();
+   d.SetSize(X.Width());
+   for (int c = 0; c < X.Width(); c++)
+   {
+      const double *x = X.Data() + c*n, *y = Y.Data() + c*n;
+      double dot = 0.0;
+      for (int i = 0; i < n; i++) { dot += x[i]*y[i]; }
+      d(c) = dot;
+   }
+   GlobalSum(d.GetData(), d.Size());
+}
+
+void BlockIterativeSolver::Mult(const Vector &b, Vector &x) const
+{
+   DenseMatrix B, X;
+   B.UseExternalData(b.GetData(), b.Size(), 1);
+   X.UseExternalData(x.GetData(), x.Size(), 1);
+   Solve(B, X);
+}
+
+// W += a V C, for the n x k multi-vector V and the k x l matrix C.
+static void AddMultBlock(double a, const DenseMatrix &V, const DenseMatrix &C,
+                         DenseMatrix &W)
+{
+   const int n = V.Height();
+   for (int j = 0; j < C.Width(); j++)
+   {
+      double *w = W.GetColumn(j);
+      for (int i = 0; i < V.Width(); i++)
+      {
+         const double c = a*C(i,j);
+         if (c == 0.0) { continue; }
+         const double *v = V.Data() + i*n;
+         for (int r = 0; r < n; r++) { w[r] += c*v[r]; }
+      }
+   }
+}
+
+/* Compute the k x r matrix T such that the columns of P T are orthonormal in
+   the inner product of the k x k Gram matrix G = P^T A P, with classical
+   Gram-Schmidt applied twice. The numerically dependent columns of P are
+   dropped; returns the rank r. */
+static int OrthonormalizeInGram(const DenseMatrix &G, DenseMatrix &T)
+{
+   const int k = G.Height();
+   DenseMatrix Tf(k);
+   Vector t(k), Gt(k), c(k);
+   int r = 0;
+   for (int j = 0; j < k; j++)
+   {
+      if (G(j,j) <= 0.0) { continue; }
+      t = 0.0;
+      t(j) = 1.0;
+      for (int pass = 0; pass < 2; pass++)
+      {
+         G.Mult(t, Gt);
+         for (int i = 0; i < r; i++)
+         {
+            c(i) = Vector(Tf.GetColumn(i), k)*Gt;
+         }
+         for (int i = 0; i < r; i++)
+         {
+            t.Add(-c(i), Vector(Tf.GetColumn(i), k));
+         }
+      }
+      G.Mult(t, Gt);
+      const double n2 = t*Gt;
+      if (n2 > 1e-14*G(j,j))
+      {
+         t /= sqrt(n2);
+         Vector(Tf.GetColumn(r), k) = t;
+         r++;
+      }
+   }
+   T.SetSize(k, r);
+   for (int i = 0; i < r; i++)
+   {
+      Vector(T.GetColumn(i), k) = Vector(Tf.GetColumn(i), k);
+   }
+   return r;
+}
+
+void BlockCGSolver::Solve(const DenseMatrix &B, DenseMatrix &X) const
+{
+   const int n = width, k = B.Width();
+   DenseMatrix R, Z, P, Q, PT, G, T, C;
+   Vector nom, tol(k);
+
+   if (iterative_mode && X.Height() == n && X.Width() == k)
+   {
+      OperMult(X, R);
+      Add(B, R, -1.0, R);
+   }
+   else
+   {
+      X.SetSize(n, k);
+      X = 0.0;
+      R = B;
+   }
+   PrecMult(R, Z);
+   ColumnDots(R, Z, nom);
+   for (int c = 0; c < k; c++)
+   {
+      MFEM_ASSERT(IsFinite(nom(c)) && nom(c) >= 0.0,
+                  "nom(" << c << ") = " << nom(c));
+      tol(c) = std::max(nom(c)*rel_tol*rel_tol, abs_tol*abs_tol);
+   }
+
+   if (print_level == 1 || print_level == 3)
+   {
+      cout << "   Iteration : " << setw(3) << 0 << "  max (B r, r) = "
+           << nom.Max() << (print_level == 3 ? " ...\n" : "\n");
+   }
+
+   converged = 1;
+   for (int c = 0; c < k; c++) { if (nom(c) > tol(c)) { converged = 0; } }
+   final_iter = 0;
+
+   P = Z;
+   for (int i = 1; i <= max_iter && !converged; i++)
+   {
+      // A-orthonormalize the search directions P, and Q = A P
+      OperMult(P, Q);
+      BlockDot(P, Q, G);
+      const int r = OrthonormalizeInGram(G, T);
+      if (r == 0)
+      {
+         if (print_level >= 0)
+         {
+            cout << "BlockCG: search directions are linearly dependent\n";
+         }
+         break;
+      }
+      PT.SetSize(n, r);
+      PT = 0.0;
+      AddMultBlock(1.0, P, T, PT);
+      P.SetSize(n, r);
+      P = 0.0;
+      AddMultBlock(1.0, Q, T, P);
+      Q = P;
+
+      // X += PT alpha, R -= Q alpha, with alpha = PT^T R
+      BlockDot(PT, R, C);
+      AddMultBlock(1.0, PT, C, X);
+      AddMultBlock(-1.0, Q, C, R);
+
+      PrecMult(R, Z);
+      ColumnDots(R, Z, nom);
+      final_iter = i;
+      converged = 1;
+      for (int c = 0; c < k; c++)
+      {
+         MFEM_ASSERT(IsFinite(nom(c)), "nom(" << c << ") = " << nom(c));
+         if (nom(c) > tol(c)) { converged = 0; }
+      }
+      if (print_level == 1)
+      {
+         cout << "   Iteration : " << setw(3) << i << "  max (B r, r) = "
+              << nom.Max() << '\n';
+      }
+
+      // new directions: Z made A-orthogonal to PT
+      BlockDot(Q, Z, C);
+      P = Z;
+      AddMultBlock(-1.0, PT, C, P);
+   }
+   final_norm = sqrt(std::max(nom.Max(), 0.0));
+
+   if (print_level == 2)
+   {
+      cout << "BlockCG: Number of iterations: " << final_iter << '\n';
+   }
+   else if (print_level == 3)
+   {
+      cout << "   Iteration : " << setw(3) << final_iter
+           << "  max (B r, r) = " << nom.Max() << '\n';
+   }
+   if (print_level >= 0 && !converged)
+   {
+      cout << "BlockCG: No convergence!\n";
+   }
+}
+
+void BlockGMRESSolver::Orthonormalize(DenseMatrix &W, DenseMatrix &R,
+                                      const Array<DenseMatrix*> &V,
+                                      int nv) const
+{
+   const int n = W.Height(), k = W.Width();
+   R.SetSize(k);
+   R = 0.0;
+   for (int c = 0; c < k; c++)
+   {
+      Vector w(W.GetColumn(c), n);
+      const double norm0 = Norm(w);
+      for (int i = 0; i < c; i++)
+      {
+         Vector q(W.GetColumn(i), n);
+         R(i,c) = Dot(q, w);
+         w.Add(-R(i,c), q);
+      }
+      double norm = Norm(w);
+      if (norm > 1e-12*norm0)
+      {
+         R(c,c) = norm;
+         w /= norm;
+         continue;
+      }
+
+      // replace the dependent column, twice orthogonalized
+      w.Randomize(c + 1);
+      for (int pass = 0; pass < 2; pass++)
+      {
+         for (int l = 0; l < nv; l++)
+         {
+            for (int i = 0; i < k; i++)
+            {
+               Vector q(V[l]->GetColumn(i), n);
+               w.Add(-Dot(q, w), q);
+            }
+         }
+         for (int i = 0; i < c; i++)
+         {
+            Vector q(W.GetColumn(i), n);
+            w.Add(-Dot(q, w), q);
+         }
+      }
+      w /= Norm(w);
+   }
+}
+
+void BlockGMRESSolver::Solve(const DenseMatrix &B, DenseMatrix &X) const
+{
+   const int n = width, k = B.Width(), mk = m*k;
+   DenseMatrix H((m+1)*k, mk), S((m+1)*k, k), CS(mk, k), SN(mk, k);
+   DenseMatrix W, AW, C, Y, Yl(k);
+   Array<DenseMatrix*> V(m+1);
+   Vector tol(k), res(k);
+   V = NULL;
+
+   if (!iterative_mode || X.Height() != n || X.Width() != k)
+   {
+      X.SetSize(n, k);
+      X = 0.0;
+   }
+
+   converged = 0;
+   final_iter = 0;
+   for (int j = 1, pass = 1; true; pass++)
+   {
+      // V_0 Rf = M (B - A X)
+      OperMult(X, AW);
+      W.SetSize(n, k);
+      Add(B, AW, -1.0, W);
+      if (V[0] == NULL) { V[0] = new DenseMatrix; }
+      PrecMult(W, *V[0]);
+      Orthonormalize(*V[0], C, V, 0);
+      for (int c = 0; c < k; c++)
+      {
+         res(c) = 0.0;
+         for (int i = 0; i <= c; i++) { res(c) += C(i,c)*C(i,c); }
+         res(c) = sqrt(res(c));
+         if (pass == 1) { tol(c) = std::max(rel_tol*res(c), abs_tol); }
+      }
+      converged = 1;
+      for (int c = 0; c < k; c++) { if (res(c) > tol(c)) { converged = 0; } }
+      if (pass == 1 && (print_level == 1 || print_level == 3))
+      {
+         cout << "   Pass : " << setw(2) << 1
+              << "   Iteration : " << setw(3) << 0
+              << "  max ||B r|| = " << res.Max()
+              << (print_level == 3 ? " ...\n" : "\n");
+      }
+      if (converged || j > max_iter) { break; }
+
+      H = 0.0;
+      S = 0.0;
+      for (int c = 0; c < k; c++)
+      {
+         for (int i = 0; i < k; i++) { S(i,c) = C(i,c); }
+      }
+
+      int i;
+      for (i = 0; i < m && j <= max_iter; i++, j++)
+      {
+         // block Arnoldi step: V_{i+1} H_{i+1,i} = M A V_i - sum V_l H_{l,i}
+         OperMult(*V[i], AW);
+         if (V[i+1] == NULL) { V[i+1] = new DenseMatrix; }
+         DenseMatrix &Vn = *V[i+1];
+         PrecMult(AW, Vn);
+         for (int l = 0; l <= i; l++)
+         {
+            BlockDot(*V[l], Vn, C);
+            AddMultBlock(-1.0, *V[l], C, Vn);
+            H.CopyMN(C, l*k, i*k);
+         }
+         Orthonormalize(Vn, C, V, i+1);
+         H.CopyMN(C, (i+1)*k, i*k);
+
+         // Givens rotations: the column col has nonzeros down to row col+k
+         for (int cc = 0; cc < k; cc++)
+         {
+            const int col = i*k + cc;
+            for (int pc = 0; pc < col; pc++)
+            {
+               for (int q = 0; q < k; q++)
+               {
+                  const int p = pc + k - q;
+                  ApplyPlaneRotation(H(p-1,col), H(p,col), CS(pc,q), SN(pc,q));
+               }
+            }
+            for (int q = 0; q < k; q++)
+            {
+               const int p = col + k - q;
+               GeneratePlaneRotation(H(p-1,col), H(p,col), CS(col,q),
+                                     SN(col,q));
+               ApplyPlaneRotation(H(p-1,col), H(p,col), CS(col,q), SN(col,q));
+               for (int c = 0; c < k; c++)
+               {
+                  ApplyPlaneRotation(S(p-1,c), S(p,c), CS(col,q), SN(col,q));
+               }
+            }
+         }
+
+         // the residual norms are the norms of the last k rows of S
+         converged = 1;
+         for (int c = 0; c < k; c++)
+         {
+            res(c) = 0.0;
+            for (int l = (i+1)*k; l < (i+2)*k; l++)
+            {
+               res(c) += S(l,c)*S(l,c);
+            }
+            res(c) = sqrt(res(c));
+            MFEM_ASSERT(IsFinite(res(c)), "res(" << c << ") = " << res(c));
+            if (res(c) > tol(c)) { converged = 0; }
+         }
+         final_iter = j;
+         if (print_level == 1)
+         {
+            cout << "   Pass : " << setw(2) << pass
+                 << "   Iteration : " << setw(3) << j
+                 << "  max ||B r|| = " << res.Max() << '\n';
+         }
+         if (converged) { i++; j++; break; }
+      }
+
+      // X += sum_l V_l Y_l, with H Y = S (upper triangular)
+      const int nb = i*k;
+      Y.SetSize(nb, k);
+      double max_diag = 0.0;
+      for (int l = 0; l < nb; l++)
+      {
+         max_diag = std::max(max_diag, fabs(H(l,l)));
+      }
+      for (int c = 0; c < k; c++)
+      {
+         for (int l = nb-1; l >= 0; l--)
+         {
+            double y = S(l,c);
+            for (int q = l+1; q < nb; q++) { y -= H(l,q)*Y(q,c); }
+            Y(l,c) = (fabs(H(l,l)) > 1e-14*max_diag) ? y/H(l,l) : 0.0;
+         }
+      }
+      for (int l = 0; l < i; l++)
+      {
+         Yl.CopyMN(Y, k, k, l*k, 0);
+         AddMultBlock(1.0, *V[l], Yl, X);
+      }
+      if (converged) { break; }
+      if (print_level == 1 && j <= max_iter)
+      {
+         cout << "Restarting..." << '\n';
+      }
+   }
+   final_norm = res.Max();
+
+   if (print_level == 2)
+   {
+      cout << "BlockGMRES: Number of iterations: " << final_iter << '\n';
+   }
+   else if (print_level == 3)
+   {
+      cout << "   Iteration : " << setw(3) << final_iter
+           << "  max ||B r|| = " << final_norm << '\n';
+   }
+   if (print_level >= 0 && !converged)
+   {
+      cout << "BlockGMRES: No convergence!\n";
+   }
+   for (int l = 0; l < V.Size(); l++)
+   {
+      delete V[l];
+   }
+}
+
 void BiCGSTABSolver::UpdateVectors()
 {
    p.SetSize(width);
@@ -1005,6 +1621,141 @@ void BiCGSTABSolver::Mult(const Vector &b, Vector &x) const
    converged = 0;
 }
 
+void IBiCGSTABSolver::UpdateVectors()
+{
+   r.SetSize(width);
+   rhat.SetSize(width);
+   rtilde.SetSize(width);
+   u.SetSize(width);
+   v.SetSize(width);
+   vhat.SetSize(width);
+   q.SetSize(width);
+   phat.SetSize(width);
+   s.SetSize(width);
+   shat.SetSize(width);
+   t.SetSize(width);
+}
+
+void IBiCGSTABSolver::Mult(const Vector &b, Vector &x) const
+{
+   // With M the preconditioner, the method maintains u = A M r and
+   // q = A M v. Then t = A M s = u - alpha q and all inner products needed by
+   // the iteration are linear combinations of inner products of r, v, u, q
+   // and rtilde, which are computed with a single reduction.
+   int i;
+   double resid, tol_goal = 0.0;
+   double rho = 0.0, rho_new, alpha = 1.0, beta = 0.0, omega = 1.0;
+   double ts, tt;
+
+   if (iterative_mode)
+   {
+      oper->Mult(x, r);
+      subtract(b, r, r); // r = b - A x
+   }
+   else
+   {
+      x = 0.0;
+      r = b;
+   }
+   rtilde = r;
+
+   // without a preconditioner, M r is r itself and M v is v itself
+   const Vector &rh = prec ? rhat : r;
+   const Vector &vh = prec ? vhat : v;
+   if (prec)
+   {
+      prec->Mult(r, rhat);
+   }
+   oper->Mult(rh, u);   //  u = A M r
+
+   enum { RR, TR, TV, TU, TQ, UR, UV, QR, QV, UU, UQ, QQ, NUM_DOTS };
+   const Vector *dx[NUM_DOTS] =
+   { &r, &rtilde, &rtilde, &rtilde, &rtilde, &u, &u, &q, &q, &u, &u, &q };
+   const Vector *dy[NUM_DOTS] =
+   { &r, &r, &v, &u, &q, &r, &v, &r, &v, &u, &q, &q };
+   double dots[NUM_DOTS];
+
+   for (i = 0; true; i++)
+   {
+      if (i == 0)
+      {
+         phat = rh;
+         v = u;
+      }
+      else
+      {
+         add(phat, -omega, vh, phat); //  phat = M p - omega M v
+         add(rh, beta, phat, phat);   //  phat = M r + beta phat
+         add(v, -omega, q, v);        //  v = v - omega q
+         add(u, beta, v, v);          //  v = u + beta v
+      }
+      if (prec)
+      {
+         prec->Mult(v, vhat);
+      }
+      oper->Mult(vh, q);     //  q = A M v
+
+      Dots(NUM_DOTS, dx, dy, dots); //  the only global reduction
+      resid = sqrt(std::max(dots[RR], 0.0));
+      MFEM_ASSERT(IsFinite(resid), "resid = " << resid);
+      if (i == 0)
+      {
+         tol_goal = std::max(resid*rel_tol, abs_tol);
+         rho = dots[TR];
+      }
+      if (print_level >= 0)
+      {
+         cout << "   Iteration : " << setw(3) << i
+              << "   ||r|| = " << resid << '\n';
+      }
+
+      final_norm = resid;
+      final_iter = i;
+      if (resid <= tol_goal)
+      {
+         converged = 1;
+         return;
+      }
+      if (i == max_iter || rho == 0.0 || dots[TV] == 0.0)
+      {
+         converged = 0;
+         return;
+      }
+
+      alpha = rho/dots[TV];
+      // (t, s) and (t, t) with s = r - alpha v and t = u - alpha q
+      ts = dots[UR] - alpha*(dots[UV] + dots[QR]) + alpha*alpha*dots[QV];
+      tt = dots[UU] - 2.0*alpha*dots[UQ] + alpha*alpha*dots[QQ];
+      omega = (tt > 0.0) ? ts/tt : 0.0;
+      // rho_new = (rtilde, s - omega t)
+      rho_new = (dots[TR] - alpha*dots[TV]) -
+                omega*(dots[TU] - alpha*dots[TQ]);
+
+      add(r, -alpha, v, s);    //  s = r - alpha v
+      add(rh, -alpha, vh, shat); //  shat = M s
+      add(u, -alpha, q, t);    //  t = A M s
+      x.Add(alpha, phat);      //  x = x + alpha M p
+      x.Add(omega, shat);      //  x = x + omega M s
+      add(s, -omega, t, r);    //  r = s - omega t
+
+      if (prec)
+      {
+         prec->Mult(r, rhat);
+      }
+      oper->Mult(rh, u);       //  u = A M r
+
+      if (omega == 0.0)
+      {
+         final_iter = i+1;
+         final_norm = Norm(r);
+         converged = (final_norm <= tol_goal);
+         return;
+      }
+      beta = (rho_new/rho)*(alpha/omega);
+      rho = rho_new;
+   }
+}
+
 int BiCGSTAB(const Operator &A, Vector &x, const Vector &b, Solver &M,
              int &max_iter, double &tol, double atol, int printit)
 {
@@ -1654,6 +2405,99 @@ slbqp_done:
    }
 }
 
+
+OperatorChebyshevSmoother::OperatorChebyshevSmoother(
+   const Operator &op, const Vector &diag, const Array<int> &ess_tdof_list,
+   int _order, int power_iterations, double power_tol)
+   : Solver(op.Height(), op.Width()), oper(&op), order(_order),
+     lo(0.1), hi(1.1)
+{
+   MFEM_VERIFY(diag.Size() == height, "invalid diagonal size");
+   dinv.SetSize(height);
+   for (int i = 0; i < height; i++)
+   {
+      MFEM_VERIFY(diag(i) != 0.0, "zero diagonal entry in row " << i);
+      dinv(i) = 1.0/diag(i);
+   }
+   for (int i = 0; i < ess_tdof_list.Size(); i++)
+   {
+      dinv(ess_tdof_list[i]) = 1.0;
+   }
+   r.SetSize(height);
+   d.SetSize(height);
+   z.SetSize(height);
+   EstimateLargestEigenvalue(power_iterations, power_tol);
+}
+
+void OperatorChebyshevSmoother::EstimateLargestEigenvalue(
+   int power_iterations, double power_tol)
+{
+   // Power iterations for D^{-1} A with the Rayleigh quotient in the D inner
+   // product: lambda = (v, A v) / (v, D v).
+   Vector &v = d, &Av = z;
+   v.Randomize(1);
+   v /= v.Norml2();
+   max_eig = 0.0;
+   for (int it = 0; it < power_iterations; it++)
+   {
+      oper->Mult(v, Av);
+      double vAv = 0.0, vDv = 0.0;
+      for (int i = 0; i < height; i++)
+      {
+         vAv += v(i)*Av(i);
+         vDv += v(i)*v(i)/dinv(i);
+      }
+      const double eig = vAv/vDv;
+      for (int i = 0; i < height; i++) { v(i) = dinv(i)*Av(i); }
+      v /= v.Norml2();
+      const bool done = (fabs(eig - max_eig) <= power_tol*fabs(eig));
+      max_eig = eig;
+      if (done) { break; }
+   }
+}
+
+void OperatorChebyshevSmoother::Mult(const Vector &x, Vector &y) const
+{
+   // Chebyshev iteration, see Y. Saad, "Iterative Methods for Sparse Linear
+   // Systems", Algorithm 12.1, with the preconditioner D^{-1}.
+   const double alpha = lo*max_eig, beta = hi*max_eig;
+   const double theta = 0.5*(beta + alpha), delta = 0.5*(beta - alpha);
+   const double sigma = theta/delta;
+   double rho = 1.0/sigma;
+
+   if (iterative_mode)
+   {
+      oper->Mult(y, r);
+      subtract(x, r, r);
+   }
+   else
+   {
+      r = x;
+      y = 0.0;
+   }
+   for (int i = 0; i < height; i++)
+   {
+      r(i) *= dinv(i);
+      d(i) = r(i)/theta;
+   }
+   for (int k = 0; k < order; k++)
+   {
+      y += d;
+      if (k == order - 1) { break; }
+
+      // r = D^{-1} (x - A y), updated with the correction d
+      oper->Mult(d, z);
+      const double rho_new = 1.0/(2.0*sigma - rho);
+      const double c1 = rho_new*rho, c2 = 2.0*rho_new/delta;
+      for (int i = 0; i < height; i++)
+      {
+         r(i) -= dinv(i)*z(i);
+         d(i) = c1*d(i) + c2*r(i);
+      }
+      rho = rho_new;
+   }
+}
+
 #ifdef MFEM_USE_SUITESPARSE
 
 void UMFPackSolver::Init()
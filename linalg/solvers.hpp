@@ -14,6 +14,7 @@
 
 #include "../config/config.hpp"
 #include "operator.hpp"
+#include "densemat.hpp"
 
 #ifdef MFEM_USE_MPI
 #include <mpi.h>
@@ -50,6 +51,11 @@ protected:
 
    double Dot(const Vector &x, const Vector &y) const;
    double Norm(const Vector &x) const { return sqrt(Dot(x, x)); }
+   /// Sum the @a n values in @a v over all processors, in place.
+   void GlobalSum(double *v, int n) const;
+   /** @brief Compute the @a n inner products dots[k] = (x[k], y[k]) in one
+       pass over the data and with a single global reduction. */
+   void Dots(int n, const Vector *x[], const Vector *y[], double *dots) const;
 
 public:
    IterativeSolver();
@@ -128,6 +134,35 @@ public:
    virtual void Mult(const Vector &b, Vector &x) const;
 };
 
+/** @brief Chronopoulos-Gear variant of the (preconditioned) conjugate
+    gradient method.
+
+    The two inner products of each iteration are computed together, with a
+    single pass over the data and a single global reduction, at the price of
+    one additional vector update. This reduces the number of synchronization
+    points per iteration from two to one, which is beneficial when the global
+    reductions dominate the cost, e.g. on many processors. In exact arithmetic
+    the iterates are the same as those of CGSolver. */
+class ChronopoulosGearCGSolver : public IterativeSolver
+{
+protected:
+   mutable Vector r, u, w, p, s;
+
+   void UpdateVectors();
+
+public:
+   ChronopoulosGearCGSolver() { }
+
+#ifdef MFEM_USE_MPI
+   ChronopoulosGearCGSolver(MPI_Comm _comm) : IterativeSolver(_comm) { }
+#endif
+
+   virtual void SetOperator(const Operator &op)
+   { IterativeSolver::SetOperator(op); UpdateVectors(); }
+
+   virtual void Mult(const Vector &b, Vector &x) const;
+};
+
 /// Conjugate gradient method. (tolerances are squared)
 void CG(const Operator &A, const Vector &b, Vector &x,
         int print_iter = 0, int max_num_iter = 1000,
@@ -185,6 +220,104 @@ void GMRES(const Operator &A, Solver &B, const Vector &b, Vector &x,
            double rtol = 1e-12, double atol = 1e-24);
 
 
+/** @brief Abstract base class for iterative solvers of A X = B with multiple
+    right-hand sides, given as the columns of the multi-vectors B and X
+    (column-major DenseMatrix objects with one column per vector).
+
+    When the operator is a SparseMatrix, it is applied to all vectors with
+    one pass over the matrix, see SparseMatrix::Mult(const DenseMatrix &,
+    DenseMatrix &) const; other operators and the preconditioner are applied
+    column by column. The iteration stops when the residual of every column
+    satisfies the tolerances. */
+class BlockIterativeSolver : public IterativeSolver
+{
+protected:
+   /// Y = A X.
+   void OperMult(const DenseMatrix &X, DenseMatrix &Y) const;
+   /// Y = M X with the preconditioner M, or Y = X without one.
+   void PrecMult(const DenseMatrix &X, DenseMatrix &Y) const;
+   /// G = X^T Y, summed over all processors.
+   void BlockDot(const DenseMatrix &X, const DenseMatrix &Y,
+                 DenseMatrix &G) const;
+   /// d(c) = (x_c, y_c) for the columns of X and Y, with one reduction.
+   void ColumnDots(const DenseMatrix &X, const DenseMatrix &Y,
+                   Vector &d) const;
+
+   /** @brief Solve A X = B; in iterative mode, X is the initial guess if it
+       has the size of B. */
+   virtual void Solve(const DenseMatrix &B, DenseMatrix &X) const = 0;
+
+public:
+   BlockIterativeSolver() { }
+
+#ifdef MFEM_USE_MPI
+   BlockIterativeSolver(MPI_Comm _comm) : IterativeSolver(_comm) { }
+#endif
+
+   /** @brief Solve A X = B for the columns of @a B and @a X; in iterative
+       mode, @a X is the initial guess if it has the size of @a B. */
+   void Mult(const DenseMatrix &B, DenseMatrix &X) const { Solve(B, X); }
+
+   /// Solve A x = b, as a block of one vector.
+   virtual void Mult(const Vector &b, Vector &x) const;
+};
+
+/** @brief Block (preconditioned) conjugate gradient method for symmetric
+    positive definite operators with multiple right-hand sides.
+
+    All right-hand sides share the block Krylov space, which reduces the
+    number of iterations compared to separate CG solves. The search
+    directions of each iteration are A-orthonormalized, and directions which
+    become linearly dependent, e.g. when some of the columns converge, are
+    dropped, so that the method does not break down. */
+class BlockCGSolver : public BlockIterativeSolver
+{
+protected:
+   virtual void Solve(const DenseMatrix &B, DenseMatrix &X) const;
+
+public:
+   BlockCGSolver() { }
+
+#ifdef MFEM_USE_MPI
+   BlockCGSolver(MPI_Comm _comm) : BlockIterativeSolver(_comm) { }
+#endif
+};
+
+/** @brief Block GMRES method with restarts, for multiple right-hand sides,
+    with left preconditioning as GMRESSolver.
+
+    The block Arnoldi process builds one Krylov space for all columns; the
+    least squares problem is solved with Givens rotations, which give the
+    norms of the (preconditioned) residuals of all columns at every
+    iteration. */
+class BlockGMRESSolver : public BlockIterativeSolver
+{
+protected:
+   int m;
+
+   /** @brief Orthonormalize the columns of @a W with modified Gram-Schmidt,
+       W = Q R, where Q overwrites W.
+
+       Numerically dependent columns get a zero diagonal entry in R and are
+       replaced by random vectors orthogonal to the blocks V[0], ...,
+       V[nv-1] and to the previous columns, which keeps the Hessenberg matrix
+       nonsingular. */
+   void Orthonormalize(DenseMatrix &W, DenseMatrix &R,
+                       const Array<DenseMatrix*> &V, int nv) const;
+
+   virtual void Solve(const DenseMatrix &B, DenseMatrix &X) const;
+
+public:
+   BlockGMRESSolver() { m = 50; }
+
+#ifdef MFEM_USE_MPI
+   BlockGMRESSolver(MPI_Comm _comm) : BlockIterativeSolver(_comm) { m = 50; }
+#endif
+
+   /// Set the number of block iterations between restarts.
+   void SetKDim(int dim) { m = dim; }
+};
+
 /// BiCGSTAB method
 class BiCGSTABSolver : public IterativeSolver
 {
@@ -206,6 +339,38 @@ public:
    virtual void Mult(const Vector &b, Vector &x) const;
 };
 
+/** @brief Improved BiCGSTAB method with a single global reduction per
+    iteration.
+
+    This is the variant of L.T. Yang and R.P. Brent, "The improved BiCGStab
+    method for large and sparse unsymmetric linear systems on parallel
+    distributed memory architectures", 2002, with right preconditioning. All
+    inner products of an iteration are computed together, with one pass over
+    the data and one global reduction, while BiCGSTABSolver needs three
+    separate reductions. The price is one additional preconditioner
+    application at the start and a few additional vector updates. Note that
+    the convergence test uses the norm of the residual at the start of each
+    iteration. */
+class IBiCGSTABSolver : public IterativeSolver
+{
+protected:
+   mutable Vector r, rhat, rtilde, u, v, vhat, q, phat, s, shat, t;
+
+   void UpdateVectors();
+
+public:
+   IBiCGSTABSolver() { }
+
+#ifdef MFEM_USE_MPI
+   IBiCGSTABSolver(MPI_Comm _comm) : IterativeSolver(_comm) { }
+#endif
+
+   virtual void SetOperator(const Operator &op)
+   { IterativeSolver::SetOperator(op); UpdateVectors(); }
+
+   virtual void Mult(const Vector &b, Vector &x) const;
+};
+
 /// BiCGSTAB method. (tolerances are squared)
 int BiCGSTAB(const Operator &A, Vector &x, const Vector &b, Solver &M,
              int &max_iter, double &tol, double atol, int printit);
@@ -331,6 +496,58 @@ public:
 };
 
 
+/** @brief Chebyshev accelerated Jacobi smoother, which requires only the
+    action of the operator and its diagonal, so that it can be used with
+    matrix-free (e.g. partially assembled) operators.
+
+    Mult() performs @a order steps of the Chebyshev iteration for A y = x with
+    the Jacobi preconditioner D^{-1}, i.e. y is updated by a polynomial of
+    degree @a order in D^{-1} A which is small on the interval [lo, hi] lambda,
+    where lambda is an estimate of the largest eigenvalue of D^{-1} A computed
+    with power iterations. The default interval [0.1, 1.1] lambda damps the
+    upper part of the spectrum, as needed in multigrid smoothing. The
+    operator applications are the only global operations, one per step.
+
+    The entries of @a diag in @a ess_tdof_list are replaced by one, matching
+    the rows of the ConstrainedOperator returned by FormLinearSystem(). */
+class OperatorChebyshevSmoother : public Solver
+{
+protected:
+   const Operator *oper;
+   Vector dinv;
+   int order;
+   double max_eig, lo, hi;
+   mutable Vector r, d, z;
+
+   void EstimateLargestEigenvalue(int power_iterations, double power_tol);
+
+public:
+   OperatorChebyshevSmoother(const Operator &op, const Vector &diag,
+                             const Array<int> &ess_tdof_list, int order = 2,
+                             int power_iterations = 10,
+                             double power_tol = 1e-8);
+
+   /** @brief Set the interval [@a lo_fac, @a hi_fac] lambda on which the
+       Chebyshev polynomial is minimized. */
+   void SetEigenvalueInterval(double lo_fac, double hi_fac)
+   { lo = lo_fac; hi = hi_fac; }
+
+   /// Return the estimate of the largest eigenvalue of D^{-1} A.
+   double GetMaxEigenvalue() const { return max_eig; }
+
+   /// Apply the smoother: y = y + p(D^{-1} A) D^{-1} (x - A y).
+   virtual void Mult(const Vector &x, Vector &y) const;
+
+   /// The smoother is symmetric if A is.
+   virtual void MultTranspose(const Vector &x, Vector &y) const
+   { Mult(x, y); }
+
+   /// The operator is set by the constructor.
+   virtual void SetOperator(const Operator &op)
+   { MFEM_ABORT("use the constructor to set the operator"); }
+};
+
+
 #ifdef MFEM_USE_SUITESPARSE
 
 /// Direct sparse solver using UMFPACK
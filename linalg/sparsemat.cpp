@@ -549,6 +549,73 @@ void SparseMatrix::AddMult(const Vector &x, Vector &y, const double a) const
    }
 }
 
+void SparseMatrix::Mult(const DenseMatrix &X, DenseMatrix &Y) const
+{
+   Y.SetSize(height, X.Width());
+   Y = 0.0;
+   AddMult(X, Y);
+}
+
+// y += A x for NC interleaved vectors: x[j*NC+c] is entry j of vector c.
+template <int NC>
+static void SpMMInterleaved(const int height, const int *I, const int *J,
+                            const double *A, const double *x, double *y)
+{
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int i = 0; i < height; i++)
+   {
+      double d[NC];
+      for (int c = 0; c < NC; c++) { d[c] = 0.0; }
+      for (int j = I[i], end = I[i+1]; j < end; j++)
+      {
+         const double aij = A[j];
+         const double *xj = x + J[j]*NC;
+         for (int c = 0; c < NC; c++) { d[c] += aij * xj[c]; }
+      }
+      for (int c = 0; c < NC; c++) { y[i*NC+c] = d[c]; }
+   }
+}
+
+void SparseMatrix::AddMult(const DenseMatrix &X, DenseMatrix &Y,
+                           const double a) const
+{
+   MFEM_VERIFY(Finalized(), "the matrix must be finalized");
+   MFEM_ASSERT(X.Height() == width && Y.Height() == height &&
+               X.Width() == Y.Width(), "invalid multi-vector sizes");
+
+   // The columns are processed in groups of 8, 4, 2 and 1, which are copied
+   // to interleaved buffers so that the inner loop is over the group.
+   const int k = X.Width();
+   Vector xi, yi;
+   for (int c0 = 0; c0 < k; )
+   {
+      const int nc = (k - c0 >= 8) ? 8 : (k - c0 >= 4) ? 4 :
+                     (k - c0 >= 2) ? 2 : 1;
+      xi.SetSize(width*nc);
+      yi.SetSize(height*nc);
+      for (int c = 0; c < nc; c++)
+      {
+         const double *xc = X.Data() + (c0 + c)*width;
+         for (int j = 0; j < width; j++) { xi(j*nc+c) = xc[j]; }
+      }
+      switch (nc)
+      {
+         case 8: SpMMInterleaved<8>(height, I, J, A, xi, yi); break;
+         case 4: SpMMInterleaved<4>(height, I, J, A, xi, yi); break;
+         case 2: SpMMInterleaved<2>(height, I, J, A, xi, yi); break;
+         default: SpMMInterleaved<1>(height, I, J, A, xi, yi); break;
+      }
+      for (int c = 0; c < nc; c++)
+      {
+         double *yc = Y.GetColumn(c0 + c);
+         for (int i = 0; i < height; i++) { yc[i] += a * yi(i*nc+c); }
+      }
+      c0 += nc;
+   }
+}
+
 void SparseMatrix::MultTranspose(const Vector &x, Vector &y) const
 {
    y = 0.0;
@@ -1885,6 +1952,57 @@ void SparseMatrix::AddSubMatrix(const Array<int> &rows, const Array<int> &cols,
    }
 }
 
+void SparseMatrix::AddSubMatrix(const Array<int> &rows, const Array<int> &cols,
+                                const DenseMatrix &subm, int skip_zeros,
+                                Array<int> &col_pos)
+{
+   int i, j, k, gi, gj, s, t;
+   double a;
+
+   MFEM_VERIFY(Finalized(), "the matrix must be finalized");
+   MFEM_ASSERT(col_pos.Size() == width, "invalid work array size");
+
+   for (i = 0; i < rows.Size(); i++)
+   {
+      if ((gi=rows[i]) < 0) { gi = -1-gi, s = -1; }
+      else { s = 1; }
+      MFEM_ASSERT(gi < height,
+                  "Trying to insert a row " << gi << " outside the matrix height "
+                  << height);
+      for (k = I[gi]; k < I[gi+1]; k++)
+      {
+         col_pos[J[k]] = k;
+      }
+      for (j = 0; j < cols.Size(); j++)
+      {
+         if ((gj=cols[j]) < 0) { gj = -1-gj, t = -s; }
+         else { t = s; }
+         MFEM_ASSERT(gj < width,
+                     "Trying to insert a column " << gj << " outside the matrix width "
+                     << width);
+         a = subm(i, j);
+         if (skip_zeros && a == 0.0)
+         {
+            // if the element is zero do not assemble it unless this breaks
+            // the symmetric structure
+            if (&rows != &cols || subm(j, i) == 0.0)
+            {
+               continue;
+            }
+         }
+         if (t < 0) { a = -a; }
+         k = col_pos[gj];
+         MFEM_VERIFY(k != -1,
+                     "Entry for column " << gj << " is not allocated.");
+         A[k] += a;
+      }
+      for (k = I[gi]; k < I[gi+1]; k++)
+      {
+         col_pos[J[k]] = -1;
+      }
+   }
+}
+
 void SparseMatrix::Set(const int i, const int j, const double A)
 {
    double a = A;
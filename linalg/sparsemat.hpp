@@ -186,6 +186,18 @@ public:
    /// y += A * x (default)  or  y += a * A * x
    void AddMult(const Vector &x, Vector &y, const double a = 1.0) const;
 
+   /** @brief Multiply the multi-vector @a X, whose columns are the vectors,
+       with the matrix: Y = A * X (SpMM).
+
+       The columns are processed together, in groups of up to 8, so that the
+       matrix is read once for each group instead of once for each vector. The
+       matrix must be finalized. */
+   void Mult(const DenseMatrix &X, DenseMatrix &Y) const;
+
+   /// Y += a * A * X for the multi-vectors @a X and @a Y, see Mult().
+   void AddMult(const DenseMatrix &X, DenseMatrix &Y,
+                const double a = 1.0) const;
+
    /// Multiply a vector with the transposed matrix. y = At * x
    void MultTranspose(const Vector &x, Vector &y) const;
 
@@ -318,6 +330,18 @@ public:
    void AddSubMatrix(const Array<int> &rows, const Array<int> &cols,
                      const DenseMatrix &subm, int skip_zeros = 1);
 
+   /** @brief Thread-safe version of AddSubMatrix() for finalized matrices.
+
+       Instead of the internal column pointer, uses the work array @a col_pos
+       which must have size equal to the width of the matrix and all entries
+       set to -1; on return, @a col_pos is restored to this state. Concurrent
+       calls with different work arrays are safe, as long as they update
+       disjoint sets of rows. All entries of @a subm must be in the sparsity
+       pattern of the matrix. */
+   void AddSubMatrix(const Array<int> &rows, const Array<int> &cols,
+                     const DenseMatrix &subm, int skip_zeros,
+                     Array<int> &col_pos);
+
    bool RowIsEmpty(const int row) const;
 
    /// Extract all column indices and values from a given row.
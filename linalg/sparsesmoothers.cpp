@@ -12,6 +12,7 @@
 // Implementation of data types for sparse matrix smoothers
 
 #include <iostream>
+#include <algorithm>
 #include "vector.hpp"
 #include "matrix.hpp"
 #include "sparsemat.hpp"
@@ -108,4 +109,333 @@ void DSmoother::Mult(const Vector &x, Vector &y) const
    }
 }
 
+/// Find the positions of the diagonal entries of a CSR matrix.
+static void FindDiagonal(int n, const int *I, const int *J, Array<int> &pos)
+{
+   pos.SetSize(n);
+   for (int i = 0; i < n; i++)
+   {
+      pos[i] = -1;
+      for (int k = I[i]; k < I[i+1]; k++)
+      {
+         if (J[k] == i) { pos[i] = k; break; }
+      }
+      MFEM_VERIFY(pos[i] >= 0, "missing diagonal entry in row " << i);
+   }
+}
+
+/** Group the rows of the lower (or upper) triangular part of a CSR matrix in
+    levels, such that the rows of a level depend only on rows of previous
+    levels. The rows of level l are rows[offsets[l]], ..., rows[offsets[l+1]-1].
+*/
+static void TriangularLevels(int n, const int *I, const int *J, bool lower,
+                             Array<int> &offsets, Array<int> &rows)
+{
+   Array<int> level(n);
+   int num_levels = 0;
+   for (int ii = 0; ii < n; ii++)
+   {
+      const int i = lower ? ii : n-1-ii;
+      int l = 0;
+      for (int k = I[i]; k < I[i+1]; k++)
+      {
+         const int j = J[k];
+         if ((lower && j < i) || (!lower && j > i))
+         {
+            l = std::max(l, level[j] + 1);
+         }
+      }
+      level[i] = l;
+      num_levels = std::max(num_levels, l + 1);
+   }
+
+   // counting sort by level, keeping the order of the rows in each level
+   offsets.SetSize(num_levels + 1);
+   offsets = 0;
+   for (int i = 0; i < n; i++) { offsets[level[i]+1]++; }
+   offsets.PartialSum();
+   rows.SetSize(n);
+   Array<int> next(num_levels);
+   for (int l = 0; l < num_levels; l++) { next[l] = offsets[l]; }
+   for (int i = 0; i < n; i++) { rows[next[level[i]]++] = i; }
+}
+
+
+MulticolorGSSmoother::MulticolorGSSmoother(const SparseMatrix &a, int t,
+                                           int it)
+   : SparseSmoother(a)
+{
+   type = t;
+   iterations = it;
+   Color();
+}
+
+void MulticolorGSSmoother::SetOperator(const Operator &a)
+{
+   SparseSmoother::SetOperator(a);
+   Color();
+}
+
+void MulticolorGSSmoother::Color()
+{
+   const int n = oper->Height();
+   const int *I = oper->GetI(), *J = oper->GetJ();
+   FindDiagonal(n, I, J, diag_pos);
+
+   // Greedy coloring of the graph of A + A^T, in the natural order.
+   SparseMatrix *At = Transpose(*oper);
+   const int *It = At->GetI(), *Jt = At->GetJ();
+   Array<int> color(n), mark;
+   color = -1;
+   int num_colors = 0;
+   for (int i = 0; i < n; i++)
+   {
+      mark.SetSize(num_colors + 1);
+      mark = -1;
+      for (int k = I[i]; k < I[i+1]; k++)
+      {
+         if (color[J[k]] >= 0) { mark[color[J[k]]] = i; }
+      }
+      for (int k = It[i]; k < It[i+1]; k++)
+      {
+         if (color[Jt[k]] >= 0) { mark[color[Jt[k]]] = i; }
+      }
+      int c = 0;
+      while (mark[c] == i) { c++; }
+      color[i] = c;
+      num_colors = std::max(num_colors, c + 1);
+   }
+   delete At;
+
+   color_offsets.SetSize(num_colors + 1);
+   color_offsets = 0;
+   for (int i = 0; i < n; i++) { color_offsets[color[i]+1]++; }
+   color_offsets.PartialSum();
+   color_rows.SetSize(n);
+   Array<int> next(num_colors);
+   for (int c = 0; c < num_colors; c++) { next[c] = color_offsets[c]; }
+   for (int i = 0; i < n; i++) { color_rows[next[color[i]]++] = i; }
+}
+
+void MulticolorGSSmoother::Sweep(const Vector &x, Vector &y, int color) const
+{
+   const int *I = oper->GetI(), *J = oper->GetJ(), *rows = color_rows;
+   const double *A = oper->GetData(), *xp = x.GetData();
+   double *yp = y.GetData();
+   const int begin = color_offsets[color], end = color_offsets[color+1];
+
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int r = begin; r < end; r++)
+   {
+      const int i = rows[r], d = diag_pos[i];
+      double sum = xp[i];
+      for (int k = I[i]; k < I[i+1]; k++)
+      {
+         if (k != d) { sum -= A[k]*yp[J[k]]; }
+      }
+      yp[i] = sum/A[d];
+   }
+}
+
+void MulticolorGSSmoother::Mult(const Vector &x, Vector &y) const
+{
+   if (!iterative_mode)
+   {
+      y = 0.0;
+   }
+   const int num_colors = GetNumColors();
+   for (int it = 0; it < iterations; it++)
+   {
+      if (type != 2)
+      {
+         for (int c = 0; c < num_colors; c++) { Sweep(x, y, c); }
+      }
+      if (type != 1)
+      {
+         // relaxing the last color again after the forward sweep would not
+         // change y
+         const int last = (type == 0) ? num_colors - 2 : num_colors - 1;
+         for (int c = last; c >= 0; c--) { Sweep(x, y, c); }
+      }
+   }
+}
+
+
+ILUSmoother::ILUSmoother(const SparseMatrix &a, int fill)
+   : SparseSmoother(a)
+{
+   fill_level = fill;
+   Factor();
+}
+
+void ILUSmoother::SetOperator(const Operator &a)
+{
+   SparseSmoother::SetOperator(a);
+   Factor();
+}
+
+void ILUSmoother::Factor()
+{
+   const int n = oper->Height();
+   const int *AI = oper->GetI(), *AJ = oper->GetJ();
+   const double *AV = oper->GetData();
+
+   // Symbolic factorization: the pattern of each row is built in a linked
+   // list of increasing columns, with the level of fill of each entry.
+   Array<int> lev, next(n + 1), level(n);
+   level = -1;
+   I.SetSize(n + 1);
+   I[0] = 0;
+   J.SetSize(0);
+   diag_pos.SetSize(n);
+   for (int i = 0; i < n; i++)
+   {
+      const int head = n;
+      next[head] = -1;
+      for (int k = AI[i+1] - 1; k >= AI[i]; k--)
+      {
+         // the columns of A may not be sorted: insert in order
+         const int j = AJ[k];
+         int p = head;
+         while (next[p] >= 0 && next[p] < j) { p = next[p]; }
+         if (next[p] != j)
+         {
+            next[j] = next[p];
+            next[p] = j;
+            level[j] = 0;
+         }
+      }
+      if (level[i] < 0)
+      {
+         // structurally zero diagonal
+         int p = head;
+         while (next[p] >= 0 && next[p] < i) { p = next[p]; }
+         next[i] = next[p];
+         next[p] = i;
+         level[i] = 0;
+      }
+      if (fill_level > 0)
+      {
+         for (int k = next[head]; k < i; k = next[k])
+         {
+            // fill from row k: the entries of U in row k
+            int p = k;
+            for (int m = diag_pos[k] + 1; m < I[k+1]; m++)
+            {
+               const int j = J[m];
+               const int l = level[k] + lev[m] + 1;
+               if (l > fill_level) { continue; }
+               while (next[p] >= 0 && next[p] < j) { p = next[p]; }
+               if (next[p] != j)
+               {
+                  next[j] = next[p];
+                  next[p] = j;
+                  level[j] = l;
+               }
+               else if (l < level[j])
+               {
+                  level[j] = l;
+               }
+            }
+         }
+      }
+      for (int k = next[head]; k >= 0; k = next[k])
+      {
+         if (k == i) { diag_pos[i] = J.Size(); }
+         J.Append(k);
+         lev.Append(level[k]);
+         level[k] = -1;
+      }
+      I[i+1] = J.Size();
+   }
+
+   // Numeric factorization, IKJ variant.
+   const int nnz = J.Size();
+   data.SetSize(nnz);
+   Array<int> pos(n);
+   pos = -1;
+   for (int i = 0; i < n; i++)
+   {
+      for (int m = I[i]; m < I[i+1]; m++)
+      {
+         pos[J[m]] = m;
+         data[m] = 0.0;
+      }
+      for (int k = AI[i]; k < AI[i+1]; k++)
+      {
+         data[pos[AJ[k]]] += AV[k];
+      }
+      for (int m = I[i]; m < diag_pos[i]; m++)
+      {
+         const int k = J[m];
+         const double l_ik = (data[m] /= data[diag_pos[k]]);
+         for (int q = diag_pos[k] + 1; q < I[k+1]; q++)
+         {
+            if (pos[J[q]] >= 0) { data[pos[J[q]]] -= l_ik*data[q]; }
+         }
+      }
+      MFEM_VERIFY(data[diag_pos[i]] != 0.0, "zero pivot in row " << i);
+      for (int m = I[i]; m < I[i+1]; m++) { pos[J[m]] = -1; }
+   }
+
+   TriangularLevels(n, I, J, true, lower_offsets, lower_rows);
+   TriangularLevels(n, I, J, false, upper_offsets, upper_rows);
+}
+
+void ILUSmoother::Solve(const Vector &b, Vector &x) const
+{
+   const int *Ip = I, *Jp = J, *dp = diag_pos;
+   const double *A = data, *bp = b.GetData();
+   double *xp = x.GetData();
+
+   // forward solve with the unit lower triangular L
+   for (int l = 0; l < lower_offsets.Size() - 1; l++)
+   {
+      const int *rows = lower_rows.GetData();
+#ifdef MFEM_USE_OPENMP
+      #pragma omp parallel for
+#endif
+      for (int r = lower_offsets[l]; r < lower_offsets[l+1]; r++)
+      {
+         const int i = rows[r];
+         double sum = bp[i];
+         for (int k = Ip[i]; k < dp[i]; k++) { sum -= A[k]*xp[Jp[k]]; }
+         xp[i] = sum;
+      }
+   }
+
+   // backward solve with U
+   for (int l = 0; l < upper_offsets.Size() - 1; l++)
+   {
+      const int *rows = upper_rows.GetData();
+#ifdef MFEM_USE_OPENMP
+      #pragma omp parallel for
+#endif
+      for (int r = upper_offsets[l]; r < upper_offsets[l+1]; r++)
+      {
+         const int i = rows[r];
+         double sum = xp[i];
+         for (int k = dp[i] + 1; k < Ip[i+1]; k++) { sum -= A[k]*xp[Jp[k]]; }
+         xp[i] = sum/A[dp[i]];
+      }
+   }
+}
+
+void ILUSmoother::Mult(const Vector &x, Vector &y) const
+{
+   if (!iterative_mode)
+   {
+      Solve(x, y);
+      return;
+   }
+   z.SetSize(height);
+   w.SetSize(height);
+   oper->Mult(y, z);
+   subtract(x, z, z);
+   Solve(z, w);
+   y += w;
+}
+
 }
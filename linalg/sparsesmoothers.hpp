@@ -73,6 +73,91 @@ public:
    virtual void Mult(const Vector &x, Vector &y) const;
 };
 
+/** @brief Multicolor Gauss-Seidel smoother of a sparse matrix.
+
+    The rows are colored greedily so that rows of the same color are not
+    coupled in the (symmetrized) graph of the matrix; the rows of each color
+    are then relaxed in parallel when OpenMP is enabled. The result is the
+    Gauss-Seidel iteration for the matrix reordered by colors; the symmetric
+    sweep (forward over the colors, then backward) is a symmetric
+    preconditioner for symmetric matrices. */
+class MulticolorGSSmoother : public SparseSmoother
+{
+protected:
+   int type; // 0, 1, 2 - symmetric, forward, backward
+   int iterations;
+
+   /// Rows of each color and positions of the diagonal entries.
+   Array<int> color_offsets, color_rows, diag_pos;
+
+   void Color();
+   void Sweep(const Vector &x, Vector &y, int color) const;
+
+public:
+   /// Create MulticolorGSSmoother.
+   MulticolorGSSmoother(int t = 0, int it = 1) { type = t; iterations = it; }
+
+   /// Create MulticolorGSSmoother and color the graph of @a a.
+   MulticolorGSSmoother(const SparseMatrix &a, int t = 0, int it = 1);
+
+   /// Set the matrix and color its graph.
+   virtual void SetOperator(const Operator &a);
+
+   /// Return the number of colors.
+   int GetNumColors() const { return color_offsets.Size() - 1; }
+
+   /// Matrix vector multiplication with the multicolor GS smoother.
+   virtual void Mult(const Vector &x, Vector &y) const;
+};
+
+/** @brief Incomplete LU factorization ILU(k) of a sparse matrix, with level
+    of fill k (ILU(0) keeps the pattern of the matrix).
+
+    The factors are stored in one matrix, with the unit lower triangular L
+    below the diagonal. The triangular solves are level-scheduled: the rows
+    are grouped in levels whose rows only depend on rows of the previous
+    levels, and the rows of each level are processed in parallel when OpenMP
+    is enabled. Mult() applies (LU)^{-1}, or performs one step of the
+    corresponding iteration in iterative mode. */
+class ILUSmoother : public SparseSmoother
+{
+protected:
+   int fill_level;
+
+   /// The factors L and U in CSR format and the positions of the diagonal.
+   Array<int> I, J, diag_pos;
+   Array<double> data;
+
+   /// Level schedules of the forward (L) and backward (U) solves.
+   Array<int> lower_offsets, lower_rows, upper_offsets, upper_rows;
+
+   mutable Vector z, w;
+
+   void Factor();
+   void Solve(const Vector &b, Vector &x) const;
+
+public:
+   /// Create ILU(@a fill) without a matrix, see SetOperator().
+   ILUSmoother(int fill = 0) { fill_level = fill; }
+
+   /// Create and compute the ILU(@a fill) factorization of @a a.
+   ILUSmoother(const SparseMatrix &a, int fill = 0);
+
+   /// Set the matrix and compute its factorization.
+   virtual void SetOperator(const Operator &a);
+
+   /// Return the number of nonzeros of the factors.
+   int NumNonZeroElems() const { return J.Size(); }
+
+   /** @brief Return the number of levels of the forward (@a lower = true) or
+       backward triangular solve. */
+   int GetNumLevels(bool lower) const
+   { return (lower ? lower_offsets.Size() : upper_offsets.Size()) - 1; }
+
+   /// Apply the ILU preconditioner.
+   virtual void Mult(const Vector &x, Vector &y) const;
+};
+
 }
 
 #endif
@@ -24,6 +24,7 @@
 #include <cstdlib>
 #include <ctime>
 #include <limits>
+#include <algorithm>
 
 namespace mfem
 {
@@ -220,6 +221,30 @@ Vector &Vector::Add(const double a, const Vector &Va)
    return *this;
 }
 
+double Vector::AddAndDot(const double a, const Vector &x, const Vector &w)
+{
+#ifdef MFEM_DEBUG
+   if (size != x.size || size != w.size)
+   {
+      mfem_error("Vector::AddAndDot(const double, const Vector &, "
+                 "const Vector &)");
+   }
+#endif
+   const int s = size;
+   double *d = data;
+   const double *xp = x.data, *wp = w.data;
+   double prod = 0.0;
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for reduction(+:prod)
+#endif
+   for (int i = 0; i < s; i++)
+   {
+      d[i] += a * xp[i];
+      prod += d[i] * wp[i];
+   }
+   return prod;
+}
+
 Vector &Vector::Set(const double a, const Vector &Va)
 {
 #ifdef MFEM_DEBUG
@@ -409,6 +434,84 @@ void subtract(const Vector &x, const Vector &y, Vector &z)
    }
 }
 
+void InnerProducts(int n, const Vector *x[], const Vector *y[], double *dots)
+{
+   MFEM_ASSERT(n > 0, "invalid number of inner products: " << n);
+   const int s = x[0]->Size();
+   Array<const double *> xd(n), yd(n);
+   for (int k = 0; k < n; k++)
+   {
+      MFEM_ASSERT(x[k]->Size() == s && y[k]->Size() == s,
+                  "incompatible vector sizes");
+      xd[k] = x[k]->GetData();
+      yd[k] = y[k]->GetData();
+      dots[k] = 0.0;
+   }
+
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel
+#endif
+   {
+      Vector sums(n);
+      sums = 0.0;
+#ifdef MFEM_USE_OPENMP
+      #pragma omp for
+#endif
+      for (int i = 0; i < s; i++)
+      {
+         for (int k = 0; k < n; k++)
+         {
+            sums(k) += xd[k][i] * yd[k][i];
+         }
+      }
+#ifdef MFEM_USE_OPENMP
+      #pragma omp critical
+#endif
+      for (int k = 0; k < n; k++)
+      {
+         dots[k] += sums(k);
+      }
+   }
+}
+
+void AddLinearCombination(const Vector &x, int n, const double *a,
+                          const Vector *y[], Vector &z)
+{
+   const int s = x.Size();
+   MFEM_ASSERT(z.Size() == s, "incompatible vector sizes");
+   const double *xd = x.GetData();
+   double *zd = z.GetData();
+
+   // The entries are processed in blocks which stay in cache while the terms
+   // are accumulated.
+   const int bsize = 256;
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int b = 0; b < s; b += bsize)
+   {
+      const int bs = std::min(bsize, s - b);
+      double r[bsize];
+      for (int i = 0; i < bs; i++)
+      {
+         r[i] = xd[b + i];
+      }
+      for (int k = 0; k < n; k++)
+      {
+         MFEM_ASSERT(y[k]->Size() == s, "incompatible vector sizes");
+         const double ak = a[k], *yk = y[k]->GetData() + b;
+         for (int i = 0; i < bs; i++)
+         {
+            r[i] += ak * yk[i];
+         }
+      }
+      for (int i = 0; i < bs; i++)
+      {
+         zd[b + i] = r[i];
+      }
+   }
+}
+
 void subtract(const double a, const Vector &x, const Vector &y, Vector &z)
 {
 #ifdef MFEM_DEBUG
@@ -177,6 +177,11 @@ public:
    /// (*this) += a * Va
    Vector & Add(const double a, const Vector &Va);
 
+   /// (*this) += a * x; returns the inner product of the result with @a w.
+   /** The update and the inner product are computed in a single pass over the
+       data; @a w may be the vector itself. */
+   double AddAndDot(const double a, const Vector &x, const Vector &w);
+
    /// (*this) = a * x
    Vector & Set(const double a, const Vector &x);
 
@@ -399,6 +404,23 @@ inline double InnerProduct(const Vector &x, const Vector &y)
    return x * y;
 }
 
+/** @brief Compute the @a n inner products dots[k] = (x[k], y[k]) in a single
+    pass over the data.
+
+    All vectors must have the same size; vectors appearing in several pairs
+    are read once. In parallel this computes the inner products of the local
+    vectors. */
+void InnerProducts(int n, const Vector *x[], const Vector *y[], double *dots);
+
+/** @brief Compute z = x + sum_k a[k] y[k], k = 0,...,n-1, in a single pass
+    over the data.
+
+    All vectors must have the same size and @a z may be the same as @a x. This
+    is equivalent to a sequence of n calls to Vector::Add(), but reads and
+    writes @a z only once. */
+void AddLinearCombination(const Vector &x, int n, const double *a,
+                          const Vector *y[], Vector &z);
+
 #ifdef MFEM_USE_MPI
 /// Returns the inner product of x and y in parallel
 /** In parallel this computes the inner product of the global vectors,
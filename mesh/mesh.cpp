@@ -85,6 +85,13 @@ double Mesh::GetElementVolume(int i)
    return volume;
 }
 
+void Mesh::GetElementCenter(int i, Vector &center)
+{
+   center.SetSize(spaceDim);
+   ElementTransformation *et = GetElementTransformation(i);
+   et->Transform(Geometries.GetCenter(GetElementBaseGeometry(i)), center);
+}
+
 // Similar to VisualizationSceneSolution3d::FindNewBox in GLVis
 void Mesh::GetBoundingBox(Vector &min, Vector &max, int ref)
 {
@@ -614,36 +621,53 @@ void Mesh::GetLocalFaceTransformation(
 
 FaceElementTransformations *Mesh::GetFaceElementTransformations(int FaceNo,
                                                                 int mask)
+{
+   GetFaceElementTransformations(FaceNo, FaceElemTr, Transformation,
+                                 Transformation2, FaceTransformation, mask);
+   return &FaceElemTr;
+}
+
+void Mesh::GetFaceElementTransformations(int FaceNo,
+                                         FaceElementTransformations &FElTr,
+                                         IsoparametricTransformation &ElTr1,
+                                         IsoparametricTransformation &ElTr2,
+                                         IsoparametricTransformation &FTr,
+                                         int mask)
 {
    FaceInfo &face_info = faces_info[FaceNo];
 
-   FaceElemTr.Elem1 = NULL;
-   FaceElemTr.Elem2 = NULL;
+   FElTr.Elem1 = NULL;
+   FElTr.Elem2 = NULL;
 
    // setup the transformation for the first element
-   FaceElemTr.Elem1No = face_info.Elem1No;
+   FElTr.Elem1No = face_info.Elem1No;
    if (mask & 1)
    {
-      GetElementTransformation(FaceElemTr.Elem1No, &Transformation);
-      FaceElemTr.Elem1 = &Transformation;
+      GetElementTransformation(FElTr.Elem1No, &ElTr1);
+      FElTr.Elem1 = &ElTr1;
    }
 
    //  setup the transformation for the second element
    //     return NULL in the Elem2 field if there's no second element, i.e.
    //     the face is on the "boundary"
-   FaceElemTr.Elem2No = face_info.Elem2No;
-   if ((mask & 2) && FaceElemTr.Elem2No >= 0)
+   FElTr.Elem2No = face_info.Elem2No;
+   if ((mask & 2) && FElTr.Elem2No >= 0)
    {
 #ifdef MFEM_DEBUG
       if (NURBSext && (mask & 1)) { MFEM_ABORT("NURBS mesh not supported!"); }
 #endif
-      GetElementTransformation(FaceElemTr.Elem2No, &Transformation2);
-      FaceElemTr.Elem2 = &Transformation2;
+      GetElementTransformation(FElTr.Elem2No, &ElTr2);
+      FElTr.Elem2 = &ElTr2;
    }
 
    // setup the face transformation
-   FaceElemTr.FaceGeom = GetFaceGeometryType(FaceNo);
-   FaceElemTr.Face = (mask & 16) ? GetFaceTransformation(FaceNo) : NULL;
+   FElTr.FaceGeom = GetFaceGeometryType(FaceNo);
+   FElTr.Face = NULL;
+   if (mask & 16)
+   {
+      GetFaceTransformation(FaceNo, &FTr);
+      FElTr.Face = &FTr;
+   }
 
    // setup Loc1 & Loc2
    int face_type = GetFaceElementType(FaceNo);
@@ -651,30 +675,28 @@ FaceElementTransformations *Mesh::GetFaceElementTransformations(int FaceNo,
    {
       int elem_type = GetElementType(face_info.Elem1No);
       GetLocalFaceTransformation(face_type, elem_type,
-                                 FaceElemTr.Loc1.Transf, face_info.Elem1Inf);
+                                 FElTr.Loc1.Transf, face_info.Elem1Inf);
    }
-   if ((mask & 8) && FaceElemTr.Elem2No >= 0)
+   if ((mask & 8) && FElTr.Elem2No >= 0)
    {
       int elem_type = GetElementType(face_info.Elem2No);
       GetLocalFaceTransformation(face_type, elem_type,
-                                 FaceElemTr.Loc2.Transf, face_info.Elem2Inf);
+                                 FElTr.Loc2.Transf, face_info.Elem2Inf);
 
       // NC meshes: prepend slave edge/face transformation to Loc2
       if (Nonconforming() && IsSlaveFace(face_info))
       {
-         ApplyLocalSlaveTransformation(FaceElemTr.Loc2.Transf, face_info);
+         ApplyLocalSlaveTransformation(FElTr.Loc2.Transf, face_info);
 
          if (face_type == Element::SEGMENT)
          {
             // flip Loc2 to match Loc1 and Face
-            DenseMatrix &pm = FaceElemTr.Loc2.Transf.GetPointMat();
+            DenseMatrix &pm = FElTr.Loc2.Transf.GetPointMat();
             std::swap(pm(0,0), pm(0,1));
             std::swap(pm(1,0), pm(1,1));
          }
       }
    }
-
-   return &FaceElemTr;
 }
 
 bool Mesh::IsSlaveFace(const FaceInfo &fi) const
@@ -697,28 +719,30 @@ void Mesh::ApplyLocalSlaveTransformation(IsoparametricTransformation &transf,
 
 FaceElementTransformations *Mesh::GetBdrFaceTransformations(int BdrElemNo)
 {
-   FaceElementTransformations *tr;
-   int fn;
-   if (Dim == 3)
+   if (!GetBdrFaceTransformations(BdrElemNo, FaceElemTr, Transformation,
+                                  FaceTransformation))
    {
-      fn = be_to_face[BdrElemNo];
-   }
-   else if (Dim == 2)
-   {
-      fn = be_to_edge[BdrElemNo];
-   }
-   else
-   {
-      fn = boundary[BdrElemNo]->GetVertices()[0];
+      return NULL;
    }
+   return &FaceElemTr;
+}
+
+bool Mesh::GetBdrFaceTransformations(int BdrElemNo,
+                                     FaceElementTransformations &FElTr,
+                                     IsoparametricTransformation &ElTr1,
+                                     IsoparametricTransformation &FTr)
+{
+   int fn = GetBdrElementEdgeIndex(BdrElemNo);
    // Check if the face is interior, shared, or non-conforming.
    if (FaceIsTrueInterior(fn) || faces_info[fn].NCFace >= 0)
    {
-      return NULL;
+      return false;
    }
-   tr = GetFaceElementTransformations(fn);
-   tr->Face->Attribute = boundary[BdrElemNo]->GetAttribute();
-   return tr;
+   // There is no second element: the transformation ElTr1 is passed in place
+   // of the (unused) second element transformation.
+   GetFaceElementTransformations(fn, FElTr, ElTr1, ElTr1, FTr, 1|4|16);
+   FElTr.Face->Attribute = boundary[BdrElemNo]->GetAttribute();
+   return true;
 }
 
 void Mesh::GetFaceElements(int Face, int *Elem1, int *Elem2)
@@ -757,6 +781,7 @@ void Mesh::Init()
    own_nodes = 1;
    NURBSext = NULL;
    ncmesh = NULL;
+   point_locator = NULL;
    last_operation = Mesh::NONE;
 }
 
@@ -797,6 +822,8 @@ void Mesh::DestroyPointers()
 {
    if (own_nodes) { delete Nodes; }
 
+   DeleteGeometricCaches();
+
    delete ncmesh;
 
    delete NURBSext;
@@ -819,6 +846,22 @@ void Mesh::DestroyPointers()
    DestroyTables();
 }
 
+void Mesh::DeleteGeometricFactors()
+{
+   for (int i = 0; i < geom_factors.Size(); i++)
+   {
+      delete geom_factors[i];
+   }
+   geom_factors.SetSize(0);
+}
+
+void Mesh::DeleteGeometricCaches()
+{
+   DeleteGeometricFactors();
+   delete point_locator;
+   point_locator = NULL;
+}
+
 void Mesh::Destroy()
 {
    DestroyPointers();
@@ -1171,6 +1214,113 @@ void Mesh::GetGeckoElementReordering(Array<int> &ordering)
 }
 #endif
 
+// Return the index of the point with integer coordinates X[0..n-1], each with
+// b bits, along the Hilbert curve (if hilbert is true) or the Morton curve.
+// The Hilbert index is computed as in: J. Skilling, "Programming the Hilbert
+// curve", AIP Conf. Proc. 707, 381 (2004).
+static unsigned long long SFCIndex(unsigned int *X, int n, int b, bool hilbert)
+{
+   if (hilbert && n > 1)
+   {
+      // inverse undo excess work
+      const unsigned int M = 1U << (b - 1);
+      for (unsigned int Q = M; Q > 1; Q >>= 1)
+      {
+         const unsigned int P = Q - 1;
+         for (int i = 0; i < n; i++)
+         {
+            if (X[i] & Q) { X[0] ^= P; }
+            else
+            {
+               const unsigned int t = (X[0] ^ X[i]) & P;
+               X[0] ^= t;
+               X[i] ^= t;
+            }
+         }
+      }
+      // Gray encode
+      for (int i = 1; i < n; i++) { X[i] ^= X[i-1]; }
+      unsigned int t = 0;
+      for (unsigned int Q = M; Q > 1; Q >>= 1)
+      {
+         if (X[n-1] & Q) { t ^= Q - 1; }
+      }
+      for (int i = 0; i < n; i++) { X[i] ^= t; }
+   }
+
+   // interleave the bits of the coordinates, most significant bits first
+   unsigned long long index = 0;
+   for (int j = b - 1; j >= 0; j--)
+   {
+      for (int i = 0; i < n; i++)
+      {
+         index = (index << 1) | ((X[i] >> j) & 1U);
+      }
+   }
+   return index;
+}
+
+void Mesh::GetSFCElementOrdering(Array<int> &ordering, bool hilbert)
+{
+   const int NE = GetNE();
+   const int n = spaceDim;
+   // bits per coordinate, so that the index fits in 63 bits
+   const int b = std::min(63/n, 31);
+
+   DenseMatrix centers(n, NE);
+   Vector center;
+   for (int i = 0; i < NE; i++)
+   {
+      GetElementCenter(i, center);
+      centers.SetCol(i, center);
+   }
+
+   // map the bounding box of the centers to the integer grid [0,2^b)^n,
+   // with the same scaling in all directions
+   double min[3], max_ext = 0.0;
+   for (int d = 0; d < n; d++)
+   {
+      min[d] = numeric_limits<double>::infinity();
+      double max = -numeric_limits<double>::infinity();
+      for (int i = 0; i < NE; i++)
+      {
+         min[d] = std::min(min[d], centers(d,i));
+         max = std::max(max, centers(d,i));
+      }
+      max_ext = std::max(max_ext, max - min[d]);
+   }
+   const double scale = (max_ext > 0.0) ? ((1U << b) - 1)/max_ext : 0.0;
+
+   Array<Pair<unsigned long long, int> > indices(NE);
+   for (int i = 0; i < NE; i++)
+   {
+      unsigned int X[3];
+      for (int d = 0; d < n; d++)
+      {
+         X[d] = (unsigned int)((centers(d,i) - min[d])*scale + 0.5);
+      }
+      indices[i].one = SFCIndex(X, n, b, hilbert);
+      indices[i].two = i;
+   }
+   SortPairs<unsigned long long, int>(indices.GetData(), NE);
+
+   ordering.SetSize(NE);
+   for (int k = 0; k < NE; k++)
+   {
+      ordering[indices[k].two] = k;
+   }
+}
+
+void Mesh::GetHilbertElementOrdering(Array<int> &ordering)
+{
+   GetSFCElementOrdering(ordering, true);
+}
+
+void Mesh::GetMortonElementOrdering(Array<int> &ordering)
+{
+   GetSFCElementOrdering(ordering, false);
+}
+
 
 void Mesh::ReorderElements(const Array<int> &ordering, bool reorder_vertices)
 {
@@ -1187,6 +1337,9 @@ void Mesh::ReorderElements(const Array<int> &ordering, bool reorder_vertices)
    }
    MFEM_VERIFY(ordering.Size() == GetNE(), "invalid reordering array.")
 
+   // the cached data is stored in the old element order
+   DeleteGeometricCaches();
+
    // Data members that need to be updated:
 
    // - elements   - reorder of the pointers and the vertex ids if reordering
@@ -1303,10 +1456,17 @@ void Mesh::ReorderElements(const Array<int> &ordering, bool reorder_vertices)
    // Update faces and faces_info
    GenerateFaces();
 
+   // The DOFs of the finite element spaces follow the new numbering of the
+   // elements, vertices, edges and faces: increase the sequence so that the
+   // spaces are rebuilt by their Update() methods.
+   sequence++;
+   last_operation = Mesh::NONE;
+
    // Build the nodes from the saved locations if they were around before
    if (Nodes)
    {
-      nodes_fes->Update();
+      nodes_fes->Update(false);
+      Nodes->Update();
       Array<int> new_dofs;
       for (int old_elid = 0; old_elid < GetNE(); ++old_elid)
       {
@@ -2290,6 +2450,7 @@ Mesh::Mesh(const Mesh &mesh, bool copy_nodes)
    // Create the new Mesh instance without a record of its refinement history
    sequence = 0;
    last_operation = Mesh::NONE;
+   point_locator = NULL;
 
    // Duplicate the elements
    elements.SetSize(NumOfElements);
@@ -2395,6 +2556,16 @@ Mesh::Mesh(const char *filename, int generate_edges, int refine,
    }
 }
 
+Mesh::Mesh(MappedFile &file, int generate_edges, int refine,
+           bool fix_orientation)
+{
+   // Initialization as in the default constructor
+   SetEmpty();
+
+   LoadBinary(file.GetData(), file.Size(), false);
+   Finalize(refine, fix_orientation);
+}
+
 Mesh::Mesh(std::istream &input, int generate_edges, int refine,
            bool fix_orientation)
 {
@@ -2554,6 +2725,35 @@ void Mesh::SetMeshGen()
    }
 }
 
+// Binary mesh format, see Mesh::PrintBinary(): the 32-byte identification
+// string, followed by the header fields below, stored as little-endian 64-bit
+// integers, and the sections at the given offsets. The elements are stored in
+// three sections: the attributes and the geometry types (int32 per element)
+// and the vertex indices of all elements (int32). The vertex coordinates
+// (double, byVDIM) are stored only when the mesh has no Nodes; otherwise the
+// Nodes are stored as a block in the binary GridFunction format.
+static const char mesh_binary_ident[] = "MFEM binary mesh v1.0\n";
+enum
+{
+   MB_FILE_SIZE,
+   MB_DIMENSION,
+   MB_SPACE_DIMENSION,
+   MB_NUM_VERTICES,
+   MB_NUM_ELEMENTS,
+   MB_NUM_BDR_ELEMENTS,
+   MB_ELEM_ATTR_OFFSET,
+   MB_ELEM_GEOM_OFFSET,
+   MB_ELEM_VERT_OFFSET,
+   MB_BDR_ATTR_OFFSET,
+   MB_BDR_GEOM_OFFSET,
+   MB_BDR_VERT_OFFSET,
+   MB_VERTICES_OFFSET, // 0 if the mesh has Nodes
+   MB_NODES_OFFSET,    // 0 if the mesh has no Nodes
+   MB_RESERVED_1,
+   MB_RESERVED_2,
+   MB_NUM_FIELDS
+};
+
 void Mesh::Loader(std::istream &input, int generate_edges,
                   std::string parse_tag)
 {
@@ -2625,6 +2825,15 @@ void Mesh::Loader(std::istream &input, int generate_edges,
    {
       ReadGmshMesh(input);
    }
+   else if (mesh_type + '\n' == mesh_binary_ident)
+   {
+      char *buf;
+      long long size;
+      bin_io::ReadBlock(input, mesh_binary_ident, MB_NUM_FIELDS, buf, size);
+      LoadBinary(buf, size, true);
+      delete [] buf;
+      return; // done with binary mesh construction
+   }
    else if
    ((mesh_type.size() > 2 &&
      mesh_type[0] == 'C' && mesh_type[1] == 'D' && mesh_type[2] == 'F') ||
@@ -2717,6 +2926,134 @@ void Mesh::Loader(std::istream &input, int generate_edges,
    // Finalize(...) should be called after this, if needed.
 }
 
+// Return the 'n' little-endian int32 values at 'buf': on little-endian hosts,
+// the data is used directly, otherwise it is converted in 'tmp'.
+static const int *GetBinaryInts(const char *buf, long long n, Array<int> &tmp)
+{
+   if (bin_io::IsLittleEndian())
+   {
+      return reinterpret_cast<const int *>(buf);
+   }
+   tmp.SetSize(n);
+   bin_io::ReadLittleEndian(buf, tmp.GetData(), n);
+   return tmp.GetData();
+}
+
+// Create 'num' elements from the attributes, geometry types and vertex indices
+// stored at the offsets 'attr', 'geom' and 'vert' of 'buf'; the vertex indices
+// end before the offset 'vert_end'. The arrays must lie within the first 'size'
+// bytes of 'buf' and the vertex indices must be less than 'num_vert'.
+static void ReadBinaryElements(Mesh &mesh, const char *buf, long long size,
+                               long long attr, long long geom, long long vert,
+                               long long vert_end, int num, int num_vert,
+                               Array<Element *> &elems)
+{
+   MFEM_VERIFY(attr + 4LL*num <= size && geom + 4LL*num <= size &&
+               vert <= vert_end && vert_end <= size,
+               "invalid binary mesh data");
+   const long long vert_size = (vert_end - vert)/4;
+
+   Array<int> tmp_attr, tmp_geom, tmp_vert;
+   const int *a = GetBinaryInts(buf + attr, num, tmp_attr);
+   const int *g = GetBinaryInts(buf + geom, num, tmp_geom);
+   const int *v = GetBinaryInts(buf + vert, vert_size, tmp_vert);
+
+   elems.SetSize(num);
+   long long k = 0;
+   for (int i = 0; i < num; i++)
+   {
+      elems[i] = mesh.NewElement(g[i]);
+      MFEM_VERIFY(elems[i], "invalid geometry type " << g[i]);
+      const int nv = elems[i]->GetNVertices();
+      MFEM_VERIFY(k + nv <= vert_size, "invalid binary mesh data");
+      for (int j = 0; j < nv; j++)
+      {
+         MFEM_VERIFY(v[k+j] >= 0 && v[k+j] < num_vert,
+                     "invalid vertex index " << v[k+j] << " in binary mesh");
+      }
+      elems[i]->SetVertices(v + k);
+      elems[i]->SetAttribute(a[i]);
+      k += nv;
+   }
+}
+
+void Mesh::LoadBinary(char *buf, long long size, bool copy)
+{
+   const long long header_size = 32 + 8*MB_NUM_FIELDS;
+   MFEM_VERIFY(size >= header_size &&
+               !strncmp(buf, mesh_binary_ident, sizeof(mesh_binary_ident) - 1),
+               "input is not a binary mesh");
+   long long h[MB_NUM_FIELDS];
+   bin_io::ReadLittleEndian(buf + 32, h, MB_NUM_FIELDS);
+   MFEM_VERIFY(h[MB_FILE_SIZE] <= size, "the binary mesh is truncated");
+   for (int i = MB_ELEM_ATTR_OFFSET; i <= MB_NODES_OFFSET; i++)
+   {
+      MFEM_VERIFY(h[i] >= 0 && h[i] <= h[MB_FILE_SIZE] && h[i] % 8 == 0,
+                  "invalid binary mesh header");
+   }
+   for (int i = MB_NUM_VERTICES; i <= MB_NUM_BDR_ELEMENTS; i++)
+   {
+      MFEM_VERIFY(h[i] >= 0 && h[i] <= numeric_limits<int>::max(),
+                  "invalid binary mesh header");
+   }
+   MFEM_VERIFY(h[MB_DIMENSION] >= 0 && h[MB_DIMENSION] <= 3 &&
+               h[MB_SPACE_DIMENSION] >= 0 && h[MB_SPACE_DIMENSION] <= 3,
+               "invalid binary mesh header");
+
+   Dim = h[MB_DIMENSION];
+   spaceDim = h[MB_SPACE_DIMENSION];
+   NumOfVertices = h[MB_NUM_VERTICES];
+   NumOfElements = h[MB_NUM_ELEMENTS];
+   NumOfBdrElements = h[MB_NUM_BDR_ELEMENTS];
+
+   // the sections are stored in the order of their header fields, so each
+   // vertex index array ends where the next section begins
+   const long long bdr_vert_end =
+      h[MB_VERTICES_OFFSET] ? h[MB_VERTICES_OFFSET] :
+      h[MB_NODES_OFFSET] ? h[MB_NODES_OFFSET] : h[MB_FILE_SIZE];
+   ReadBinaryElements(*this, buf, h[MB_FILE_SIZE], h[MB_ELEM_ATTR_OFFSET],
+                      h[MB_ELEM_GEOM_OFFSET], h[MB_ELEM_VERT_OFFSET],
+                      h[MB_BDR_ATTR_OFFSET], NumOfElements, NumOfVertices,
+                      elements);
+   ReadBinaryElements(*this, buf, h[MB_FILE_SIZE], h[MB_BDR_ATTR_OFFSET],
+                      h[MB_BDR_GEOM_OFFSET], h[MB_BDR_VERT_OFFSET],
+                      bdr_vert_end, NumOfBdrElements, NumOfVertices, boundary);
+
+   vertices.SetSize(NumOfVertices);
+   if (h[MB_VERTICES_OFFSET])
+   {
+      MFEM_VERIFY(h[MB_VERTICES_OFFSET] + 8LL*NumOfVertices*spaceDim <=
+                  h[MB_FILE_SIZE], "the binary mesh is truncated");
+      const char *coord = buf + h[MB_VERTICES_OFFSET];
+      for (int j = 0; j < NumOfVertices; j++)
+      {
+         bin_io::ReadLittleEndian(coord + 8*j*spaceDim, vertices[j](),
+                                  spaceDim);
+      }
+   }
+
+   // same as in Loader()
+   FinalizeTopology();
+
+   if (h[MB_NODES_OFFSET])
+   {
+      Nodes = new GridFunction(this, buf + h[MB_NODES_OFFSET],
+                               h[MB_FILE_SIZE] - h[MB_NODES_OFFSET], copy);
+      own_nodes = 1;
+      spaceDim = Nodes->VectorDim();
+      // Set the 'vertices' from the 'Nodes'
+      for (int i = 0; i < spaceDim; i++)
+      {
+         Vector vert_val;
+         Nodes->GetNodalValues(vert_val, i+1);
+         for (int j = 0; j < NumOfVertices; j++)
+         {
+            vertices[j](i) = vert_val(j);
+         }
+      }
+   }
+}
+
 Mesh::Mesh(Mesh *mesh_array[], int num_pieces)
 {
    int      i, j, ie, ib, iv, *v, nv;
@@ -5306,6 +5643,7 @@ void Mesh::CheckDisplacements(const Vector &displacements, double &tmax)
 
 void Mesh::MoveVertices(const Vector &displacements)
 {
+   DeleteGeometricCaches();
    for (int i = 0, nv = vertices.Size(); i < nv; i++)
       for (int j = 0; j < spaceDim; j++)
       {
@@ -5326,6 +5664,7 @@ void Mesh::GetVertices(Vector &vert_coord) const
 
 void Mesh::SetVertices(const Vector &vert_coord)
 {
+   DeleteGeometricCaches();
    for (int i = 0, nv = vertices.Size(); i < nv; i++)
       for (int j = 0; j < spaceDim; j++)
       {
@@ -5354,6 +5693,7 @@ void Mesh::GetNode(int i, double *coord)
 
 void Mesh::SetNode(int i, const double *coord)
 {
+   DeleteGeometricCaches();
    if (Nodes)
    {
       FiniteElementSpace *fes = Nodes->FESpace();
@@ -5374,6 +5714,7 @@ void Mesh::SetNode(int i, const double *coord)
 
 void Mesh::MoveNodes(const Vector &displacements)
 {
+   DeleteGeometricCaches();
    if (Nodes)
    {
       (*Nodes) += displacements;
@@ -5398,6 +5739,7 @@ void Mesh::GetNodes(Vector &node_coord) const
 
 void Mesh::SetNodes(const Vector &node_coord)
 {
+   DeleteGeometricCaches();
    if (Nodes)
    {
       (*Nodes) = node_coord;
@@ -5410,6 +5752,7 @@ void Mesh::SetNodes(const Vector &node_coord)
 
 void Mesh::NewNodes(GridFunction &nodes, bool make_owner)
 {
+   DeleteGeometricCaches();
    if (own_nodes) { delete Nodes; }
    Nodes = &nodes;
    spaceDim = Nodes->FESpace()->GetVDim();
@@ -5424,6 +5767,7 @@ void Mesh::NewNodes(GridFunction &nodes, bool make_owner)
 
 void Mesh::SwapNodes(GridFunction *&nodes, int &own_nodes_)
 {
+   DeleteGeometricCaches();
    mfem::Swap<GridFunction*>(Nodes, nodes);
    mfem::Swap<int>(own_nodes, own_nodes_);
    // TODO:
@@ -6195,6 +6539,9 @@ Mesh::Mesh(const NCMesh &ncmesh)
 
 void Mesh::Swap(Mesh& other, bool non_geometry)
 {
+   DeleteGeometricCaches();
+   other.DeleteGeometricCaches();
+
    mfem::Swap(Dim, other.Dim);
    mfem::Swap(spaceDim, other.spaceDim);
 
@@ -7117,6 +7464,99 @@ void Mesh::Printer(std::ostream &out, std::string section_delimiter) const
    }
 }
 
+// Write the 'n' values in 'data' at the given offset of a binary block, after
+// padding the output from the current position 'pos'.
+template <typename T>
+static void WriteBinarySection(std::ostream &out, long long &pos,
+                               long long offset, const T *data, long long n)
+{
+   bin_io::WritePadding(out, offset - pos);
+   bin_io::WriteLittleEndian(out, data, n);
+   pos = offset + n*sizeof(T);
+}
+
+// Write the attributes, geometry types and vertex indices of 'elems' to the
+// sections at the offsets h[attr_field], h[attr_field+1], h[attr_field+2].
+static void WriteBinaryElements(std::ostream &out, long long &pos,
+                                const long long *h, int attr_field,
+                                const Array<Element *> &elems)
+{
+   const int num = elems.Size();
+   Array<int> data(num);
+   for (int i = 0; i < num; i++) { data[i] = elems[i]->GetAttribute(); }
+   WriteBinarySection(out, pos, h[attr_field], data.GetData(), num);
+   for (int i = 0; i < num; i++) { data[i] = elems[i]->GetGeometryType(); }
+   WriteBinarySection(out, pos, h[attr_field+1], data.GetData(), num);
+   data.SetSize(0);
+   for (int i = 0; i < num; i++)
+   {
+      const int *v = elems[i]->GetVertices();
+      for (int j = 0; j < elems[i]->GetNVertices(); j++) { data.Append(v[j]); }
+   }
+   WriteBinarySection(out, pos, h[attr_field+2], data.GetData(), data.Size());
+}
+
+void Mesh::PrintBinary(std::ostream &out) const
+{
+   MFEM_VERIFY(!NURBSext && !ncmesh, "the binary mesh format does not support"
+               " NURBS and nonconforming meshes");
+
+   long long num_elem_vert = 0, num_bdr_vert = 0;
+   for (int i = 0; i < NumOfElements; i++)
+   {
+      num_elem_vert += elements[i]->GetNVertices();
+   }
+   for (int i = 0; i < NumOfBdrElements; i++)
+   {
+      num_bdr_vert += boundary[i]->GetNVertices();
+   }
+
+   long long h[MB_NUM_FIELDS];
+   h[MB_DIMENSION] = Dim;
+   h[MB_SPACE_DIMENSION] = spaceDim;
+   h[MB_NUM_VERTICES] = NumOfVertices;
+   h[MB_NUM_ELEMENTS] = NumOfElements;
+   h[MB_NUM_BDR_ELEMENTS] = NumOfBdrElements;
+   long long offset = 32 + 8*MB_NUM_FIELDS;
+   h[MB_ELEM_ATTR_OFFSET] = offset;
+   offset = bin_io::Align(offset + 4LL*NumOfElements);
+   h[MB_ELEM_GEOM_OFFSET] = offset;
+   offset = bin_io::Align(offset + 4LL*NumOfElements);
+   h[MB_ELEM_VERT_OFFSET] = offset;
+   offset = bin_io::Align(offset + 4*num_elem_vert);
+   h[MB_BDR_ATTR_OFFSET] = offset;
+   offset = bin_io::Align(offset + 4LL*NumOfBdrElements);
+   h[MB_BDR_GEOM_OFFSET] = offset;
+   offset = bin_io::Align(offset + 4LL*NumOfBdrElements);
+   h[MB_BDR_VERT_OFFSET] = offset;
+   offset = bin_io::Align(offset + 4*num_bdr_vert);
+   h[MB_VERTICES_OFFSET] = Nodes ? 0 : offset;
+   h[MB_NODES_OFFSET] = Nodes ? offset : 0;
+   offset += Nodes ? Nodes->BinarySize() : 8LL*NumOfVertices*spaceDim;
+   h[MB_FILE_SIZE] = offset;
+   h[MB_RESERVED_1] = h[MB_RESERVED_2] = 0;
+
+   bin_io::WriteIdent(out, mesh_binary_ident);
+   bin_io::WriteLittleEndian(out, h, MB_NUM_FIELDS);
+   long long pos = 32 + 8*MB_NUM_FIELDS;
+   WriteBinaryElements(out, pos, h, MB_ELEM_ATTR_OFFSET, elements);
+   WriteBinaryElements(out, pos, h, MB_BDR_ATTR_OFFSET, boundary);
+   if (Nodes)
+   {
+      bin_io::WritePadding(out, h[MB_NODES_OFFSET] - pos);
+      Nodes->SaveBinary(out);
+   }
+   else
+   {
+      bin_io::WritePadding(out, h[MB_VERTICES_OFFSET] - pos);
+      for (int i = 0; i < NumOfVertices; i++)
+      {
+         bin_io::WriteLittleEndian(out, vertices[i](), spaceDim);
+      }
+   }
+   out.flush();
+}
+
 void Mesh::PrintTopo(std::ostream &out,const Array<int> &e_to_k) const
 {
    int i;
@@ -8114,6 +8554,8 @@ void Mesh::PrintSurfaces(const Table & Aface_face, std::ostream &out) const
 
 void Mesh::ScaleSubdomains(double sf)
 {
+   DeleteGeometricCaches();
+
    int i,j,k;
    Array<int> vert;
    DenseMatrix pointmat;
@@ -8184,6 +8626,8 @@ void Mesh::ScaleSubdomains(double sf)
 
 void Mesh::ScaleElements(double sf)
 {
+   DeleteGeometricCaches();
+
    int i,j,k;
    Array<int> vert;
    DenseMatrix pointmat;
@@ -8254,6 +8698,7 @@ void Mesh::ScaleElements(double sf)
 
 void Mesh::Transform(void (*f)(const Vector&, Vector&))
 {
+   DeleteGeometricCaches();
    // TODO: support for different new spaceDim.
    if (Nodes == NULL)
    {
@@ -8279,6 +8724,7 @@ void Mesh::Transform(void (*f)(const Vector&, Vector&))
 
 void Mesh::Transform(VectorCoefficient &deformation)
 {
+   DeleteGeometricCaches();
    MFEM_VERIFY(spaceDim == deformation.GetVDim(),
                "incompatible vector dimensions");
    if (Nodes == NULL)
@@ -8706,4 +9152,143 @@ Mesh *Extrude1D(Mesh *mesh, const int ny, const double sy, const bool closed)
    return mesh2d;
 }
 
+const GeometricFactors *Mesh::GetGeometricFactors(const IntegrationRule &ir,
+                                                  const int flags)
+{
+   // the factors computed before a refinement are no longer valid
+   if (geom_factors.Size() > 0 && geom_factors[0]->sequence != sequence)
+   {
+      DeleteGeometricCaches();
+   }
+   for (int i = 0; i < geom_factors.Size(); i++)
+   {
+      GeometricFactors *gf = geom_factors[i];
+      if (gf->SameRule(ir))
+      {
+         // add the missing factors, keeping the ones already computed
+         gf->Compute(flags);
+         return gf;
+      }
+   }
+   GeometricFactors *gf = new GeometricFactors(this, ir, flags);
+   geom_factors.Append(gf);
+   return gf;
+}
+
+int Mesh::FindPoints(const DenseMatrix &point_mat, Array<int> &elem_ids,
+                     Array<IntegrationPoint> &ips, bool warn)
+{
+   // the index built before a refinement is no longer valid
+   if (point_locator && point_locator->GetSequence() != sequence)
+   {
+      delete point_locator;
+      point_locator = NULL;
+   }
+   if (!point_locator) { point_locator = new PointLocator(this); }
+
+   const int found = point_locator->FindPoints(point_mat, elem_ids, ips);
+   if (warn && found < point_mat.Width())
+   {
+      MFEM_WARNING((point_mat.Width() - found) << " of " << point_mat.Width()
+                   << " points were not found in the mesh");
+   }
+   return found;
+}
+
+GeometricFactors::GeometricFactors(Mesh *mesh, const IntegrationRule &ir,
+                                   int flags)
+   : mesh(mesh), computed_factors(0), sequence(mesh->GetSequence())
+{
+   ir.Copy(IntRule);
+   Compute(flags);
+}
+
+bool GeometricFactors::SameRule(const IntegrationRule &ir) const
+{
+   if (ir.GetNPoints() != IntRule.GetNPoints()) { return false; }
+   for (int q = 0; q < ir.GetNPoints(); q++)
+   {
+      const IntegrationPoint &ip = ir.IntPoint(q), &jp = IntRule.IntPoint(q);
+      if (ip.x != jp.x || ip.y != jp.y || ip.z != jp.z ||
+          ip.weight != jp.weight) { return false; }
+   }
+   return true;
+}
+
+void GeometricFactors::Compute(int flags)
+{
+   flags &= ~computed_factors;
+   if (flags == 0) { return; }
+   computed_factors |= flags;
+
+   const IntegrationRule &ir = IntRule;
+   const int NE = mesh->GetNE();
+   const int NQ = ir.GetNPoints();
+   const int dim = mesh->Dimension();
+   const int sdim = mesh->SpaceDimension();
+
+   if (flags & COORDINATES) { X.SetSize(NQ*sdim*NE); }
+   if (flags & JACOBIANS) { J.SetSize(NQ*sdim*dim*NE); }
+   if (flags & DETERMINANTS) { detJ.SetSize(NQ*NE); }
+   if (flags & ADJUGATES) { adjJ.SetSize(NQ*dim*sdim*NE); }
+
+   // the transformations of NURBS meshes use a shared NURBSFiniteElement
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel if (mesh->NURBSext == NULL)
+#endif
+   {
+      IsoparametricTransformation T;
+      Vector x(sdim);
+#ifdef MFEM_USE_OPENMP
+      #pragma omp for
+#endif
+      for (int e = 0; e < NE; e++)
+      {
+         MFEM_ASSERT(mesh->GetElementBaseGeometry(e) ==
+                     mesh->GetElementBaseGeometry(0),
+                     "all elements must have the same geometry");
+         mesh->GetElementTransformation(e, &T);
+         for (int q = 0; q < NQ; q++)
+         {
+            const IntegrationPoint &ip = ir.IntPoint(q);
+            T.SetIntPoint(&ip);
+            if (flags & COORDINATES)
+            {
+               T.Transform(ip, x);
+               for (int i = 0; i < sdim; i++)
+               {
+                  X(q + NQ*(i + sdim*e)) = x(i);
+               }
+            }
+            if (flags & JACOBIANS)
+            {
+               const DenseMatrix &Jq = T.Jacobian();
+               for (int j = 0; j < dim; j++)
+               {
+                  for (int i = 0; i < sdim; i++)
+                  {
+                     J(q + NQ*(i + sdim*(j + dim*e))) = Jq(i,j);
+                  }
+               }
+            }
+            if (flags & DETERMINANTS)
+            {
+               detJ(q + NQ*e) = T.Weight();
+            }
+            if (flags & ADJUGATES)
+            {
+               const DenseMatrix &adj = T.AdjugateJacobian();
+               for (int j = 0; j < sdim; j++)
+               {
+                  for (int i = 0; i < dim; i++)
+                  {
+                     adjJ(q + NQ*(i + dim*(j + sdim*e))) = adj(i,j);
+                  }
+               }
+            }
+         }
+      }
+   }
+}
+
 }
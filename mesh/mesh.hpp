@@ -21,6 +21,7 @@
 #include "../fem/eltrans.hpp"
 #include "../fem/coefficient.hpp"
 #include "../general/gzstream.hpp"
+#include "../general/binaryio.hpp"
 #include <iostream>
 #include <fstream>
 
@@ -33,6 +34,8 @@ class KnotVector;
 class NURBSExtension;
 class FiniteElementSpace;
 class GridFunction;
+class GeometricFactors;
+class PointLocator;
 struct Refinement;
 
 #ifdef MFEM_USE_MPI
@@ -149,6 +152,11 @@ protected:
    GridFunction *Nodes;
    int own_nodes;
 
+   // Cached geometric factors, see GetGeometricFactors().
+   Array<GeometricFactors*> geom_factors;
+   // Cached spatial index, see FindPoints().
+   PointLocator *point_locator;
+
    static const int vtk_quadratic_tet[10];
    static const int vtk_quadratic_hex[27];
 
@@ -184,6 +192,12 @@ protected:
    void DeleteTables() { DestroyTables(); InitTables(); }
    void DestroyPointers(); // Delete data specifically allocated by class Mesh.
    void Destroy();         // Delete all owned data.
+   // Delete the cached geometric factors and the point locator.
+   void DeleteGeometricCaches();
+
+   // Compute the ordering of the elements along a Hilbert (if 'hilbert' is
+   // true) or Morton space-filling curve through the element centers.
+   void GetSFCElementOrdering(Array<int> &ordering, bool hilbert);
 
    Element *ReadElementWithoutAttr(std::istream &);
    static void PrintElementWithoutAttr(const Element *, std::ostream &);
@@ -372,6 +386,11 @@ protected:
    void Loader(std::istream &input, int generate_edges = 0,
                std::string parse_tag = "");
 
+   // Load a mesh in the binary format, see PrintBinary(), from the block of
+   // 'size' bytes at 'buf'. If 'copy' is false, the Nodes use the data in
+   // the block. Like Loader(), this does not call Finalize().
+   void LoadBinary(char *buf, long long size, bool copy);
+
    // If NURBS mesh, write NURBS format. If NCMesh, write mfem v1.1 format.
    // If section_delimiter is empty, write mfem v1.0 format. Otherwise, write
    // mfem v1.2 format with the given section_delimiter at the end.
@@ -523,9 +542,28 @@ public:
    void GetGeckoElementReordering(Array<int> &ordering);
 #endif
 
+   /** @brief Compute an element ordering that increases memory coherency by
+       following a Hilbert space-filling curve through the element centers.
+
+       Unlike GetGeckoElementReordering(), this method does not require an
+       external library. The resulting @a ordering maps the old element numbers
+       to the new ones and is meant to be passed to ReorderElements(), which
+       also renumbers the vertices, edges and faces, and therefore the DOFs of
+       the finite element spaces on the mesh, following the new element
+       order. */
+   void GetHilbertElementOrdering(Array<int> &ordering);
+
+   /** @brief Same as GetHilbertElementOrdering(), using the Morton (Z-order)
+       curve, which is cheaper to compute but has jumps between distant
+       elements. */
+   void GetMortonElementOrdering(Array<int> &ordering);
+
    /** Rebuilds the mesh with a different order of elements.  The ordering
        vector maps the old element number to the new element number.  This also
-       reorders the vertices and nodes edges and faces along with the elements.  */
+       reorders the vertices and nodes edges and faces along with the elements.
+       The sequence of the mesh is increased: the finite element spaces defined
+       on the mesh must be updated, which rebuilds their DOFs in the new order;
+       the values of their grid functions are not transferred. */
    void ReorderElements(const Array<int> &ordering, bool reorder_vertices = true);
 
    /** Creates mesh for the parallelepiped [0,sx]x[0,sy]x[0,sz], divided into
@@ -566,6 +604,14 @@ public:
    Mesh(std::istream &input, int generate_edges = 0, int refine = 1,
         bool fix_orientation = true);
 
+   /** @brief Creates mesh from a file in the binary MFEM format, see
+       PrintBinary(), mapped into memory.
+
+       The mesh Nodes, if any, use the data of the file without copying it, so
+       the MappedFile must not be destroyed before the Mesh. */
+   explicit Mesh(MappedFile &file, int generate_edges = 0, int refine = 1,
+                 bool fix_orientation = true);
+
    /// Create a disjoint mesh from the given mesh array
    Mesh(Mesh *mesh_array[], int num_pieces);
 
@@ -821,6 +867,17 @@ public:
    FaceElementTransformations *GetFaceElementTransformations(int FaceNo,
                                                              int mask = 31);
 
+   /** @brief Thread-safe version of GetFaceElementTransformations(): the
+       transformations are set up in the given objects @a FElTr, @a ElTr1,
+       @a ElTr2 (the transformations of the two elements) and @a FTr (the face
+       transformation) instead of the internal ones of the Mesh. */
+   void GetFaceElementTransformations(int FaceNo,
+                                      FaceElementTransformations &FElTr,
+                                      IsoparametricTransformation &ElTr1,
+                                      IsoparametricTransformation &ElTr2,
+                                      IsoparametricTransformation &FTr,
+                                      int mask = 31);
+
    FaceElementTransformations *GetInteriorFaceTransformations (int FaceNo)
    {
       if (faces_info[FaceNo].Elem2No < 0) { return NULL; }
@@ -829,6 +886,14 @@ public:
 
    FaceElementTransformations *GetBdrFaceTransformations (int BdrElemNo);
 
+   /** @brief Thread-safe version of GetBdrFaceTransformations(), see also the
+       thread-safe version of GetFaceElementTransformations(). Returns false if
+       the boundary element is not on a true boundary face. */
+   bool GetBdrFaceTransformations(int BdrElemNo,
+                                  FaceElementTransformations &FElTr,
+                                  IsoparametricTransformation &ElTr1,
+                                  IsoparametricTransformation &FTr);
+
    /// Return true if the given face is interior. @sa FaceIsTrueInterior().
    bool FaceIsInterior(int FaceNo) const
    {
@@ -1013,6 +1078,47 @@ public:
        Update() calls. */
    long GetSequence() const { return sequence; }
 
+   /** @brief Return the geometric factors of all elements at the points of
+       the integration rule @a ir.
+
+       The parameter @a flags is a bitwise-or of GeometricFactors::FactorFlags
+       selecting the factors to compute. The factors are cached and reused by
+       subsequent calls with a rule with the same points and weights as
+       @a ir; factors missing from a cached object are added to it. The
+       returned object remains valid until the mesh is refined, its nodes are
+       modified through the methods of the Mesh, or DeleteGeometricFactors() is
+       called. If the nodes or the vertices are modified directly,
+       NodesUpdated() must be called.
+
+       All elements must have the same geometry, the one of @a ir. */
+   const GeometricFactors *GetGeometricFactors(const IntegrationRule &ir,
+                                               const int flags);
+
+   /** @brief Notify the mesh that its nodes or vertices were modified
+       directly; this invalidates the cached geometric factors and the spatial
+       index of FindPoints(). */
+   void NodesUpdated() { DeleteGeometricCaches(); }
+
+   /** @brief Free the memory of the geometric factors cached by
+       GetGeometricFactors(); the pointers it returned become invalid. */
+   void DeleteGeometricFactors();
+
+   /** @brief Find the elements containing the points given as the columns of
+       @a point_mat, a SpaceDimension() x npts matrix.
+
+       On return, @a elem_ids[j] is the index of an element containing the
+       j-th point and @a ips[j] are the reference coordinates of the point in
+       that element; for the points that are not in the mesh, @a elem_ids[j]
+       is -1. For surface meshes, only the points on the surface are found.
+       Returns the number of points found; if @a warn is true, a warning is
+       printed when some points are not found.
+
+       The first call builds a spatial index of the elements which is reused
+       by subsequent calls, until the mesh is refined or its nodes are
+       modified, see NodesUpdated(). */
+   int FindPoints(const DenseMatrix &point_mat, Array<int> &elem_ids,
+                  Array<IntegrationPoint> &ips, bool warn = true);
+
    /// Print the mesh to the given stream using Netgen/Truegrid format.
    virtual void PrintXG(std::ostream &out = std::cout) const;
 
@@ -1020,6 +1126,16 @@ public:
    /// \see mfem::ogzstream() for on-the-fly compression of ascii outputs
    virtual void Print(std::ostream &out = std::cout) const { Printer(out); }
 
+   /** @brief Print the mesh in the binary format "MFEM binary mesh v1.0".
+
+       The format stores the elements, the boundary elements and the vertices
+       (or the Nodes, in the binary GridFunction format) as little-endian arrays
+       at 8-byte aligned offsets given in a fixed-size header. Binary meshes can
+       be read with the Mesh constructors and Load(), or mapped into memory
+       with Mesh(MappedFile&). Nonconforming and NURBS meshes are not
+       supported. */
+   void PrintBinary(std::ostream &out) const;
+
    /// Print the mesh in VTK format (linear and quadratic meshes only).
    /// \see mfem::ogzstream() for on-the-fly compression of ascii outputs
    void PrintVTK(std::ostream &out);
@@ -1072,6 +1188,9 @@ public:
 
    double GetElementVolume(int i);
 
+   /// Returns the physical location of the center of the i-th element.
+   void GetElementCenter(int i, Vector &center);
+
    /// Returns the minimum and maximum corners of the mesh bounding box. For
    /// high-order meshes, the geometry is refined first "ref" times.
    void GetBoundingBox(Vector &min, Vector &max, int ref = 2);
@@ -1094,6 +1213,49 @@ public:
    virtual ~Mesh() { DestroyPointers(); }
 };
 
+/** @brief Geometric factors of the elements of a Mesh at the points of an
+    IntegrationRule: coordinates, Jacobians, Jacobian determinants and
+    adjugates of the Jacobians.
+
+    The factors are stored in contiguous arrays, with the quadrature point
+    index running fastest, so that kernels can read them for all points of an
+    element with unit stride. Objects of this class are usually constructed
+    and owned by Mesh::GetGeometricFactors(). */
+class GeometricFactors
+{
+public:
+   enum FactorFlags
+   {
+      COORDINATES  = 1 << 0,
+      JACOBIANS    = 1 << 1,
+      DETERMINANTS = 1 << 2,
+      ADJUGATES    = 1 << 3
+   };
+
+   Mesh *mesh;
+   IntegrationRule IntRule; ///< Copy of the rule, identifies cached factors
+   int computed_factors; ///< Bitwise-or of FactorFlags
+   long sequence;        ///< Mesh sequence when the factors were computed
+
+   /// Physical coordinates of the points, NQ x SDIM x NE.
+   Vector X;
+   /// Jacobians of the element transformations, NQ x SDIM x DIM x NE.
+   Vector J;
+   /** @brief Jacobian determinants, NQ x NE. When SDIM > DIM, these are the
+       values of ElementTransformation::Weight(). */
+   Vector detJ;
+   /// Adjugates of the Jacobians, NQ x DIM x SDIM x NE.
+   Vector adjJ;
+
+   GeometricFactors(Mesh *mesh, const IntegrationRule &ir, int flags);
+
+   /// Compute the factors selected by @a flags that are not yet computed.
+   void Compute(int flags);
+
+   /// Return true if @a ir has the same points and weights as #IntRule.
+   bool SameRule(const IntegrationRule &ir) const;
+};
+
 /** Overload operator<< for std::ostream and Mesh; valid also for the derived
     class ParMesh */
 std::ostream &operator<<(std::ostream &out, const Mesh &mesh);
@@ -26,6 +26,7 @@
 #include "mesh.hpp"
 #include "mesh_operators.hpp"
 #include "nurbs.hpp"
+#include "point_locator.hpp"
 
 #ifdef MFEM_USE_MESQUITE
 #include "mesquite.hpp"
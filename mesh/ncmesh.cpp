@@ -1076,10 +1076,28 @@ void NCMesh::Refine(const Array<Refinement>& refinements)
 {
    // push all refinements on the stack in reverse order
    ref_stack.Reserve(refinements.Size());
+   int new_leaves = 0;
    for (int i = refinements.Size()-1; i >= 0; i--)
    {
       const Refinement& ref = refinements[i];
       ref_stack.Append(Refinement(leaf_elements[ref.index], ref.ref_type));
+
+      int nch = 1;
+      for (int bit = 1; bit < (1 << Dim); bit <<= 1)
+      {
+         if (ref.ref_type & bit) { nch *= 2; }
+      }
+      new_leaves += nch - 1;
+   }
+
+   // pre-size the hash tables, assuming the new leaves bring the same number
+   // of nodes and faces per leaf as the current mesh (forced refinements are
+   // not included, the tables still grow if needed)
+   if (leaf_elements.Size())
+   {
+      double growth = 1.0 + double(new_leaves) / leaf_elements.Size();
+      nodes.Reserve(int(growth * nodes.Size()));
+      faces.Reserve(int(growth * faces.Size()));
    }
 
    // keep refining as long as the stack contains something
@@ -2712,6 +2712,16 @@ bool ParMesh::NonconformingDerefinement(Array<double> &elem_error,
 }
 
 void ParMesh::Rebalance()
+{
+   RebalanceImpl(NULL);
+}
+
+void ParMesh::Rebalance(const Vector &elem_weights)
+{
+   RebalanceImpl(&elem_weights);
+}
+
+void ParMesh::RebalanceImpl(const Vector *elem_weights)
 {
    if (Conforming())
    {
@@ -2721,7 +2731,7 @@ void ParMesh::Rebalance()
 
    DeleteFaceNbrData();
 
-   pncmesh->Rebalance();
+   pncmesh->Rebalance(elem_weights);
 
    ParMesh* pmesh2 = new ParMesh(*pncmesh);
    pncmesh->OnMeshUpdated(pmesh2);
@@ -87,6 +87,9 @@ protected:
 
    bool WantSkipSharedMaster(const NCMesh::Master &master) const;
 
+   /// Rebalance() with optional element weights.
+   void RebalanceImpl(const Vector *elem_weights);
+
 public:
    /** Copy constructor. Performs a deep copy of (almost) all data, so that the
        source mesh can be modified (e.g. deleted, refined) without affecting the
@@ -183,6 +186,11 @@ public:
    /// Load balance the mesh. NC meshes only.
    void Rebalance();
 
+   /** Load balance the mesh so that each processor owns approximately the same
+       total weight, given in @a elem_weights for each local element (see
+       ParNCMesh::Rebalance). NC meshes only. */
+   void Rebalance(const Vector &elem_weights);
+
    /** Print the part of the mesh in the calling processor adding the interface
        as boundary (for visualization purposes) using the mfem v1.0 format. */
    virtual void Print(std::ostream &out = std::cout) const;
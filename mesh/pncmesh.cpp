@@ -1343,7 +1343,7 @@ void ParNCMesh::CheckDerefinementNCLevel(const Table &deref_table,
 
 //// Rebalance /////////////////////////////////////////////////////////////////
 
-void ParNCMesh::Rebalance()
+void ParNCMesh::Rebalance(const Vector *elem_weights)
 {
    send_rebalance_dofs.clear();
    recv_rebalance_dofs.clear();
@@ -1352,26 +1352,31 @@ void ParNCMesh::Rebalance()
    leaf_elements.GetSubArray(0, NElements, old_elements);
 
    // figure out new assignments for Element::rank
-   long local_elems = NElements, total_elems = 0;
-   MPI_Allreduce(&local_elems, &total_elems, 1, MPI_LONG, MPI_SUM, MyComm);
-
-   long first_elem_global = 0;
-   MPI_Scan(&local_elems, &first_elem_global, 1, MPI_LONG, MPI_SUM, MyComm);
-   first_elem_global -= local_elems;
-
    Array<int> new_ranks(leaf_elements.Size());
    new_ranks = -1;
 
-   for (int i = 0, j = 0; i < leaf_elements.Size(); i++)
+   int target_elements;
+   if (!elem_weights || !WeightedPartition(*elem_weights, new_ranks,
+                                           target_elements))
    {
-      if (elements[leaf_elements[i]].rank == MyRank)
+      long local_elems = NElements, total_elems = 0;
+      MPI_Allreduce(&local_elems, &total_elems, 1, MPI_LONG, MPI_SUM, MyComm);
+
+      long first_elem_global = 0;
+      MPI_Scan(&local_elems, &first_elem_global, 1, MPI_LONG, MPI_SUM, MyComm);
+      first_elem_global -= local_elems;
+
+      for (int i = 0, j = 0; i < leaf_elements.Size(); i++)
       {
-         new_ranks[i] = Partition(first_elem_global + (j++), total_elems);
+         if (elements[leaf_elements[i]].rank == MyRank)
+         {
+            new_ranks[i] = Partition(first_elem_global + (j++), total_elems);
+         }
       }
-   }
 
-   int target_elements = PartitionFirstIndex(MyRank+1, total_elems)
-                         - PartitionFirstIndex(MyRank, total_elems);
+      target_elements = PartitionFirstIndex(MyRank+1, total_elems)
+                        - PartitionFirstIndex(MyRank, total_elems);
+   }
 
    // assign the new ranks and send elements (plus ghosts) to new owners
    RedistributeElements(new_ranks, target_elements, true);
@@ -1389,6 +1394,83 @@ void ParNCMesh::Rebalance()
    Prune();
 }
 
+bool ParNCMesh::WeightedPartition(const Vector &elem_weights,
+                                  Array<int> &new_ranks, int &target_elements)
+{
+   MFEM_VERIFY(elem_weights.Size() == NElements,
+               "invalid number of element weights");
+
+   double local_weight = 0.0, total_weight = 0.0;
+   for (int i = 0; i < NElements; i++)
+   {
+      MFEM_VERIFY(elem_weights(i) >= 0.0, "negative element weight");
+      local_weight += elem_weights(i);
+   }
+   MPI_Allreduce(&local_weight, &total_weight, 1, MPI_DOUBLE, MPI_SUM, MyComm);
+   if (total_weight <= 0.0) { return false; }
+
+   double first_weight = 0.0;
+   MPI_Scan(&local_weight, &first_weight, 1, MPI_DOUBLE, MPI_SUM, MyComm);
+   first_weight -= local_weight;
+
+   // assign each element to the rank that contains the midpoint of its weight
+   // interval; the ranks are non-decreasing along the leaves, so the partition
+   // is given by the number of elements that fall into each rank
+   Array<int> rank_elements(NRanks);
+   rank_elements = 0;
+   double weight = first_weight;
+   for (int i = 0; i < leaf_elements.Size(); i++)
+   {
+      const Element &el = elements[leaf_elements[i]];
+      if (el.rank != MyRank) { continue; }
+
+      const double w = elem_weights(el.index);
+      int rank = int((weight + 0.5*w) * NRanks / total_weight);
+      rank = std::min(std::max(rank, 0), NRanks-1);
+      weight += w;
+      rank_elements[rank]++;
+   }
+   MPI_Allreduce(MPI_IN_PLACE, rank_elements.GetData(), NRanks, MPI_INT,
+                 MPI_SUM, MyComm);
+
+   // move the cuts so that each rank keeps at least one leaf (skewed or zero
+   // weights could otherwise leave some ranks empty)
+   long total_elems = 0;
+   Array<long> first_elem(NRanks+1);
+   first_elem[0] = 0;
+   for (int r = 0; r < NRanks; r++)
+   {
+      total_elems += rank_elements[r];
+      first_elem[r+1] = total_elems;
+   }
+   for (int r = 1; r < NRanks; r++)
+   {
+      first_elem[r] = std::max(first_elem[r], first_elem[r-1] + 1);
+   }
+   for (int r = NRanks-1; r > 0; r--)
+   {
+      first_elem[r] = std::min(first_elem[r], first_elem[r+1] - 1);
+      first_elem[r] = std::max(first_elem[r], 0L);
+   }
+
+   long local_elems = NElements, first_elem_global = 0;
+   MPI_Scan(&local_elems, &first_elem_global, 1, MPI_LONG, MPI_SUM, MyComm);
+   first_elem_global -= local_elems;
+
+   for (int i = 0, rank = 0; i < leaf_elements.Size(); i++)
+   {
+      if (elements[leaf_elements[i]].rank != MyRank) { continue; }
+
+      while (first_elem_global >= first_elem[rank+1]) { rank++; }
+      new_ranks[i] = rank;
+      first_elem_global++;
+   }
+
+   // the number of elements this rank will own
+   target_elements = first_elem[MyRank+1] - first_elem[MyRank];
+   return true;
+}
+
 struct CompareRanks
 {
    typedef BlockArray<NCMesh::Element> ElemArray;
@@ -1658,6 +1740,82 @@ void ParNCMesh::RecvRebalanceDofs(Array<int> &elements, Array<long> &dofs)
    RebalanceDofMessage::WaitAllSent(send_rebalance_dofs);
 }
 
+void ParNCMesh::SendRebalanceData(const Array<int> &old_offsets,
+                                  const Vector &old_data)
+{
+   // use the elements recorded for the DOF messages by Rebalance()
+   send_rebalance_data.clear();
+   RebalanceDofMessage::Map::iterator it;
+   for (it = send_rebalance_dofs.begin(); it != send_rebalance_dofs.end(); ++it)
+   {
+      RebalanceDataMessage &msg = send_rebalance_data.insert(
+         std::make_pair(it->first, RebalanceDataMessage(it->second)))
+         .first->second;
+
+      int size = 0, ne = msg.elem_ids.size();
+      for (int i = 0; i < ne; i++)
+      {
+         int e = msg.elem_ids[i];
+         size += old_offsets[e+1] - old_offsets[e];
+      }
+      msg.values.reserve(size);
+      for (int i = 0; i < ne; i++)
+      {
+         int e = msg.elem_ids[i];
+         msg.values.insert(msg.values.end(),
+                           old_data.GetData() + old_offsets[e],
+                           old_data.GetData() + old_offsets[e+1]);
+      }
+   }
+
+   // send the data to element recipients from last Rebalance()
+   RebalanceDataMessage::IsendAll(send_rebalance_data, MyComm);
+}
+
+
+void ParNCMesh::RecvRebalanceData(Array<int> &elements, Vector &data)
+{
+   // receive from the same ranks as in last Rebalance()
+   RebalanceDataMessage::Map recv_rebalance_data;
+   RebalanceDofMessage::Map::iterator it;
+   for (it = recv_rebalance_dofs.begin(); it != recv_rebalance_dofs.end(); ++it)
+   {
+      recv_rebalance_data[it->first].SetNCMesh(this);
+   }
+   RebalanceDataMessage::RecvAll(recv_rebalance_data, MyComm);
+
+   // count the size of the result
+   int ne = 0, nd = 0;
+   RebalanceDataMessage::Map::iterator jt;
+   for (jt = recv_rebalance_data.begin(); jt != recv_rebalance_data.end(); ++jt)
+   {
+      RebalanceDataMessage &msg = jt->second;
+      ne += msg.elem_ids.size();
+      nd += msg.values.size();
+   }
+
+   elements.SetSize(ne);
+   data.SetSize(nd);
+
+   // copy element indices and their data
+   ne = nd = 0;
+   for (jt = recv_rebalance_data.begin(); jt != recv_rebalance_data.end(); ++jt)
+   {
+      RebalanceDataMessage &msg = jt->second;
+      for (unsigned i = 0; i < msg.elem_ids.size(); i++)
+      {
+         elements[ne++] = msg.elem_ids[i];
+      }
+      for (unsigned i = 0; i < msg.values.size(); i++)
+      {
+         data(nd++) = msg.values[i];
+      }
+   }
+
+   RebalanceDataMessage::WaitAllSent(send_rebalance_data);
+   send_rebalance_data.clear();
+}
+
 
 //// ElementSet ////////////////////////////////////////////////////////////////
 
@@ -2270,6 +2428,37 @@ void ParNCMesh::RebalanceDofMessage::Decode()
    }
 }
 
+void ParNCMesh::RebalanceDataMessage::Encode()
+{
+   std::ostringstream stream;
+
+   eset.Dump(stream);
+   write<int>(stream, values.size());
+   stream.write((const char*) values.data(), values.size() * sizeof(double));
+
+   stream.str().swap(data);
+}
+
+void ParNCMesh::RebalanceDataMessage::Decode()
+{
+   std::istringstream stream(data);
+
+   eset.Load(stream);
+   values.resize(read<int>(stream));
+   stream.read((char*) values.data(), values.size() * sizeof(double));
+
+   data.clear();
+
+   Array<int> elems;
+   eset.Decode(elems);
+
+   elem_ids.resize(elems.Size());
+   for (int i = 0; i < elems.Size(); i++)
+   {
+      elem_ids[i] = eset.GetNCMesh()->elements[elems[i]].index;
+   }
+}
+
 
 //// Utility ///////////////////////////////////////////////////////////////////
 
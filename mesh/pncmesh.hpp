@@ -86,8 +86,14 @@ public:
    virtual void Derefine(const Array<int> &derefs);
 
    /** Migrate leaf elements of the global refinement hierarchy (including ghost
-       elements) so that each processor owns the same number of leaves (+-1). */
-   void Rebalance();
+       elements) so that each processor owns the same number of leaves (+-1).
+
+       If @a elem_weights is given, it contains a non-negative cost for each
+       local element (e.g., from the polynomial order or from a measured
+       assembly time) and the leaves are partitioned so that each processor
+       owns approximately the same total weight. In both cases the partition
+       follows the order of the leaves, i.e., the space-filling curve. */
+   void Rebalance(const Vector *elem_weights = NULL);
 
 
    // interface for ParFiniteElementSpace
@@ -206,6 +212,17 @@ public:
    /// Receive element DOFs sent by SendRebalanceDofs().
    void RecvRebalanceDofs(Array<int> &elements, Array<long> &dofs);
 
+   /** Use the communication pattern from last Rebalance() to send element
+       data. The data of the old element @a i are the values of @a old_data in
+       the range [@a old_offsets[i], @a old_offsets[i+1]). */
+   void SendRebalanceData(const Array<int> &old_offsets,
+                          const Vector &old_data);
+
+   /** Receive element data sent by SendRebalanceData(). Returns the (new)
+       indices of the received elements and their data, concatenated in the
+       same order. */
+   void RecvRebalanceData(Array<int> &elements, Vector &data);
+
    /** Get previous indices (pre-Rebalance) of current elements. Index of -1
        indicates that an element didn't exist in the mesh before. */
    const Array<int>& GetRebalanceOldIndex() const { return old_index_or_rank; }
@@ -444,6 +461,8 @@ protected:
       typedef std::map<int, RebalanceMessage> Map;
    };
 
+   class RebalanceDataMessage;
+
    /** Allows migrating element data (DOFs) after Rebalance().
     *  Used by SendRebalanceDofs and RecvRebalanceDofs.
     */
@@ -458,6 +477,35 @@ protected:
 
       typedef std::map<int, RebalanceDofMessage> Map;
 
+   protected:
+      ElementSet eset;
+
+      virtual void Encode();
+      virtual void Decode();
+
+      friend class RebalanceDataMessage;
+   };
+
+   /** Allows migrating arbitrary element data (e.g., the values of several
+    *  grid functions) after Rebalance(). Used by SendRebalanceData and
+    *  RecvRebalanceData.
+    */
+   class RebalanceDataMessage : public VarMessage<159>
+   {
+   public:
+      std::vector<int> elem_ids;
+      std::vector<double> values;
+
+      RebalanceDataMessage() {}
+
+      /// Create a message for the same elements as the given DOF message.
+      RebalanceDataMessage(const RebalanceDofMessage &dof_msg)
+         : elem_ids(dof_msg.elem_ids), eset(dof_msg.eset) {}
+
+      void SetNCMesh(NCMesh* ncmesh) { eset.SetNCMesh(ncmesh); }
+
+      typedef std::map<int, RebalanceDataMessage> Map;
+
    protected:
       ElementSet eset;
 
@@ -465,6 +513,14 @@ protected:
       virtual void Decode();
    };
 
+   /** Helper for Rebalance(): set 'new_ranks' of the local leaves so that
+       each rank owns approximately the same total weight, but at least one
+       leaf, and return the number of elements this rank will own in
+       'target_elements'. Returns
+       false (and does nothing) if the total weight is zero. */
+   bool WeightedPartition(const Vector &elem_weights, Array<int> &new_ranks,
+                          int &target_elements);
+
    /** Assign new Element::rank to leaf elements and send them to their new
        owners, keeping the ghost layer up to date. Used by Rebalance() and
        Derefine(). */
@@ -475,6 +531,7 @@ protected:
        Send/RecvRebalanceDofs to ship element DOFs. */
    RebalanceDofMessage::Map send_rebalance_dofs;
    RebalanceDofMessage::Map recv_rebalance_dofs;
+   RebalanceDataMessage::Map send_rebalance_data;
 
    /** After Rebalance, this array holds the old element indices, or -1 if an
        element didn't exist in the mesh previously. After Derefine, it holds
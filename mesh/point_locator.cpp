@@ -0,0 +1,364 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementation of class PointLocator
+
+#include "mesh_headers.hpp"
+#include "../fem/fem.hpp"
+#include "../general/sort_pairs.hpp"
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+namespace mfem
+{
+
+PointLocator::PointLocator(Mesh *mesh)
+   : mesh(mesh), sequence(mesh->GetSequence()), sdim(mesh->SpaceDimension())
+{
+   MFEM_VERIFY(sdim >= 1 && sdim <= 3, "invalid space dimension: " << sdim);
+   const int NE = mesh->GetNE();
+
+   ComputeElementBoxes();
+
+   // global bounding box
+   for (int d = 0; d < 3; d++)
+   {
+      bb_min[d] = (d < sdim) ? std::numeric_limits<double>::infinity() : 0.0;
+      bb_max[d] = (d < sdim) ? -std::numeric_limits<double>::infinity() : 0.0;
+   }
+   for (int e = 0; e < NE; e++)
+   {
+      const double *box = elem_boxes.GetData() + 2*sdim*e;
+      for (int d = 0; d < sdim; d++)
+      {
+         bb_min[d] = std::min(bb_min[d], box[d]);
+         bb_max[d] = std::max(bb_max[d], box[sdim+d]);
+      }
+   }
+
+   // uniform grid with about NE cells; the dimensions in which the mesh is
+   // flat (e.g. a planar surface in 3D) get a single cell
+   double max_ext = 0.0;
+   for (int d = 0; d < sdim; d++)
+   {
+      max_ext = std::max(max_ext, bb_max[d] - bb_min[d]);
+   }
+   int num_active = 0;
+   double volume = 1.0;
+   for (int d = 0; d < sdim; d++)
+   {
+      const double ext = bb_max[d] - bb_min[d];
+      if (ext > 1e-12*max_ext) { num_active++; volume *= ext; }
+   }
+   const double h = (num_active > 0) ?
+                    std::pow(volume/std::max(NE, 1), 1.0/num_active) : 0.0;
+   for (int d = 0; d < 3; d++)
+   {
+      const double ext = bb_max[d] - bb_min[d];
+      num_cells[d] = 1;
+      cell_scale[d] = 0.0;
+      if (d < sdim && ext > 1e-12*max_ext && h > 0.0)
+      {
+         num_cells[d] = (int) std::min(std::ceil(ext/h), (double) NE);
+         num_cells[d] = std::max(num_cells[d], 1);
+         cell_scale[d] = num_cells[d]/ext;
+      }
+   }
+
+   // cell -> element lists: count, prefix sum, fill
+   const int total_cells = num_cells[0]*num_cells[1]*num_cells[2];
+   cell_offsets.SetSize(total_cells + 1);
+   cell_offsets = 0;
+   for (int pass = 0; pass < 2; pass++)
+   {
+      for (int e = 0; e < NE; e++)
+      {
+         const double *box = elem_boxes.GetData() + 2*sdim*e;
+         int lo[3] = { 0, 0, 0 }, hi[3] = { 0, 0, 0 };
+         for (int d = 0; d < sdim; d++)
+         {
+            const double s = cell_scale[d];
+            const int n = num_cells[d] - 1;
+            lo[d] = std::max(0, std::min(n, (int)((box[d] - bb_min[d])*s)));
+            hi[d] = std::max(0, std::min(n, (int)((box[sdim+d] - bb_min[d])*s)));
+         }
+         for (int k = lo[2]; k <= hi[2]; k++)
+         {
+            for (int j = lo[1]; j <= hi[1]; j++)
+            {
+               for (int i = lo[0]; i <= hi[0]; i++)
+               {
+                  const int c = i + num_cells[0]*(j + num_cells[1]*k);
+                  if (pass == 0) { cell_offsets[c+1]++; }
+                  else { cell_elements[cell_offsets[c]++] = e; }
+               }
+            }
+         }
+      }
+      if (pass == 0)
+      {
+         cell_offsets.PartialSum();
+         cell_elements.SetSize(cell_offsets[total_cells]);
+      }
+      else
+      {
+         // the fill pass shifted the offsets by one cell
+         for (int c = total_cells; c > 0; c--)
+         {
+            cell_offsets[c] = cell_offsets[c-1];
+         }
+         cell_offsets[0] = 0;
+      }
+   }
+}
+
+void PointLocator::ComputeElementBoxes()
+{
+   const int NE = mesh->GetNE();
+   const int dim = mesh->Dimension();
+   GridFunction *nodes = mesh->GetNodes();
+   elem_boxes.SetSize(2*sdim*NE);
+
+   // With Nodes, the boxes are computed from the images of the points of a
+   // refined reference element, which can miss the extremal points of curved
+   // elements; the boxes are enlarged to account for that.
+   const double pad_frac = nodes ? 0.1 : 1e-12;
+   RefinedGeometry *RefG[Geometry::NumGeom];
+   for (int g = 0; g < Geometry::NumGeom; g++) { RefG[g] = NULL; }
+   if (nodes && NE > 0)
+   {
+      const int ref = nodes->FESpace()->GetOrder(0) + 1;
+      for (int g = 0; g < Geometry::NumGeom; g++)
+      {
+         if (Geometry::Dimension[g] == dim)
+         {
+            RefG[g] = GlobGeometryRefiner.Refine(g, ref);
+         }
+      }
+   }
+
+   // The NURBS finite elements are shared by all elements and modified by
+   // FiniteElementSpace::GetFE(), so the loop is serial for NURBS meshes.
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel if (mesh->NURBSext == NULL)
+#endif
+   {
+      IsoparametricTransformation T;
+      DenseMatrix pointmat;
+      Array<int> v;
+#ifdef MFEM_USE_OPENMP
+      #pragma omp for
+#endif
+      for (int e = 0; e < NE; e++)
+      {
+         if (nodes)
+         {
+            mesh->GetElementTransformation(e, &T);
+            T.Transform(RefG[mesh->GetElementBaseGeometry(e)]->RefPts,
+                        pointmat);
+         }
+         else
+         {
+            mesh->GetElementVertices(e, v);
+            pointmat.SetSize(sdim, v.Size());
+            for (int j = 0; j < v.Size(); j++)
+            {
+               const double *x = mesh->GetVertex(v[j]);
+               for (int d = 0; d < sdim; d++) { pointmat(d,j) = x[d]; }
+            }
+         }
+
+         double *box = elem_boxes.GetData() + 2*sdim*e;
+         double size = 0.0;
+         for (int d = 0; d < sdim; d++)
+         {
+            box[d] = box[sdim+d] = pointmat(d,0);
+            for (int j = 1; j < pointmat.Width(); j++)
+            {
+               box[d] = std::min(box[d], pointmat(d,j));
+               box[sdim+d] = std::max(box[sdim+d], pointmat(d,j));
+            }
+            size = std::max(size, box[sdim+d] - box[d]);
+         }
+         for (int d = 0; d < sdim; d++)
+         {
+            box[d] -= pad_frac*size;
+            box[sdim+d] += pad_frac*size;
+         }
+      }
+   }
+}
+
+int PointLocator::GetCell(const double *x) const
+{
+   int idx[3] = { 0, 0, 0 };
+   for (int d = 0; d < sdim; d++)
+   {
+      if (!(x[d] >= bb_min[d] && x[d] <= bb_max[d])) { return -1; }
+      idx[d] = std::min(num_cells[d] - 1,
+                        (int)((x[d] - bb_min[d])*cell_scale[d]));
+   }
+   return idx[0] + num_cells[0]*(idx[1] + num_cells[1]*idx[2]);
+}
+
+bool PointLocator::InElementBox(int e, const double *x) const
+{
+   const double *box = elem_boxes.GetData() + 2*sdim*e;
+   for (int d = 0; d < sdim; d++)
+   {
+      if (x[d] < box[d] || x[d] > box[sdim+d]) { return false; }
+   }
+   return true;
+}
+
+bool PointLocator::InverseMap(IsoparametricTransformation &T, int e,
+                              const double *x, IntegrationPoint &ip) const
+{
+   const int max_iter = 32;
+   const double ref_tol = 1e-14;
+
+   // the tolerances are relative to the size of the element
+   const double *box = elem_boxes.GetData() + 2*sdim*e;
+   double size = 0.0;
+   for (int d = 0; d < sdim; d++)
+   {
+      size = std::max(size, box[sdim+d] - box[d]);
+   }
+   const double phys_tol = 1e-14*size;
+   const double accept_tol = 1e-10*size;
+
+   const int dim = T.GetFE()->GetDim();
+   const int geom = T.GetFE()->GetGeomType();
+   IntegrationPoint xip, prev_xip;
+   double xd[3], yd[3], dxd[3], Jid[9];
+   Vector pt(const_cast<double *>(x), sdim);
+   Vector xr(xd, dim), y(yd, sdim), dx(dxd, dim);
+   DenseMatrix Jinv(Jid, dim, sdim);
+   bool hit_bdr = false;
+
+   // Newton iterations starting from the center of the element; the iterates
+   // leaving the reference element are projected back onto its boundary
+   xip = Geometries.GetCenter(geom);
+   xip.Get(xd, dim);
+   for (int it = 0; it < max_iter; it++)
+   {
+      T.Transform(xip, y);
+      subtract(pt, y, y);
+      if (y.Normlinf() <= phys_tol) { break; }
+      T.SetIntPoint(&xip);
+      CalcInverse(T.Jacobian(), Jinv);
+      Jinv.Mult(y, dx);
+      xr += dx;
+      prev_xip = xip;
+      xip.Set(xd, dim);
+      const bool prev_hit_bdr = hit_bdr;
+      hit_bdr = !Geometry::ProjectPoint(geom, prev_xip, xip);
+      if (hit_bdr)
+      {
+         xip.Get(xd, dim);
+         if (prev_hit_bdr)
+         {
+            // stuck on the boundary: the point is outside the element
+            prev_xip.Get(dxd, dim);
+            subtract(xr, dx, dx);
+            if (dx.Normlinf() < ref_tol) { break; }
+         }
+      }
+      else if (dx.Normlinf() < ref_tol) { break; }
+   }
+
+   T.Transform(xip, y);
+   subtract(pt, y, y);
+   if (y.Normlinf() > accept_tol) { return false; }
+   ip = xip;
+   return true;
+}
+
+int PointLocator::FindPoints(const DenseMatrix &point_mat,
+                             Array<int> &elem_ids,
+                             Array<IntegrationPoint> &ips) const
+{
+   MFEM_VERIFY(point_mat.Height() == sdim,
+               "the points must have " << sdim << " coordinates");
+   const int npts = point_mat.Width();
+   const double *pts = point_mat.Data();
+   elem_ids.SetSize(npts);
+   elem_ids = -1;
+   ips.SetSize(npts);
+
+   // sort the points by cell
+   Array<Pair<int, int> > cell_pts(npts);
+   int n = 0;
+   for (int j = 0; j < npts; j++)
+   {
+      const int c = GetCell(pts + sdim*j);
+      if (c >= 0)
+      {
+         cell_pts[n].one = c;
+         cell_pts[n].two = j;
+         n++;
+      }
+   }
+   SortPairs<int, int>(cell_pts.GetData(), n);
+   Array<int> runs;
+   for (int k = 0; k < n; k++)
+   {
+      if (k == 0 || cell_pts[k].one != cell_pts[k-1].one) { runs.Append(k); }
+   }
+   runs.Append(n);
+
+   // locate the points of each cell, testing them against one candidate
+   // element at a time
+   int found = 0;
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel if (mesh->NURBSext == NULL) reduction(+:found)
+#endif
+   {
+      IsoparametricTransformation T;
+      IntegrationPoint ip;
+#ifdef MFEM_USE_OPENMP
+      #pragma omp for schedule(dynamic)
+#endif
+      for (int r = 0; r < runs.Size() - 1; r++)
+      {
+         const int c = cell_pts[runs[r]].one;
+         int remaining = runs[r+1] - runs[r];
+         for (int k = cell_offsets[c]; k < cell_offsets[c+1] && remaining; k++)
+         {
+            const int e = cell_elements[k];
+            bool setup = false;
+            for (int p = runs[r]; p < runs[r+1]; p++)
+            {
+               const int j = cell_pts[p].two;
+               const double *x = pts + sdim*j;
+               if (elem_ids[j] >= 0 || !InElementBox(e, x)) { continue; }
+               if (!setup)
+               {
+                  mesh->GetElementTransformation(e, &T);
+                  setup = true;
+               }
+               if (InverseMap(T, e, x, ip))
+               {
+                  elem_ids[j] = e;
+                  ips[j] = ip;
+                  remaining--;
+                  found++;
+               }
+            }
+         }
+      }
+   }
+   return found;
+}
+
+}
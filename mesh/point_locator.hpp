@@ -0,0 +1,84 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_POINT_LOCATOR
+#define MFEM_POINT_LOCATOR
+
+#include "../config/config.hpp"
+#include "../general/array.hpp"
+#include "../linalg/densemat.hpp"
+#include "../fem/intrules.hpp"
+
+namespace mfem
+{
+
+class Mesh;
+class IsoparametricTransformation;
+
+/** @brief Spatial index for locating many points in the elements of a Mesh,
+    see Mesh::FindPoints().
+
+    The bounding boxes of the elements are binned in a uniform Cartesian grid
+    of cells covering the mesh, with about one cell per element. For curved
+    meshes, the boxes are computed from the images of a refined set of
+    reference points and are enlarged by a fraction of their size.
+
+    The points are sorted by cell and the points in a cell are located
+    together: each candidate element of the cell is set up once, and its
+    reference coordinates are computed for all points of the cell that lie in
+    its box with Newton iterations restricted to the reference element. When
+    OpenMP is enabled, the cells are processed in parallel. */
+class PointLocator
+{
+protected:
+   Mesh *mesh;
+   long sequence;      ///< Mesh sequence when the index was built
+   int sdim;
+   double bb_min[3], bb_max[3], cell_scale[3];
+   int num_cells[3];
+
+   /// Bounding boxes of the elements, min and max, 2*sdim values per element.
+   Array<double> elem_boxes;
+   /// CSR lists of the elements whose boxes overlap each cell.
+   Array<int> cell_offsets, cell_elements;
+
+   /// Compute the (enlarged) bounding boxes of all elements.
+   void ComputeElementBoxes();
+
+   /// Return the index of the cell containing @a x, or -1 if it is outside.
+   int GetCell(const double *x) const;
+
+   /// Return true if @a x is in the bounding box of element @a e.
+   bool InElementBox(int e, const double *x) const;
+
+   /** @brief Compute the reference coordinates @a ip of the physical point
+       @a x in the element of @a T. Returns true if the point is inside the
+       element, up to a tolerance relative to the size of the element. */
+   bool InverseMap(IsoparametricTransformation &T, int e, const double *x,
+                   IntegrationPoint &ip) const;
+
+public:
+   /// Build the index for the current state of @a mesh.
+   PointLocator(Mesh *mesh);
+
+   /// Return the sequence of the Mesh for which the index was built.
+   long GetSequence() const { return sequence; }
+
+   /** @brief Find the elements containing the points given as the columns of
+       @a point_mat, see Mesh::FindPoints(). Returns the number of points
+       found. */
+   int FindPoints(const DenseMatrix &point_mat, Array<int> &elem_ids,
+                  Array<IntegrationPoint> &ips) const;
+};
+
+}
+
+#endif
@@ -28,6 +28,7 @@
 #include "general/socketstream.hpp"
 #include "general/optparser.hpp"
 #include "general/gzstream.hpp"
+#include "general/binaryio.hpp"
 #ifdef MFEM_USE_MPI
 #include "general/communication.hpp"
 #endif
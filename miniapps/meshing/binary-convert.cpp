@@ -0,0 +1,132 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+//
+//      ---------------------------------------------------------------
+//      Binary Convert Miniapp:  Convert meshes and grid functions to
+//                               and from the binary MFEM formats
+//      ---------------------------------------------------------------
+//
+// This miniapp converts a mesh, and optionally a grid function defined on it,
+// between the ASCII MFEM formats and the binary formats written by
+// Mesh::PrintBinary and GridFunction::SaveBinary. The input can be in any
+// format supported by the Mesh class. Binary inputs can be mapped into memory
+// with the -map option instead of being read through a stream. The times for
+// reading and writing are reported.
+//
+// Compile with: make binary-convert
+//
+// Sample runs:  binary-convert
+//               binary-convert -m ../../data/fichera-q2.mesh -o fichera.bmesh
+//               binary-convert -m fichera.bmesh -map -a -o fichera.mesh
+//               binary-convert -m mesh.bmesh -g sol.bgf -map -a
+//                              -o mesh.mesh -og sol.gf
+
+#include "mfem.hpp"
+#include <fstream>
+#include <iostream>
+
+using namespace std;
+using namespace mfem;
+
+int main(int argc, char *argv[])
+{
+   const char *mesh_file = "../../data/star.mesh";
+   const char *gf_file = "";
+   const char *new_mesh_file = "binary-convert.mesh";
+   const char *new_gf_file = "binary-convert.gf";
+   bool binary = true;
+   bool map_input = false;
+
+   OptionsParser args(argc, argv);
+   args.AddOption(&mesh_file, "-m", "--mesh",
+                  "Input mesh file, in any supported format.");
+   args.AddOption(&gf_file, "-g", "--grid-function",
+                  "Optional input grid function file, defined on the mesh.");
+   args.AddOption(&new_mesh_file, "-o", "--mesh-out-file",
+                  "Output mesh file to write.");
+   args.AddOption(&new_gf_file, "-og", "--grid-function-out-file",
+                  "Output grid function file to write.");
+   args.AddOption(&binary, "-b", "--binary", "-a", "--ascii",
+                  "Write the outputs in the binary or in the ASCII format.");
+   args.AddOption(&map_input, "-map", "--map-input", "-no-map",
+                  "--no-map-input",
+                  "Map the (binary) input files into memory instead of"
+                  " reading them through a stream.");
+   args.Parse();
+   if (!args.Good())
+   {
+      args.PrintUsage(cout);
+      return 1;
+   }
+   args.PrintOptions(cout);
+
+   // 1. Read the mesh and the grid function. The mapped files must outlive
+   //    the objects that use their data.
+   StopWatch timer;
+   timer.Start();
+   MappedFile *mesh_map = NULL, *gf_map = NULL;
+   Mesh *mesh;
+   GridFunction *gf = NULL;
+   if (map_input)
+   {
+      mesh_map = new MappedFile(mesh_file);
+      mesh = new Mesh(*mesh_map, 1, 1);
+   }
+   else
+   {
+      mesh = new Mesh(mesh_file, 1, 1);
+   }
+   if (strlen(gf_file) > 0)
+   {
+      if (map_input)
+      {
+         gf_map = new MappedFile(gf_file);
+         gf = new GridFunction(mesh, *gf_map);
+      }
+      else
+      {
+         ifgzstream gf_ifs(gf_file);
+         MFEM_VERIFY(gf_ifs, "can not open file: " << gf_file);
+         gf = new GridFunction(mesh, gf_ifs);
+      }
+   }
+   timer.Stop();
+   cout << "Read mesh with " << mesh->GetNE() << " elements";
+   if (gf) { cout << " and grid function with " << gf->Size() << " values"; }
+   cout << " in " << timer.RealTime() << " s" << endl;
+
+   // 2. Write the mesh and the grid function in the requested format.
+   timer.Clear();
+   timer.Start();
+   {
+      ofstream mesh_ofs(new_mesh_file, ios::out | ios::binary);
+      mesh_ofs.precision(16);
+      if (binary) { mesh->PrintBinary(mesh_ofs); }
+      else { mesh->Print(mesh_ofs); }
+   }
+   if (gf)
+   {
+      ofstream gf_ofs(new_gf_file, ios::out | ios::binary);
+      gf_ofs.precision(16);
+      if (binary) { gf->SaveBinary(gf_ofs); }
+      else { gf->Save(gf_ofs); }
+   }
+   timer.Stop();
+   cout << "Wrote " << (binary ? "binary" : "ASCII") << " output in "
+        << timer.RealTime() << " s" << endl;
+
+   delete gf;
+   delete mesh;
+   delete gf_map;
+   delete mesh_map;
+
+   return 0;
+}